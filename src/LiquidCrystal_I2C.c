@@ -8,377 +8,653 @@
  *          expander. The implementation includes initialization, text display,
  *          cursor control, backlight management, and specialized functions for
  *          weather data visualization with proper timing and error handling.
+ *          Every panel is an lcd_t handle holding its address, size and
+ *          framebuffers. Text output goes to the shadow framebuffer;
+ *          lcd_flush() compares it with a copy of what is on the glass and
+ *          sends only the cells that changed, one cursor move per contiguous
+ *          run. Bytes are encoded into a static transmit buffer (both nibbles
+ *          with their enable strobes) and sent as one I2C write per command,
+ *          string or framebuffer run. Each LCD is a display priority device
+ *          on the shared I2C bus; writes are queued to the bus arbiter from a
+ *          ring of transmit buffers shared by all panels, so lcd_flush()
+ *          returns before the panel has been updated, and lcd_flush_all()
+ *          queues the changes of several panels back to back. A sensor read
+ *          queued meanwhile goes out between two of these writes. Commands
+ *          wait for the queue to drain, as the controller needs time to
+ *          execute them: with
+ *          LCD_BUSY_POLL the driver then reads the busy flag (R/W on P1 of
+ *          the expander) until the controller is ready, and drops back to the
+ *          fixed datasheet delays for good the first time a read fails or the
+ *          flag never clears, as on backpacks with R/W tied to ground.
  *
  * @author christophermena
  * @date July 30, 2025
  * @version 1.0
- * @note Last Updated: August 3, 2025 at 2:00 PM
+ * @note Last Updated: October 16, 2026
  */
 
 #include "LiquidCrystal_I2C.h"
 #include "esp_err.h"
 #include "esp_log.h"
-#include "driver/i2c.h"
 #include "driver/i2c_master.h"
 #include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
 #include "freertos/task.h"
 #include "esp_rom_sys.h"
 #include <stdio.h>
 #include <string.h>
 
+#include "i2c_bus.h"
+
 // Global variables for LCD state management
 static const char *TAG = "LCD_I2C";                          // Logging tag for ESP-IDF logging system
-static uint8_t lcd_addr = 0x27;                              // Default I2C address of LCD (can be 0x3F on some modules)
-static uint8_t lcd_cols = 16;                                // Number of character columns on display
-static uint8_t lcd_rows = 2;                                 // Number of character rows on display
-static uint8_t lcd_backlight = LCD_BACKLIGHT_ON;             // Current backlight state (on/off)
-static bool i2c_initialized = false;                         // Flag to prevent double initialization of I2C
 
-// Static function prototypes for internal LCD operations
-static esp_err_t i2c_master_init(void);                      // Initialize ESP32 I2C master interface
-static esp_err_t lcd_write_byte(uint8_t data);               // Send single byte over I2C to PCF8574
-static void lcd_write_nibble(uint8_t nibble);                // Send 4-bit data nibble to LCD
-static void lcd_send_command(uint8_t cmd);                   // Send command to LCD (RS=0)
-static void lcd_send_data(uint8_t data);                     // Send character data to LCD (RS=1)
-static void lcd_pulse_enable(uint8_t data);                  // Generate enable pulse for LCD timing
+// Transmit buffers: PCF8574 output states sent in one I2C write each, shared by all panels
+static uint8_t lcd_tx_ring[LCD_TX_BUFFERS][LCD_TX_BUFFER_SIZE];  // Encoded expander states, one buffer per queued write
+static uint8_t *lcd_tx = lcd_tx_ring[0];                     // Buffer being encoded (owned by the driver)
+static size_t lcd_tx_len = 0;                                // Bytes pending in lcd_tx
+static lcd_t *lcd_tx_owner = NULL;                           // Panel the pending bytes are addressed to
+static int lcd_tx_index = 0;                                 // Ring index of lcd_tx
+static SemaphoreHandle_t lcd_tx_free = NULL;                 // Counts buffers not being encoded or transmitted
+static volatile uint32_t lcd_tx_errors = 0;                  // Background writes that failed (NACK, timeout)
 
-// Initialize I2C master interface for LCD communication
-static esp_err_t i2c_master_init(void)
+// Static function prototypes for internal LCD operations
+static esp_err_t lcd_device_init(lcd_t *lcd);                // Attach the LCD to the shared I2C bus
+static void lcd_tx_done(i2c_bus_dev_handle_t dev, esp_err_t result, void *arg);  // Write completion (bus arbiter task)
+static esp_err_t lcd_tx_flush(void);                         // Queue the transmit buffer as one I2C write
+static void lcd_tx_begin(lcd_t *lcd, size_t len);            // Make room for len bytes addressed to a panel
+static void lcd_tx_wait(lcd_t *lcd);                         // Wait until every queued write has been sent
+static void lcd_tx_nibble(lcd_t *lcd, uint8_t nibble);       // Encode a 4-bit nibble with its enable strobe
+static void lcd_tx_byte(lcd_t *lcd, uint8_t value, uint8_t mode);  // Encode a command (mode 0) or data byte (LCD_RS_PIN)
+static esp_err_t lcd_read_busy(lcd_t *lcd);                  // Poll the busy flag until the controller is ready
+static void lcd_wait_ready(lcd_t *lcd, uint32_t delay_us);   // Wait for the last command, polled or timed
+static void lcd_write_nibble(lcd_t *lcd, uint8_t nibble);    // Send 4-bit data nibble to LCD
+static void lcd_send_command(lcd_t *lcd, uint8_t cmd);       // Send command to LCD (RS=0)
+static void lcd_set_address(lcd_t *lcd, uint8_t col, uint8_t row);  // Encode a move of the panel's DDRAM address
+static int lcd_encode_changes(lcd_t *lcd);                   // Encode the framebuffer cells that differ from the panel
+
+// Attach the LCD to the shared I2C bus at display priority, below time-critical sensor reads
+static esp_err_t lcd_device_init(lcd_t *lcd)
 {
-    if (i2c_initialized) 
+    if (lcd->dev != NULL)
     {
         return ESP_OK;  // Skip initialization if already done to prevent conflicts
     }
 
-    // Configure I2C master parameters for LCD communication
-    i2c_config_t conf = 
+    // Make sure a backpack answers, so a missing panel fails here instead of on every write
+    esp_err_t err = i2c_bus_init();
+    if (err == ESP_OK)
     {
-        .mode = I2C_MODE_MASTER,                              // Set ESP32 as I2C master device
-        .sda_io_num = LCD_I2C_SDA_PIN,                        // Serial Data line pin (GPIO 21 default)
-        .scl_io_num = LCD_I2C_SCL_PIN,                        // Serial Clock line pin (GPIO 22 default)
-        .sda_pullup_en = GPIO_PULLUP_ENABLE,                  // Enable internal pull-up on SDA (4.7kΩ typical)
-        .scl_pullup_en = GPIO_PULLUP_ENABLE,                  // Enable internal pull-up on SCL (4.7kΩ typical)
-        .master.clk_speed = LCD_I2C_MASTER_FREQ_HZ,           // Set I2C clock frequency (100kHz standard)
-    };
-
-    esp_err_t err = i2c_param_config(LCD_I2C_MASTER_PORT, &conf);
-    if (err != ESP_OK) 
+        err = i2c_master_probe(i2c_bus_get_handle(), lcd->addr, LCD_I2C_TIMEOUT_MS);
+    }
+    if (err != ESP_OK)
     {
-        ESP_LOGE(TAG, "I2C parameter config failed: %s", esp_err_to_name(err));
+        ESP_LOGE(TAG, "No LCD at address 0x%02X: %s", lcd->addr, esp_err_to_name(err));
         return err;
     }
 
-    // Install I2C driver with configuration (no RX/TX buffers needed for master)
-    err = i2c_driver_install(LCD_I2C_MASTER_PORT, conf.mode, 0, 0, 0);
-    if (err != ESP_OK) 
+    err = i2c_bus_add_device(lcd->addr, LCD_I2C_MASTER_FREQ_HZ, I2C_BUS_PRIORITY_DISPLAY, &lcd->dev);
+    if (err != ESP_OK)
     {
-        ESP_LOGE(TAG, "I2C driver install failed: %s", esp_err_to_name(err));
+        ESP_LOGE(TAG, "I2C device add failed: %s", esp_err_to_name(err));
+        lcd->dev = NULL;
         return err;
     }
 
-    i2c_initialized = true;                                   // Mark I2C as successfully initialized
-    ESP_LOGI(TAG, "I2C master initialized successfully");
+    // All buffers but the one being encoded start out free (created with the first panel)
+    if (lcd_tx_free == NULL)
+    {
+        lcd_tx_free = xSemaphoreCreateCounting(LCD_TX_BUFFERS - 1, LCD_TX_BUFFERS - 1);
+        if (lcd_tx_free == NULL)
+        {
+            i2c_bus_rm_device(lcd->dev);
+            lcd->dev = NULL;
+            return ESP_ERR_NO_MEM;
+        }
+    }
+
+    ESP_LOGI(TAG, "I2C device 0x%02X added successfully", lcd->addr);
     return ESP_OK;
 }
 
-// Write a single byte to the I2C LCD device (PCF8574 I/O expander)
-static esp_err_t lcd_write_byte(uint8_t data)
+// Background write finished (called from the bus arbiter task)
+static void lcd_tx_done(i2c_bus_dev_handle_t dev, esp_err_t result, void *arg)
 {
-    i2c_cmd_handle_t cmd = i2c_cmd_link_create();             // Create I2C command sequence container
-    i2c_master_start(cmd);                                    // Generate I2C start condition
-    i2c_master_write_byte(cmd, (lcd_addr << 1) | I2C_MASTER_WRITE, true);  // Send device address + write bit with ACK check
-    i2c_master_write_byte(cmd, data, true);                   // Send data byte to PCF8574 with ACK check
-    i2c_master_stop(cmd);                                     // Generate I2C stop condition
-    
-    esp_err_t ret = i2c_master_cmd_begin(LCD_I2C_MASTER_PORT, cmd, pdMS_TO_TICKS(100));  // Execute command with 100ms timeout
-    i2c_cmd_link_delete(cmd);                                 // Free command sequence memory
-    
-    return ret;                                               // Return I2C transaction result
+    if (result != ESP_OK)
+    {
+        lcd_tx_errors++;                                      // Reported by lcd_tx_wait from the display task
+        ((lcd_t *)arg)->redraw = true;                        // The glass copy no longer matches the panel
+    }
+    xSemaphoreGive(lcd_tx_free);                              // Its buffer can be encoded again
 }
 
-// Send 4-bit nibble to LCD via I2C (used in 4-bit mode communication)
-static void lcd_write_nibble(uint8_t nibble)
+// Queue the transmit buffer as one I2C write to its panel and move on to the next buffer
+static esp_err_t lcd_tx_flush(void)
 {
-    uint8_t data = nibble | lcd_backlight;                    // Combine nibble with current backlight state
-    lcd_write_byte(data);                                     // Send data to PCF8574 (data + backlight control)
-    lcd_pulse_enable(data);                                   // Generate enable pulse to latch data into LCD
+    if (lcd_tx_len == 0)
+    {
+        return ESP_OK;                                        // Nothing encoded since the last write
+    }
+    if (lcd_tx_owner == NULL || lcd_tx_owner->dev == NULL)
+    {
+        lcd_tx_len = 0;                                       // No panel attached, drop the write
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    // Returns once queued; the buffer must stay untouched until lcd_tx_done
+    esp_err_t ret = i2c_bus_submit(lcd_tx_owner->dev, lcd_tx, lcd_tx_len, NULL, 0, lcd_tx_done, lcd_tx_owner);
+    if (ret != ESP_OK)
+    {
+        lcd_tx_owner->redraw = true;                          // The write is lost, resend the panel next time
+        xSemaphoreGive(lcd_tx_free);                          // Not queued, no completion will come
+    }
+
+    // Wait for a free buffer if every other one is still queued; a queued buffer is never reused,
+    // and every queued write completes (each within the bus timeout), so the wait ends
+    if (xSemaphoreTake(lcd_tx_free, pdMS_TO_TICKS(LCD_I2C_TIMEOUT_MS)) != pdTRUE)
+    {
+        ESP_LOGW(TAG, "I2C write queue stalled");
+        xSemaphoreTake(lcd_tx_free, portMAX_DELAY);
+    }
+    lcd_tx_index = (lcd_tx_index + 1) % LCD_TX_BUFFERS;
+    lcd_tx = lcd_tx_ring[lcd_tx_index];
+    lcd_tx_len = 0;
+
+    return ret;                                               // Return I2C queueing result
 }
 
-// Generate enable pulse for LCD data latching (critical timing requirement)
-static void lcd_pulse_enable(uint8_t data)
+// Make room for len more bytes addressed to a panel, sending bytes of another panel or a full buffer first
+static void lcd_tx_begin(lcd_t *lcd, size_t len)
 {
-    lcd_write_byte(data | LCD_ENABLE_PIN);                    // Set enable pin high (start of pulse)
-    esp_rom_delay_us(LCD_DELAY_ENABLE_PULSE);                 // Hold enable high for required duration (1μs min)
-    lcd_write_byte(data & ~LCD_ENABLE_PIN);                   // Set enable pin low (end of pulse)
-    esp_rom_delay_us(LCD_DELAY_ENABLE_PULSE);                 // Hold enable low for required duration (1μs min)
+    if (lcd_tx_len > 0 && (lcd_tx_owner != lcd || lcd_tx_len + len > LCD_TX_BUFFER_SIZE))
+    {
+        lcd_tx_flush();                                       // One I2C write addresses one panel
+    }
+    lcd_tx_owner = lcd;
 }
 
-// Send command to LCD controller (RS=0 for command mode)
-static void lcd_send_command(uint8_t cmd)
+// Wait until every queued write has been sent (before timed commands)
+static void lcd_tx_wait(lcd_t *lcd)
 {
-    uint8_t upper_nibble = cmd & 0xF0;                        // Extract upper 4 bits (mask with 11110000)
-    uint8_t lower_nibble = (cmd << 4) & 0xF0;                 // Shift lower 4 bits to upper position
-    
-    // Send upper nibble first (HD44780 protocol requirement)
-    lcd_write_nibble(upper_nibble);                           // RS=0 (low) indicates command mode
-    // Send lower nibble second to complete 8-bit command
-    lcd_write_nibble(lower_nibble);                           // RS=0 (low) indicates command mode
-    
-    esp_rom_delay_us(LCD_DELAY_COMMAND);                      // Wait for command execution (50μs typical)
+    static uint32_t reported_errors = 0;
+
+    if (lcd->dev == NULL)
+    {
+        return;                                               // Panel not attached, nothing can be queued
+    }
+    i2c_bus_wait_done(lcd->dev);                              // All panels share a priority, so writes to the others are done too
+    if (lcd_tx_errors != reported_errors)
+    {
+        ESP_LOGW(TAG, "%lu I2C writes failed", (unsigned long)(lcd_tx_errors - reported_errors));
+        reported_errors = lcd_tx_errors;
+    }
 }
 
-// Send character data to LCD controller (RS=1 for data mode)
-static void lcd_send_data(uint8_t data)
+// Encode a 4-bit nibble (upper bits, with RS already set) and its enable strobe
+static void lcd_tx_nibble(lcd_t *lcd, uint8_t nibble)
 {
-    uint8_t upper_nibble = data & 0xF0;                       // Extract upper 4 bits of character data
-    uint8_t lower_nibble = (data << 4) & 0xF0;                // Shift lower 4 bits to upper position
-    
-    // Send upper nibble with RS high to indicate data mode
-    lcd_write_nibble(upper_nibble | LCD_RS_PIN);              // RS=1 (high) indicates data/character mode
-    // Send lower nibble with RS high to complete character transfer
-    lcd_write_nibble(lower_nibble | LCD_RS_PIN);              // RS=1 (high) indicates data/character mode
-    
-    esp_rom_delay_us(LCD_DELAY_COMMAND);                      // Wait for data processing (50μs typical)
+    // The LCD latches on the falling edge of EN; at 100kHz each expander state
+    // lasts one I2C byte (90μs), longer than the 450ns pulse width and the 37μs
+    // a command or character takes to execute, so no delays are needed in between
+    uint8_t data = nibble | lcd->backlight;                   // Combine nibble with current backlight state
+    lcd_tx[lcd_tx_len++] = data | LCD_ENABLE_PIN;             // Set enable pin high (start of pulse)
+    lcd_tx[lcd_tx_len++] = data & ~LCD_ENABLE_PIN;            // Set enable pin low (latches the nibble)
+}
+
+// Encode a full byte, upper nibble first (HD44780 4-bit protocol requirement)
+static void lcd_tx_byte(lcd_t *lcd, uint8_t value, uint8_t mode)
+{
+    lcd_tx_begin(lcd, 5);                                     // Send what is pending first if the buffer is full
+
+    // RS and R/W must settle before EN rises: present them alone first when they change
+    if (lcd_tx_len == 0 || (lcd_tx[lcd_tx_len - 1] & (LCD_RS_PIN | LCD_RW_PIN)) != mode)
+    {
+        lcd_tx[lcd_tx_len++] = (value & 0xF0) | mode | lcd->backlight;
+    }
+    lcd_tx_nibble(lcd, (value & 0xF0) | mode);                // Upper 4 bits
+    lcd_tx_nibble(lcd, ((value << 4) & 0xF0) | mode);         // Lower 4 bits shifted to upper position
+}
+
+// Poll the busy flag until the controller is ready (4-bit mode only)
+static esp_err_t lcd_read_busy(lcd_t *lcd)
+{
+    uint8_t poll[4];                                          // Expander states of one read
+    uint8_t state;                                            // Expander inputs
+    uint8_t read = LCD_READ_BUSY_FLAG_ADDRESS | LCD_RW_PIN | lcd->backlight;  // Data pins high (released) so the LCD can drive them
+    esp_err_t ret = ESP_ERR_TIMEOUT;
+
+    for (int i = 0; i < LCD_BUSY_POLL_MAX && ret == ESP_ERR_TIMEOUT; i++)
+    {
+        size_t len = 0;
+        if (i > 0)
+        {
+            poll[len++] = read;                               // Finish the previous read: strobe the lower nibble
+            poll[len++] = read | LCD_ENABLE_PIN;
+        }
+        poll[len++] = read;                                   // R/W settles before EN rises
+        poll[len++] = read | LCD_ENABLE_PIN;                  // Upper nibble: D7 holds the busy flag while EN is high
+
+        // One transaction, the arbiter returns once the byte has been read
+        esp_err_t err = i2c_bus_transfer(lcd->dev, poll, len, &state, 1);
+        if (err != ESP_OK)
+        {
+            return err;                                       // NACK or timeout, state was not read
+        }
+        if (!(state & LCD_BUSY_FLAG))
+        {
+            ret = ESP_OK;
+        }
+    }
+
+    // Complete the last read with its lower nibble; sent ahead of the next write, which
+    // drops R/W before its first strobe (an even number of strobes keeps nibbles in step)
+    lcd_tx_begin(lcd, 3);
+    lcd_tx[lcd_tx_len++] = read;
+    lcd_tx[lcd_tx_len++] = read | LCD_ENABLE_PIN;
+    lcd_tx[lcd_tx_len++] = read;
+    return ret;
+}
+
+// Wait until the controller has executed the last command: poll its busy flag or wait out delay_us
+static void lcd_wait_ready(lcd_t *lcd, uint32_t delay_us)
+{
+    lcd_tx_wait(lcd);                                         // Execution time counts from the end of the write
+    if (lcd->busy_poll)
+    {
+        esp_err_t ret = lcd_read_busy(lcd);
+        if (ret == ESP_OK)
+        {
+            return;                                           // Ready, typically on the first read
+        }
+        ESP_LOGW(TAG, "LCD 0x%02X: busy flag readback unavailable (%s), using fixed delays", lcd->addr, esp_err_to_name(ret));
+        lcd->busy_poll = false;
+    }
+    esp_rom_delay_us(delay_us);
+}
+
+// Send 4-bit nibble to LCD via I2C (used only by the 8-bit to 4-bit mode switch)
+static void lcd_write_nibble(lcd_t *lcd, uint8_t nibble)
+{
+    lcd_tx_begin(lcd, 3);
+    lcd_tx[lcd_tx_len++] = nibble | lcd->backlight;           // Present the data before the strobe
+    lcd_tx_nibble(lcd, nibble);                               // Generate enable pulse to latch data into LCD
+    lcd_tx_flush();
+    lcd_tx_wait(lcd);                                         // The caller's delay starts once it has been sent
+}
+
+// Send command to LCD controller (RS=0 for command mode)
+static void lcd_send_command(lcd_t *lcd, uint8_t cmd)
+{
+    lcd_tx_byte(lcd, cmd, 0);                                 // RS=0 (low) indicates command mode
+    lcd_tx_flush();                                           // One I2C write for the whole command
+    lcd_wait_ready(lcd, LCD_DELAY_COMMAND);                   // Wait for command execution (37μs typical, 1.52ms for clear/home)
 }
 
 // Initialize LCD display with I2C interface (main initialization function)
-esp_err_t liquid_crystal_i2c_init(uint8_t addr, uint8_t cols, uint8_t rows)
+esp_err_t liquid_crystal_i2c_init(lcd_t *lcd, uint8_t addr, uint8_t cols, uint8_t rows)
 {
     esp_err_t ret;
-    
-    // Store LCD configuration parameters for later use
-    lcd_addr = addr;                                          // Store I2C address (0x27 or 0x3F typically)
-    lcd_cols = cols;                                          // Store number of columns (16 or 20 typically)
-    lcd_rows = rows;                                          // Store number of rows (2 or 4 typically)
-    
-    // Initialize ESP32 I2C master interface
-    ret = i2c_master_init();
-    if (ret != ESP_OK) 
+
+    if (cols > LCD_MAX_COLS || rows > LCD_MAX_ROWS)
+    {
+        ESP_LOGE(TAG, "Unsupported LCD size %dx%d", cols, rows);
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    // Store LCD configuration parameters for later use (a re-init at the same address keeps the device)
+    if (lcd->dev != NULL && lcd->addr != addr)
+    {
+        i2c_bus_rm_device(lcd->dev);
+        lcd->dev = NULL;
+    }
+    if (lcd->dev == NULL)
+    {
+        memset(lcd, 0, sizeof(*lcd));
+    }
+    lcd->addr = addr;                                         // Store I2C address (0x27 or 0x3F typically)
+    lcd->cols = cols;                                         // Store number of columns (16 or 20 typically)
+    lcd->rows = rows;                                         // Store number of rows (2 or 4 typically)
+    lcd->backlight = LCD_BACKLIGHT_ON;
+    lcd->busy_poll = false;                                   // The busy flag cannot be read before 4-bit mode
+    memset(lcd->cgram_glyph, -1, sizeof(lcd->cgram_glyph));   // CGRAM contents are unknown
+    memset(lcd->cgram_frame, 0, sizeof(lcd->cgram_frame));
+    lcd->glyph_frame = 1;                                     // No slot counts as used by the first frame
+
+    // Attach the LCD to the shared I2C master bus
+    ret = lcd_device_init(lcd);
+    if (ret != ESP_OK)
     {
         return ret;                                           // Return error if I2C initialization fails
     }
-    
+
     ESP_LOGI(TAG, "Initializing LCD at address 0x%02X (%dx%d)", addr, cols, rows);
-    
+
     // Critical LCD initialization sequence - timing is essential for reliability
     vTaskDelay(pdMS_TO_TICKS(50));                            // Wait 50ms for LCD power stabilization
-    
+
     // HD44780 power-on initialization sequence (must be exact for 4-bit mode)
-    lcd_write_nibble(0x30);                                   // Function set: 8-bit mode (first attempt)
+    lcd_write_nibble(lcd, 0x30);                              // Function set: 8-bit mode (first attempt)
     vTaskDelay(pdMS_TO_TICKS(5));                             // Wait 5ms (longer delay for first command)
-    lcd_write_nibble(0x30);                                   // Function set: 8-bit mode (second attempt)
+    lcd_write_nibble(lcd, 0x30);                              // Function set: 8-bit mode (second attempt)
     vTaskDelay(pdMS_TO_TICKS(1));                             // Wait 1ms (shorter delay for subsequent commands)
-    lcd_write_nibble(0x30);                                   // Function set: 8-bit mode (third attempt)
+    lcd_write_nibble(lcd, 0x30);                              // Function set: 8-bit mode (third attempt)
     vTaskDelay(pdMS_TO_TICKS(1));                             // Wait 1ms before switching modes
-    lcd_write_nibble(0x20);                                   // Function set: 4-bit mode (critical transition)
+    lcd_write_nibble(lcd, 0x20);                              // Function set: 4-bit mode (critical transition)
     vTaskDelay(pdMS_TO_TICKS(1));                             // Wait for mode switch completion
-    
+    lcd->busy_poll = LCD_BUSY_POLL;                           // The busy flag can be read from here on
+
     // Configure LCD operating parameters using 4-bit commands
-    lcd_send_command(LCD_FUNCTION_SET | LCD_4_BIT_MODE | LCD_2_LINE_MODE | LCD_5x8_DOTS_MODE);  // Set 4-bit, 2-line, 5x8 font
-    lcd_send_command(LCD_DISPLAY_ON_OFF | LCD_DISPLAY_OFF);   // Turn display off during configuration
-    lcd_send_command(LCD_CLEAR_DISPLAY);                      // Clear display memory (all spaces)
-    vTaskDelay(pdMS_TO_TICKS(2));                             // Clear command requires longer execution time
-    lcd_send_command(LCD_ENTRY_MODE | LCD_ENTRY_LEFT | LCD_ENTRY_SHIFT_DECREMENT);  // Set cursor increment, no auto-shift
-    
+    lcd_send_command(lcd, LCD_FUNCTION_SET | LCD_4_BIT_MODE | LCD_2_LINE_MODE | LCD_5x8_DOTS_MODE);  // Set 4-bit, 2-line, 5x8 font
+    lcd_send_command(lcd, LCD_DISPLAY_ON_OFF | LCD_DISPLAY_OFF);  // Turn display off during configuration
+    lcd_clear(lcd);                                           // Clear display memory and both framebuffers
+    lcd_send_command(lcd, LCD_ENTRY_MODE | LCD_ENTRY_LEFT | LCD_ENTRY_SHIFT_DECREMENT);  // Set cursor increment, no auto-shift
+
     // Enable display with desired cursor settings
-    lcd_send_command(LCD_DISPLAY_ON_OFF | LCD_DISPLAY_ON | LCD_CURSOR_OFF | LCD_BLINK_OFF);  // Display on, cursor off, blink off
-    
+    lcd_send_command(lcd, LCD_DISPLAY_ON_OFF | LCD_DISPLAY_ON | LCD_CURSOR_OFF | LCD_BLINK_OFF);  // Display on, cursor off, blink off
+
     // Turn on backlight for visibility
-    backlight();                                              // Enable LCD backlight
-    
-    ESP_LOGI(TAG, "LCD initialization completed successfully");
+    backlight(lcd);                                           // Enable LCD backlight
+
+    ESP_LOGI(TAG, "LCD 0x%02X initialization completed successfully (%s)", addr, lcd->busy_poll ? "busy flag polling" : "fixed delays");
     return ESP_OK;
 }
 
 // Clear entire LCD display and return cursor to home position (0,0)
-void lcd_clear(void)
+void lcd_clear(lcd_t *lcd)
+{
+    lcd_send_command(lcd, LCD_CLEAR_DISPLAY);                 // Send clear command to HD44780 controller
+    if (!lcd->busy_poll)
+    {
+        vTaskDelay(pdMS_TO_TICKS(2));                         // Clear command needs extra execution time (1.52ms typical)
+    }
+    memset(lcd->glass, ' ', sizeof(lcd->glass));              // The panel now shows only spaces
+    lcd_clear_frame(lcd);                                     // Start the next frame from a blank framebuffer
+}
+
+// Blank the framebuffer and home its cursor (no I2C traffic until lcd_flush)
+void lcd_clear_frame(lcd_t *lcd)
+{
+    memset(lcd->frame, ' ', sizeof(lcd->frame));              // Fill every cell with a space
+    lcd->frame_col = 0;
+    lcd->frame_row = 0;
+}
+
+// Encode the framebuffer cells that differ from the panel, one cursor move per run
+static int lcd_encode_changes(lcd_t *lcd)
+{
+    int written = 0;                                          // Number of cells sent to the panel
+    bool redraw = lcd->redraw;                                // After a failed write every cell is resent
+
+    lcd->redraw = false;                                      // A write failing from here on sets it again
+    for (uint8_t row = 0; row < lcd->rows; row++)
+    {
+        uint8_t col = 0;
+        while (col < lcd->cols)
+        {
+            if (!redraw && lcd->frame[row][col] == lcd->glass[row][col])
+            {
+                col++;                                        // Cell already correct on the glass
+                continue;
+            }
+
+            // Start of a run of changed cells: position once, then let the address auto-increment
+            lcd_set_address(lcd, col, row);
+            while (col < lcd->cols && (redraw || lcd->frame[row][col] != lcd->glass[row][col]))
+            {
+                lcd_tx_byte(lcd, (uint8_t)lcd->frame[row][col], LCD_RS_PIN);  // RS=1 (high) indicates data/character mode
+                lcd->glass[row][col] = lcd->frame[row][col];
+                col++;
+                written++;
+            }
+        }
+    }
+    return written;
+}
+
+// Send the framebuffer cells that differ from the panel, one cursor move per run
+int lcd_flush(lcd_t *lcd)
+{
+    return lcd_flush_all(&lcd, 1);
+}
+
+// Send the changes of several panels as one stream of queued writes, without waiting in between
+int lcd_flush_all(lcd_t *const lcds[], size_t count)
+{
+    int written = 0;
+
+    for (size_t i = 0; i < count; i++)
+    {
+        written += lcd_encode_changes(lcds[i]);               // A full buffer or the next panel queues the pending write
+    }
+    lcd_tx_flush();                                           // Runs share I2C writes up to the buffer size, sent in the background
+    return written;
+}
+
+// Report whether commands wait on the busy flag (false: fixed delays)
+bool lcd_get_busy_polling(const lcd_t *lcd)
+{
+    return lcd->busy_poll;
+}
+
+// Report whether a write failed since the last flush, so the panel should be flushed again
+bool lcd_get_redraw_pending(const lcd_t *lcd)
 {
-    lcd_send_command(LCD_CLEAR_DISPLAY);                      // Send clear command to HD44780 controller
-    vTaskDelay(pdMS_TO_TICKS(2));                             // Clear command needs extra execution time (1.52ms typical)
+    return lcd->redraw;
 }
 
 // Return cursor to home position (0,0) without clearing display content
-void lcd_home(void)
+void lcd_home(lcd_t *lcd)
 {
-    lcd_send_command(LCD_RETURN_HOME);                        // Send home command to HD44780 controller
-    vTaskDelay(pdMS_TO_TICKS(2));                             // Home command needs extra execution time (1.52ms typical)
+    lcd_send_command(lcd, LCD_RETURN_HOME);                   // Send home command to HD44780 controller
+    if (!lcd->busy_poll)
+    {
+        vTaskDelay(pdMS_TO_TICKS(2));                         // Home command needs extra execution time (1.52ms typical)
+    }
+    lcd->frame_col = 0;                                       // Framebuffer cursor follows the panel
+    lcd->frame_row = 0;
 }
 
-// Set cursor position for next character output (zero-based coordinates)
-void lcd_set_cursor(uint8_t col, uint8_t row)
+// Encode a move of the panel's DDRAM address to a cell (zero-based coordinates, already in range)
+static void lcd_set_address(lcd_t *lcd, uint8_t col, uint8_t row)
 {
     // DDRAM address offsets for different LCD configurations
-    uint8_t row_offsets[] = {0x00, 0x40, 0x14, 0x54};        // Row 0, 1, 2, 3 start addresses in DDRAM
-    
+    static const uint8_t row_offsets[] = {0x00, 0x40, 0x14, 0x54};  // Row 0, 1, 2, 3 start addresses in DDRAM
+
+    uint8_t address = col + row_offsets[row];                 // Calculate DDRAM address (row offset + column)
+    lcd_tx_byte(lcd, LCD_SET_DDRAM_ADDRESS | address, 0);     // Set DDRAM address command (0x80 | address), sent with the run
+}
+
+// Set framebuffer cursor position for next character output (zero-based coordinates)
+void lcd_set_cursor(lcd_t *lcd, uint8_t col, uint8_t row)
+{
     // Boundary checking to prevent invalid memory access
-    if (row >= lcd_rows) 
+    if (row >= lcd->rows)
     {
-        row = lcd_rows - 1;                                   // Clamp row to maximum valid value
+        row = lcd->rows - 1;                                  // Clamp row to maximum valid value
     }
-    if (col >= lcd_cols) 
+    if (col >= lcd->cols)
     {
-        col = lcd_cols - 1;                                   // Clamp column to maximum valid value
+        col = lcd->cols - 1;                                  // Clamp column to maximum valid value
     }
-    
-    uint8_t address = col + row_offsets[row];                 // Calculate DDRAM address (row offset + column)
-    lcd_send_command(LCD_SET_DDRAM_ADDRESS | address);        // Send set DDRAM address command (0x80 | address)
+
+    lcd->frame_col = col;
+    lcd->frame_row = row;
 }
 
-// Print null-terminated string to LCD at current cursor position
-void lcd_print(const char* str)
+// Print null-terminated string into the framebuffer at current cursor position
+void lcd_print(lcd_t *lcd, const char* str)
 {
     if (str == NULL) return;                                  // Safety check for null pointer
-    
-    while (*str) 
+
+    while (*str)
     {                                            // Loop through each character until null terminator
-        lcd_send_data(*str++);                                // Send character data and increment pointer
+        lcd_print_char(lcd, *str++);                          // Store character and advance cursor
     }
 }
 
-// Print single character to LCD at current cursor position
-void lcd_print_char(char c)
+// Print single character into the framebuffer at current cursor position
+void lcd_print_char(lcd_t *lcd, char c)
 {
-    lcd_send_data(c);                                         // Send character directly as data byte
+    if (lcd->frame_col >= lcd->cols)
+    {
+        return;                                               // Text past the end of the row is clipped
+    }
+    lcd->frame[lcd->frame_row][lcd->frame_col++] = c;         // Store character and advance cursor
+}
+
+// Define a custom character in CGRAM (5x8 pixels, one byte per row, bit 4 leftmost)
+void lcd_create_char(lcd_t *lcd, uint8_t location, const uint8_t charmap[8])
+{
+    location &= LCD_CGRAM_SLOTS - 1;                          // 8 slots of 8 rows each
+    lcd_tx_byte(lcd, LCD_SET_CGRAM_ADDRESS | (location << 3), 0);  // Point the address counter at the slot's first row
+    for (int row = 0; row < 8; row++)
+    {
+        lcd_tx_byte(lcd, charmap[row] & 0x1F, LCD_RS_PIN);    // Row pattern, address auto-increments
+    }
+    lcd_tx_flush();                                           // One I2C write; lcd_flush moves back to DDRAM per run
 }
 
 // Print integer value with automatic string conversion
-void lcd_print_int(int num)
+void lcd_print_int(lcd_t *lcd, int num)
 {
     char buffer[12];                                          // Buffer large enough for 32-bit signed integer
     snprintf(buffer, sizeof(buffer), "%d", num);             // Convert integer to string representation
-    lcd_print(buffer);                                        // Print the converted string
+    lcd_print(lcd, buffer);                                   // Print the converted string
 }
 
 // Print floating-point number with specified decimal places
-void lcd_print_float(float num, uint8_t decimals)
+void lcd_print_float(lcd_t *lcd, float num, uint8_t decimals)
 {
     char buffer[16];                                          // Buffer for floating-point string representation
     char format[8];                                           // Buffer for format string creation
-    
+
     // Create format string dynamically (e.g., "%.2f" for 2 decimal places)
     snprintf(format, sizeof(format), "%%.%df", decimals);    // Build format string with specified decimals
     snprintf(buffer, sizeof(buffer), format, num);           // Convert float using custom format
-    lcd_print(buffer);                                        // Print the formatted string
+    lcd_print(lcd, buffer);                                   // Print the formatted string
 }
 
 // Legacy compatibility function for Arduino-style LCD initialization
-void begin(uint8_t cols, uint8_t rows, uint8_t charsize)
+void begin(lcd_t *lcd, uint8_t cols, uint8_t rows, uint8_t charsize)
 {
-    lcd_cols = cols;                                          // Store column count for boundary checking
-    lcd_rows = rows;                                          // Store row count for boundary checking
+    lcd->cols = cols > LCD_MAX_COLS ? LCD_MAX_COLS : cols;    // Store column count for boundary checking
+    lcd->rows = rows > LCD_MAX_ROWS ? LCD_MAX_ROWS : rows;    // Store row count for boundary checking
     // charsize parameter is ignored - HD44780 uses 5x8 dots standard character format
 }
 
 // Legacy compatibility function - return cursor to home position
-void home(void)
+void home(lcd_t *lcd)
 {
-    lcd_home();                                               // Call the main home function
+    lcd_home(lcd);                                            // Call the main home function
 }
 
 // Turn LCD display output off (preserves display memory content)
-void no_display(void)
+void no_display(lcd_t *lcd)
 {
-    lcd_send_command(LCD_DISPLAY_ON_OFF | LCD_DISPLAY_OFF | LCD_CURSOR_OFF | LCD_BLINK_OFF);  // Display off, cursor off, blink off
+    lcd_send_command(lcd, LCD_DISPLAY_ON_OFF | LCD_DISPLAY_OFF | LCD_CURSOR_OFF | LCD_BLINK_OFF);  // Display off, cursor off, blink off
 }
 
 // Turn LCD display output on (restores display memory content)
-void display(void)
+void display(lcd_t *lcd)
 {
-    lcd_send_command(LCD_DISPLAY_ON_OFF | LCD_DISPLAY_ON | LCD_CURSOR_OFF | LCD_BLINK_OFF);   // Display on, cursor off, blink off
+    lcd_send_command(lcd, LCD_DISPLAY_ON_OFF | LCD_DISPLAY_ON | LCD_CURSOR_OFF | LCD_BLINK_OFF);   // Display on, cursor off, blink off
 }
 
 // Turn cursor blinking effect off (cursor remains solid if enabled)
-void no_blink(void)
+void no_blink(lcd_t *lcd)
 {
-    lcd_send_command(LCD_DISPLAY_ON_OFF | LCD_DISPLAY_ON | LCD_CURSOR_OFF | LCD_BLINK_OFF);   // Display on, cursor off, blink off
+    lcd_send_command(lcd, LCD_DISPLAY_ON_OFF | LCD_DISPLAY_ON | LCD_CURSOR_OFF | LCD_BLINK_OFF);   // Display on, cursor off, blink off
 }
 
 // Turn cursor blinking effect on (cursor blinks at current position)
-void blink(void)
+void blink(lcd_t *lcd)
 {
-    lcd_send_command(LCD_DISPLAY_ON_OFF | LCD_DISPLAY_ON | LCD_CURSOR_ON | LCD_BLINK_ON);     // Display on, cursor on, blink on
+    lcd_send_command(lcd, LCD_DISPLAY_ON_OFF | LCD_DISPLAY_ON | LCD_CURSOR_ON | LCD_BLINK_ON);     // Display on, cursor on, blink on
 }
 
 // Turn cursor visibility off (no cursor indicator shown)
-void no_cursor(void)
+void no_cursor(lcd_t *lcd)
 {
-    lcd_send_command(LCD_DISPLAY_ON_OFF | LCD_DISPLAY_ON | LCD_CURSOR_OFF | LCD_BLINK_OFF);   // Display on, cursor off, blink off
+    lcd_send_command(lcd, LCD_DISPLAY_ON_OFF | LCD_DISPLAY_ON | LCD_CURSOR_OFF | LCD_BLINK_OFF);   // Display on, cursor off, blink off
 }
 
 // Turn cursor visibility on (shows underscore at current position)
-void cursor(void)
+void cursor(lcd_t *lcd)
 {
-    lcd_send_command(LCD_DISPLAY_ON_OFF | LCD_DISPLAY_ON | LCD_CURSOR_ON | LCD_BLINK_OFF);    // Display on, cursor on, blink off
+    lcd_send_command(lcd, LCD_DISPLAY_ON_OFF | LCD_DISPLAY_ON | LCD_CURSOR_ON | LCD_BLINK_OFF);    // Display on, cursor on, blink off
 }
 
 // Scroll entire display content one position to the left
-void scroll_display_left(void)
+void scroll_display_left(lcd_t *lcd)
 {
-    lcd_send_command(LCD_CURSOR_ON_DISPLAY_SHIFT | LCD_DISPLAY_MOVE | LCD_MOVE_LEFT);         // Shift display content left
+    lcd_send_command(lcd, LCD_CURSOR_ON_DISPLAY_SHIFT | LCD_DISPLAY_MOVE | LCD_MOVE_LEFT);         // Shift display content left
 }
 
 // Scroll entire display content one position to the right
-void scroll_display_right(void)
+void scroll_display_right(lcd_t *lcd)
 {
-    lcd_send_command(LCD_CURSOR_ON_DISPLAY_SHIFT | LCD_DISPLAY_MOVE | LCD_MOVE_RIGHT);        // Shift display content right
+    lcd_send_command(lcd, LCD_CURSOR_ON_DISPLAY_SHIFT | LCD_DISPLAY_MOVE | LCD_MOVE_RIGHT);        // Shift display content right
 }
 
 // Set text entry direction from left to right (normal reading order)
-void left_to_right(void)
+void left_to_right(lcd_t *lcd)
 {
-    lcd_send_command(LCD_ENTRY_MODE | LCD_ENTRY_LEFT | LCD_ENTRY_SHIFT_DECREMENT);           // Cursor increments right, no auto-shift
+    lcd_send_command(lcd, LCD_ENTRY_MODE | LCD_ENTRY_LEFT | LCD_ENTRY_SHIFT_DECREMENT);           // Cursor increments right, no auto-shift
 }
 
 // Set text entry direction from right to left (reverse reading order)
-void right_to_left(void)
+void right_to_left(lcd_t *lcd)
 {
-    lcd_send_command(LCD_ENTRY_MODE | LCD_ENTRY_RIGHT | LCD_ENTRY_SHIFT_DECREMENT);          // Cursor increments left, no auto-shift
+    lcd_send_command(lcd, LCD_ENTRY_MODE | LCD_ENTRY_RIGHT | LCD_ENTRY_SHIFT_DECREMENT);          // Cursor increments left, no auto-shift
 }
 
 // Enable automatic scrolling when text reaches display edge
-void autoscroll(void)
+void autoscroll(lcd_t *lcd)
 {
-    lcd_send_command(LCD_ENTRY_MODE | LCD_ENTRY_LEFT | LCD_ENTRY_SHIFT_INCREMENT);           // Cursor moves right, display auto-shifts
+    lcd_send_command(lcd, LCD_ENTRY_MODE | LCD_ENTRY_LEFT | LCD_ENTRY_SHIFT_INCREMENT);           // Cursor moves right, display auto-shifts
 }
 
 // Disable automatic scrolling (text wraps to next line or clips)
-void no_autoscroll(void)
+void no_autoscroll(lcd_t *lcd)
 {
-    lcd_send_command(LCD_ENTRY_MODE | LCD_ENTRY_LEFT | LCD_ENTRY_SHIFT_DECREMENT);           // Cursor moves right, no auto-shift
+    lcd_send_command(lcd, LCD_ENTRY_MODE | LCD_ENTRY_LEFT | LCD_ENTRY_SHIFT_DECREMENT);           // Cursor moves right, no auto-shift
 }
 
 // Turn LCD backlight off for power saving or dimming
-void no_backlight(void)
+void no_backlight(lcd_t *lcd)
 {
-    lcd_backlight = LCD_BACKLIGHT_OFF;                        // Update global backlight state
-    lcd_write_byte(0x00);                                     // Send all zeros to turn off backlight LED
+    lcd->backlight = LCD_BACKLIGHT_OFF;                       // Update the panel's backlight state
+    lcd_tx_begin(lcd, 1);
+    lcd_tx[lcd_tx_len++] = 0x00;                              // All zeros turn off backlight LED
+    lcd_tx_flush();
 }
 
 // Turn LCD backlight on for normal visibility
-void backlight(void)
+void backlight(lcd_t *lcd)
 {
-    lcd_backlight = LCD_BACKLIGHT_ON;                         // Update global backlight state
-    lcd_write_byte(lcd_backlight);                            // Send backlight control bit to PCF8574
+    lcd->backlight = LCD_BACKLIGHT_ON;                        // Update the panel's backlight state
+    lcd_tx_begin(lcd, 1);
+    lcd_tx[lcd_tx_len++] = lcd->backlight;                    // Backlight control bit for the PCF8574
+    lcd_tx_flush();
 }
 
 // Legacy compatibility functions for alternative naming conventions
-void print_left(void) 
-{ 
-    left_to_right(); 
+void print_left(lcd_t *lcd)
+{
+    left_to_right(lcd);
 }                   // Alias for left_to_right() function
 
-void print_right(void) 
-{ 
-    right_to_left(); 
+void print_right(lcd_t *lcd)
+{
+    right_to_left(lcd);
 }                  // Alias for right_to_left() function
 
-void shift_increment(void) 
-{ 
-    autoscroll(); 
+void shift_increment(lcd_t *lcd)
+{
+    autoscroll(lcd);
 }                 // Alias for autoscroll() function
 
-void shift_decrement(void) 
-{ 
-    no_autoscroll(); 
+void shift_decrement(lcd_t *lcd)
+{
+    no_autoscroll(lcd);
 }              // Alias for no_autoscroll() function
-
@@ -7,22 +7,33 @@
  *          command definitions, and configuration constants for HD44780-compatible
  *          LCD displays connected via I2C interface using PCF8574 I/O expander.
  *          Supports 16x2 and 20x4 LCD configurations with backlight control.
+ *          Each panel is an lcd_t handle with its own address, size and
+ *          framebuffer, so several panels can share the I2C bus. The print
+ *          functions draw into the framebuffer; call lcd_flush() (or
+ *          lcd_flush_all() for several panels) to send the changed cells in
+ *          as few I2C writes as possible.
+ *          Commands wait for the controller by reading its busy flag when the
+ *          backpack wires R/W to the expander, or for their datasheet time if not.
  *
  * @author christophermena
  * @date July 30, 2025
  * @version 1.0
- * @note Last Updated: August 3, 2025 at 2:00 PM
+ * @note Last Updated: October 16, 2026
  */
 
 #ifndef LIQUID_CRYTAL_I2C_H_
 #define LIQUID_CRYTAL_I2C_H_
 
+#include <stdbool.h>
+#include <stddef.h>
 #include <stdint.h>
+#include "driver/i2c_master.h"
 #include "esp_err.h"
+#include "i2c_bus.h"
 
-// SDA and SCL pin definitions
-#define LCD_I2C_SDA_PIN 27  // Default SDA pin for I2C
-#define LCD_I2C_SCL_PIN 26  // Default SCL pin for I2
+// SDA and SCL pin definitions (the LCD sits on the shared I2C bus)
+#define LCD_I2C_SDA_PIN I2C_BUS_SDA_PIN  // Default SDA pin for I2C
+#define LCD_I2C_SCL_PIN I2C_BUS_SCL_PIN  // Default SCL pin for I2C
 
 // LCD Instructions
 #define LCD_CLEAR_DISPLAY 0x01
@@ -90,6 +101,7 @@
 
 // I2C PCF8574 Pin Mapping for LCD
 #define LCD_RS_PIN    0x01    // Register Select pin
+#define LCD_RW_PIN    0x02    // Read/Write pin (high to read the busy flag)
 #define LCD_ENABLE_PIN 0x04   // Enable pin  
 #define LCD_D4_PIN    0x10    // Data pin 4
 #define LCD_D5_PIN    0x20    // Data pin 5
@@ -98,42 +110,89 @@
 
 // Default I2C Configuration
 #define LCD_I2C_ADDRESS         0x27    // Default I2C address for PCF8574
-#define LCD_I2C_MASTER_PORT     I2C_NUM_0
+#define LCD_I2C_MASTER_PORT     I2C_BUS_PORT
 #define LCD_I2C_MASTER_FREQ_HZ  100000  // 100kHz I2C frequency
+#define LCD_I2C_TIMEOUT_MS      100     // Timeout of one I2C write
 
 // LCD Timing Constants
 #define LCD_DELAY_ENABLE_PULSE  1       // Enable pulse width in microseconds
 #define LCD_DELAY_COMMAND       2000    // Command execution delay in microseconds
 #define LCD_DELAY_INIT          50000   // Initialization delay in microseconds
 
+// Busy Flag Polling (commands wait for the controller instead of LCD_DELAY_COMMAND)
+#define LCD_BUSY_POLL           1       // 1 to poll the busy flag, falls back to fixed delays if readback fails
+#define LCD_BUSY_POLL_MAX       8       // Busy flag reads before giving up (about 0.5ms each at 100kHz)
+
+// Framebuffer Size (largest supported panel)
+#define LCD_MAX_COLS            20
+#define LCD_MAX_ROWS            4
+
+// Transmit Buffer Size (one cursor move plus a full row of characters)
+#define LCD_TX_BUFFER_SIZE      (6 + 4 * LCD_MAX_COLS)
+#define LCD_TX_BUFFERS          4       // Transmit buffers shared by all panels (up to 3 writes queued while the next is encoded)
+
+// Custom Characters (CGRAM slot n prints as character n or LCD_CGRAM_CHAR_BASE + n)
+#define LCD_CGRAM_SLOTS         8
+#define LCD_CGRAM_CHAR_BASE     0x08    // Second mapping of the slots, keeps NUL out of strings
+
+/**
+ * @brief LCD panel handle
+ *
+ * Allocated zero-initialized by the caller (usually static) and set up by
+ * liquid_crystal_i2c_init(). All panels must be driven from the same task.
+ */
+typedef struct lcd
+{
+    uint8_t addr;                                   ///< I2C address of the PCF8574 backpack
+    uint8_t cols;                                   ///< Number of character columns
+    uint8_t rows;                                   ///< Number of character rows
+    uint8_t backlight;                              ///< LCD_BACKLIGHT_ON or LCD_BACKLIGHT_OFF
+    bool busy_poll;                                 ///< Commands poll the busy flag (cleared when readback fails)
+    i2c_bus_dev_handle_t dev;                       ///< Device on the shared I2C bus, NULL until initialized
+    char frame[LCD_MAX_ROWS][LCD_MAX_COLS];         ///< Characters the application wants shown
+    char glass[LCD_MAX_ROWS][LCD_MAX_COLS];         ///< Characters currently on the panel
+    volatile bool redraw;                           ///< A write failed, the next flush resends every cell (set by the bus arbiter task)
+    uint8_t frame_col;                              ///< Framebuffer cursor column
+    uint8_t frame_row;                              ///< Framebuffer cursor row
+    int8_t cgram_glyph[LCD_CGRAM_SLOTS];            ///< Glyph in each CGRAM slot, -1 if empty (kept by lcd_glyph.c)
+    uint32_t cgram_frame[LCD_CGRAM_SLOTS];          ///< Frame that last used each slot (kept by lcd_glyph.c)
+    uint32_t glyph_frame;                           ///< Frame being drawn (kept by lcd_glyph.c)
+} lcd_t;
+
 // Function prototypes
-esp_err_t liquid_crystal_i2c_init(uint8_t addr, uint8_t cols, uint8_t rows);
-void lcd_clear(void);
-void lcd_home(void);
-void lcd_set_cursor(uint8_t col, uint8_t row);
-void lcd_print(const char* str);
-void lcd_print_char(char c);
-void lcd_print_int(int num);
-void lcd_print_float(float num, uint8_t decimals);
-void begin(uint8_t cols, uint8_t rows, uint8_t charsize);
-void home(void);
-void no_display(void);
-void display(void);
-void no_blink(void);
-void blink(void);
-void no_cursor(void);
-void cursor(void);
-void scroll_display_left(void);
-void scroll_display_right(void);
-void print_left(void);
-void print_right(void);
-void left_to_right(void);
-void right_to_left(void);
-void shift_increment(void);
-void shift_decrement(void);
-void no_backlight(void);
-void backlight(void);
-void autoscroll(void);
-void no_autoscroll(void);
+esp_err_t liquid_crystal_i2c_init(lcd_t *lcd, uint8_t addr, uint8_t cols, uint8_t rows);
+void lcd_clear(lcd_t *lcd);
+void lcd_clear_frame(lcd_t *lcd);
+int lcd_flush(lcd_t *lcd);
+int lcd_flush_all(lcd_t *const lcds[], size_t count);
+bool lcd_get_busy_polling(const lcd_t *lcd);
+bool lcd_get_redraw_pending(const lcd_t *lcd);
+void lcd_home(lcd_t *lcd);
+void lcd_set_cursor(lcd_t *lcd, uint8_t col, uint8_t row);
+void lcd_print(lcd_t *lcd, const char* str);
+void lcd_print_char(lcd_t *lcd, char c);
+void lcd_print_int(lcd_t *lcd, int num);
+void lcd_print_float(lcd_t *lcd, float num, uint8_t decimals);
+void lcd_create_char(lcd_t *lcd, uint8_t location, const uint8_t charmap[8]);
+void begin(lcd_t *lcd, uint8_t cols, uint8_t rows, uint8_t charsize);
+void home(lcd_t *lcd);
+void no_display(lcd_t *lcd);
+void display(lcd_t *lcd);
+void no_blink(lcd_t *lcd);
+void blink(lcd_t *lcd);
+void no_cursor(lcd_t *lcd);
+void cursor(lcd_t *lcd);
+void scroll_display_left(lcd_t *lcd);
+void scroll_display_right(lcd_t *lcd);
+void print_left(lcd_t *lcd);
+void print_right(lcd_t *lcd);
+void left_to_right(lcd_t *lcd);
+void right_to_left(lcd_t *lcd);
+void shift_increment(lcd_t *lcd);
+void shift_decrement(lcd_t *lcd);
+void no_backlight(lcd_t *lcd);
+void backlight(lcd_t *lcd);
+void autoscroll(lcd_t *lcd);
+void no_autoscroll(lcd_t *lcd);
 
 #endif /* END LIQUID_CRYTAL_I2C_H_*/
\ No newline at end of file
@@ -0,0 +1,69 @@
+/**
+ * @file app_settings.c
+ * @brief Runtime Settings Implementation for ESP32 Weather Station
+ * @details This file implements loading and saving the user settings in NVS.
+ *
+ * @author christophermena
+ * @date July 30, 2025
+ * @version 1.0
+ * @note Last Updated: October 16, 2026
+ */
+
+#include "esp_log.h"
+#include "nvs.h"
+
+#include "app_settings.h"
+
+// Tag used for ESP serial console messages
+static const char TAG[] = "app_settings";
+
+// Cached settings
+static volatile bool g_fahrenheit = APP_SETTINGS_DEFAULT_FAHRENHEIT;
+
+void app_settings_init(void)
+{
+    nvs_handle_t handle;
+    uint8_t value;
+
+    if (nvs_open(APP_SETTINGS_NVS_NAMESPACE, NVS_READONLY, &handle) != ESP_OK)
+    {
+        // Nothing saved yet
+        return;
+    }
+    if (nvs_get_u8(handle, APP_SETTINGS_KEY_FAHRENHEIT, &value) == ESP_OK)
+    {
+        g_fahrenheit = (value != 0);
+    }
+    nvs_close(handle);
+
+    ESP_LOGI(TAG, "app_settings_init: temperature unit %s", g_fahrenheit ? "F" : "C");
+}
+
+bool app_settings_get_fahrenheit(void)
+{
+    return g_fahrenheit;
+}
+
+esp_err_t app_settings_set_fahrenheit(bool fahrenheit)
+{
+    nvs_handle_t handle;
+
+    esp_err_t err = nvs_open(APP_SETTINGS_NVS_NAMESPACE, NVS_READWRITE, &handle);
+    if (err != ESP_OK)
+    {
+        return err;
+    }
+    err = nvs_set_u8(handle, APP_SETTINGS_KEY_FAHRENHEIT, fahrenheit ? 1 : 0);
+    if (err == ESP_OK)
+    {
+        err = nvs_commit(handle);
+    }
+    nvs_close(handle);
+
+    if (err == ESP_OK)
+    {
+        g_fahrenheit = fahrenheit;
+        ESP_LOGI(TAG, "app_settings_set_fahrenheit: temperature unit %s", fahrenheit ? "F" : "C");
+    }
+    return err;
+}
@@ -0,0 +1,47 @@
+/**
+ * @file app_settings.h
+ * @brief Runtime Settings Header for ESP32 Weather Station
+ * @details This header file defines the user settings that can be changed
+ *          from the web interface without rebuilding the firmware. Settings
+ *          are kept in NVS and cached in RAM, so readers can query them on
+ *          every sample without touching flash.
+ *
+ * @author christophermena
+ * @date July 30, 2025
+ * @version 1.0
+ * @note Last Updated: October 16, 2026
+ */
+
+#ifndef MAIN_APP_SETTINGS_H_
+#define MAIN_APP_SETTINGS_H_
+
+#include <stdbool.h>
+#include "esp_err.h"
+
+// NVS storage of the settings
+#define APP_SETTINGS_NVS_NAMESPACE      "settings"
+#define APP_SETTINGS_KEY_FAHRENHEIT     "temp_f"
+
+// Defaults used until a setting is saved
+#define APP_SETTINGS_DEFAULT_FAHRENHEIT true
+
+/**
+ * @brief Load the settings from NVS
+ * @note Call once after nvs_flash_init()
+ */
+void app_settings_init(void);
+
+/**
+ * @brief Get the display temperature unit
+ * @return true for Fahrenheit, false for Celsius
+ */
+bool app_settings_get_fahrenheit(void);
+
+/**
+ * @brief Set and persist the display temperature unit
+ * @param fahrenheit true for Fahrenheit, false for Celsius
+ * @return ESP_OK on success, otherwise the NVS error
+ */
+esp_err_t app_settings_set_fahrenheit(bool fahrenheit);
+
+#endif /* MAIN_APP_SETTINGS_H_ */
@@ -0,0 +1,699 @@
+/**
+ * @file display_app.c
+ * @brief LCD Display Service Implementation for ESP32 Weather Station
+ * @details This file implements the display service. Render requests write
+ *          the latest state (sample, error, page, text) under a spinlock and
+ *          notify the display task; the task copies the state, draws the
+ *          visible page into each panel's framebuffer (the 20x4 front panel
+ *          adds the next page below it) and flushes the panels that changed
+ *          with one lcd_flush_all(), then rests
+ *          for DISPLAY_APP_FRAME_INTERVAL_MS. Every request posted during a
+ *          render or the rest is folded into the state and drawn once in the
+ *          next frame: a burst costs one frame, and no request can fill a
+ *          queue and block its sender. Only this task calls the LCD driver.
+ *          Degree sign, trend arrow and sparkline bars are custom glyphs from
+ *          lcd_glyph.c, uploaded to CGRAM only when a frame first needs them.
+ *
+ *          Pages are entries of display_app_pages: an inputs function folds
+ *          everything the page shows into a signature, and a render function
+ *          draws it into two rows of a panel. The task only evaluates the
+ *          visible pages, once per request or DISPLAY_APP_POLL_MS, and draws
+ *          a panel when its signature differs from the one it shows; hidden
+ *          pages cost nothing.
+ *          Adding a page takes the two functions, a table entry and an enum
+ *          value.
+ *
+ * @author christophermena
+ * @date July 30, 2025
+ * @version 1.0
+ * @note Last Updated: October 16, 2026
+ */
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include "esp_log.h"
+#include "esp_netif.h"
+#include "esp_timer.h"
+#include "esp_wifi.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+#include "DHT11.h"
+#include "LiquidCrystal_I2C.h"
+#include "app_settings.h"
+#include "display_app.h"
+#include "lcd_glyph.h"
+#include "sensor_data.h"
+#include "tasks_common.h"
+#include "time_sync.h"
+#include "wifi_app.h"
+
+// Tag used for ESP serial console messages
+static const char TAG[] = "display_app";
+
+// Signature of a view that has not been drawn
+#define DISPLAY_APP_SIGNATURE_NONE      0
+
+// Day of the daily range while the clock is not set: the range since boot
+#define DISPLAY_APP_DAY_BOOT            -1
+
+/**
+ * @brief What the panel should show, written by the requests
+ */
+typedef struct display_app_state
+{
+    display_app_page_e page;        ///< Visible page
+    bool page_requested;            ///< display_app_show_page() since the last frame (restarts the rotation)
+    bool rotate;                    ///< Rotate the pages on a timer
+    bool text_active;               ///< Show text instead of the page
+    char text[2][LCD_MAX_COLS + 1]; ///< Lines of display_app_show_text()
+    bool sample_valid;              ///< A reading has been posted
+    bool sensor_error;              ///< The last sensor read failed
+    int64_t error_us;               ///< esp_timer time of the last sensor error
+    int temperature;                ///< Latest temperature in degrees Celsius
+    int humidity;                   ///< Latest relative humidity in percent
+    int trend[DISPLAY_APP_TREND_LENGTH];    ///< Recent temperatures in degrees Celsius, oldest first
+    int trend_count;                ///< Valid entries at the end of trend
+    int day;                        ///< Local day of the daily range (year * 366 + day of year), or DISPLAY_APP_DAY_BOOT
+    int day_temperature[2];         ///< Lowest and highest temperature of the day
+    int day_humidity[2];            ///< Lowest and highest humidity of the day
+} display_app_state_t;
+
+/**
+ * @brief Page of the rotation
+ */
+typedef struct display_app_page_def
+{
+    uint32_t (*inputs)(const display_app_state_t *state);   ///< Signature of what the page shows
+    void (*render)(lcd_t *lcd, uint8_t row, const display_app_state_t *state);  ///< Draws the page into two rows of a framebuffer
+} display_app_page_def_t;
+
+/**
+ * @brief Panel driven by the service
+ */
+typedef struct display_app_panel
+{
+    lcd_t lcd;                      ///< Driver handle
+    uint8_t address;                ///< I2C address of the backpack
+    uint8_t cols;                   ///< Columns
+    uint8_t rows;                   ///< Rows, two per page shown
+    bool ok;                        ///< Initialized; false if the panel did not answer
+    uint32_t shown;                 ///< Signature of what the panel shows
+} display_app_panel_t;
+
+// Panels, only touched by the display task
+static display_app_panel_t display_app_panels[] =
+{
+    { .address = DISPLAY_APP_FRONT_ADDRESS, .cols = DISPLAY_APP_FRONT_COLS, .rows = DISPLAY_APP_FRONT_ROWS },
+    { .address = DISPLAY_APP_BACK_ADDRESS, .cols = DISPLAY_APP_BACK_COLS, .rows = DISPLAY_APP_BACK_ROWS },
+};
+#define DISPLAY_APP_PANELS      (sizeof(display_app_panels) / sizeof(display_app_panels[0]))
+
+// Requested state, shared with the producers
+static display_app_state_t display_app_state = { .page = DISPLAY_APP_PAGE_CURRENT, .rotate = true };
+static portMUX_TYPE display_app_lock = portMUX_INITIALIZER_UNLOCKED;
+
+// Display task, NULL until display_app_start()
+static TaskHandle_t task_display_app = NULL;
+
+/**
+ * @brief Wakes the display task after a request (never blocks).
+ */
+static void display_app_notify(void)
+{
+    if (task_display_app != NULL)
+    {
+        xTaskNotifyGive(task_display_app);
+    }
+}
+
+/**
+ * @brief Folds a value into a signature (FNV-1a).
+ * @param hash signature so far.
+ * @param value value to add.
+ * @return new signature.
+ */
+static uint32_t display_app_hash(uint32_t hash, uint32_t value)
+{
+    for (int i = 0; i < 4; i++)
+    {
+        hash = (hash ^ ((value >> (8 * i)) & 0xFF)) * 16777619u;
+    }
+    return hash;
+}
+
+/**
+ * @brief Converts a temperature to the configured unit.
+ * @param celsius temperature in degrees Celsius.
+ * @param fahrenheit true to convert to Fahrenheit.
+ * @return temperature in the configured unit.
+ */
+static int display_app_temperature(int celsius, bool fahrenheit)
+{
+    return fahrenheit ? (int)dht11_celsius_to_fahrenheit(celsius) : celsius;
+}
+
+/**
+ * @brief Gets the direction of the temperature trend.
+ * @param state state holding the recent readings.
+ * @return 1 rising, -1 falling, 0 steady, 2 while too few readings are known.
+ */
+static int display_app_trend_direction(const display_app_state_t *state)
+{
+    if (state->trend_count <= DISPLAY_APP_TREND_SPAN)
+    {
+        return 2;
+    }
+
+    int latest = state->trend[DISPLAY_APP_TREND_LENGTH - 1];
+    int earlier = state->trend[DISPLAY_APP_TREND_LENGTH - 1 - DISPLAY_APP_TREND_SPAN];
+    return (latest > earlier) - (latest < earlier);
+}
+
+/**
+ * @brief Gets the arrow glyph of the temperature trend.
+ * @param lcd panel being drawn.
+ * @param state state holding the recent readings.
+ * @return arrow character, or a space while too few readings are known.
+ */
+static char display_app_trend_arrow(lcd_t *lcd, const display_app_state_t *state)
+{
+    switch (display_app_trend_direction(state))
+    {
+    case 1:
+        return lcd_glyph_get(lcd, LCD_GLYPH_TREND_UP);
+    case -1:
+        return lcd_glyph_get(lcd, LCD_GLYPH_TREND_DOWN);
+    case 0:
+        return lcd_glyph_get(lcd, LCD_GLYPH_TREND_FLAT);
+    default:
+        return ' ';
+    }
+}
+
+/**
+ * @brief Prints "low-high" followed by a unit.
+ * @param lcd panel being drawn.
+ * @param low lowest value.
+ * @param high highest value.
+ * @param unit unit text.
+ */
+static void display_app_print_range(lcd_t *lcd, int low, int high, const char *unit)
+{
+    lcd_print_int(lcd, low);
+    lcd_print(lcd, "-");
+    lcd_print_int(lcd, high);
+    lcd_print(lcd, unit);
+}
+
+/**
+ * @brief Draws the "no reading yet" text.
+ * @param lcd panel being drawn.
+ * @param row first of the two rows.
+ */
+static void display_app_render_waiting(lcd_t *lcd, uint8_t row)
+{
+    lcd_set_cursor(lcd, 0, row);
+    lcd_print(lcd, "Waiting for");
+    lcd_set_cursor(lcd, 0, row + 1);
+    lcd_print(lcd, "first reading");
+}
+
+// Current conditions page
+
+static uint32_t display_app_current_inputs(const display_app_state_t *state)
+{
+    uint32_t hash = display_app_hash(2166136261u, state->sensor_error);
+    hash = display_app_hash(hash, state->sample_valid);
+    hash = display_app_hash(hash, (uint32_t)state->temperature);
+    hash = display_app_hash(hash, (uint32_t)state->humidity);
+    hash = display_app_hash(hash, (uint32_t)display_app_trend_direction(state));
+    return display_app_hash(hash, app_settings_get_fahrenheit());
+}
+
+static void display_app_current_render(lcd_t *lcd, uint8_t row, const display_app_state_t *state)
+{
+    if (state->sensor_error)
+    {
+        lcd_set_cursor(lcd, 0, row);
+        lcd_print(lcd, "Sensor Error!");
+        lcd_set_cursor(lcd, 0, row + 1);
+        lcd_print(lcd, "Check DHT11");
+        return;
+    }
+    if (!state->sample_valid)
+    {
+        display_app_render_waiting(lcd, row);
+        return;
+    }
+
+    bool fahrenheit = app_settings_get_fahrenheit();
+
+    lcd_set_cursor(lcd, 0, row);
+    lcd_print(lcd, "Temp: ");
+    lcd_print_int(lcd, display_app_temperature(state->temperature, fahrenheit));
+    lcd_print_char(lcd, lcd_glyph_get(lcd, LCD_GLYPH_DEGREE));
+    lcd_print(lcd, fahrenheit ? "F " : "C ");
+    lcd_print_char(lcd, display_app_trend_arrow(lcd, state));
+    lcd_set_cursor(lcd, 0, row + 1);
+    lcd_print(lcd, "Humidity: ");
+    lcd_print_int(lcd, state->humidity);
+    lcd_print(lcd, "%");
+}
+
+// Trend page: range and arrow, then one sparkline bar per reading
+
+static uint32_t display_app_trend_inputs(const display_app_state_t *state)
+{
+    uint32_t hash = display_app_hash(2166136261u, (uint32_t)state->trend_count);
+    for (int i = DISPLAY_APP_TREND_LENGTH - state->trend_count; i < DISPLAY_APP_TREND_LENGTH; i++)
+    {
+        hash = display_app_hash(hash, (uint32_t)state->trend[i]);
+    }
+    return display_app_hash(hash, app_settings_get_fahrenheit());
+}
+
+static void display_app_trend_render(lcd_t *lcd, uint8_t row, const display_app_state_t *state)
+{
+    if (state->trend_count == 0)
+    {
+        display_app_render_waiting(lcd, row);
+        return;
+    }
+
+    const int *trend = &state->trend[DISPLAY_APP_TREND_LENGTH - state->trend_count];
+    int low = trend[0];
+    int high = trend[0];
+    for (int i = 1; i < state->trend_count; i++)
+    {
+        low = trend[i] < low ? trend[i] : low;
+        high = trend[i] > high ? trend[i] : high;
+    }
+
+    bool fahrenheit = app_settings_get_fahrenheit();
+    lcd_set_cursor(lcd, 0, row);
+    lcd_print(lcd, "Trend ");
+    display_app_print_range(lcd, display_app_temperature(low, fahrenheit), display_app_temperature(high, fahrenheit), fahrenheit ? "F " : "C ");
+    lcd_print_char(lcd, display_app_trend_arrow(lcd, state));
+
+    // Oldest reading on the left, scaled to the range; a steady temperature is drawn at half height
+    lcd_set_cursor(lcd, lcd->cols - state->trend_count, row + 1);
+    for (int i = 0; i < state->trend_count; i++)
+    {
+        int level = high == low ? LCD_GLYPH_BAR_LEVELS / 2 : 1 + (trend[i] - low) * (LCD_GLYPH_BAR_LEVELS - 1) / (high - low);
+        lcd_print_char(lcd, lcd_glyph_bar(lcd, level));
+    }
+}
+
+// Daily range page: today's range, or the range since boot ("Boot") while the clock is not set
+
+static uint32_t display_app_daily_inputs(const display_app_state_t *state)
+{
+    uint32_t hash = display_app_hash(2166136261u, state->sample_valid);
+    hash = display_app_hash(hash, state->day == DISPLAY_APP_DAY_BOOT);
+    hash = display_app_hash(hash, (uint32_t)state->day_temperature[0]);
+    hash = display_app_hash(hash, (uint32_t)state->day_temperature[1]);
+    hash = display_app_hash(hash, (uint32_t)state->day_humidity[0]);
+    hash = display_app_hash(hash, (uint32_t)state->day_humidity[1]);
+    return display_app_hash(hash, app_settings_get_fahrenheit());
+}
+
+static void display_app_daily_render(lcd_t *lcd, uint8_t row, const display_app_state_t *state)
+{
+    if (!state->sample_valid)
+    {
+        display_app_render_waiting(lcd, row);
+        return;
+    }
+
+    bool fahrenheit = app_settings_get_fahrenheit();
+    lcd_set_cursor(lcd, 0, row);
+    lcd_print(lcd, state->day == DISPLAY_APP_DAY_BOOT ? "Boot  " : "Today ");
+    display_app_print_range(lcd, display_app_temperature(state->day_temperature[0], fahrenheit),
+                            display_app_temperature(state->day_temperature[1], fahrenheit), "");
+    lcd_print_char(lcd, lcd_glyph_get(lcd, LCD_GLYPH_DEGREE));
+    lcd_print(lcd, fahrenheit ? "F" : "C");
+    lcd_set_cursor(lcd, 0, row + 1);
+    lcd_print(lcd, "Hum   ");
+    display_app_print_range(lcd, state->day_humidity[0], state->day_humidity[1], "%");
+}
+
+// WiFi page: station address and signal, or the access point while not connected
+
+/**
+ * @brief Reads the station connection.
+ * @param ip receives the station IPv4 address, 0 if not connected.
+ * @return signal strength in bars (1 to 4), 0 if not connected.
+ */
+static int display_app_wifi_status(esp_netif_ip_info_t *ip)
+{
+    wifi_ap_record_t ap;
+
+    memset(ip, 0, sizeof(*ip));
+    if (esp_netif_sta == NULL || esp_netif_get_ip_info(esp_netif_sta, ip) != ESP_OK || ip->ip.addr == 0
+        || esp_wifi_sta_get_ap_info(&ap) != ESP_OK)
+    {
+        ip->ip.addr = 0;
+        return 0;
+    }
+    return ap.rssi >= -55 ? 4 : ap.rssi >= -65 ? 3 : ap.rssi >= -75 ? 2 : 1;
+}
+
+static uint32_t display_app_wifi_inputs(const display_app_state_t *state)
+{
+    esp_netif_ip_info_t ip;
+    wifi_sta_list_t stations;
+
+    uint32_t hash = display_app_hash(2166136261u, (uint32_t)display_app_wifi_status(&ip));
+    hash = display_app_hash(hash, ip.ip.addr);
+    if (ip.ip.addr == 0 && esp_wifi_ap_get_sta_list(&stations) == ESP_OK)
+    {
+        hash = display_app_hash(hash, (uint32_t)stations.num);
+    }
+    return hash;
+}
+
+static void display_app_wifi_render(lcd_t *lcd, uint8_t row, const display_app_state_t *state)
+{
+    esp_netif_ip_info_t ip;
+    wifi_sta_list_t stations;
+    char line[LCD_MAX_COLS + 1];
+
+    int bars = display_app_wifi_status(&ip);
+    lcd_set_cursor(lcd, 0, row);
+    if (bars > 0)
+    {
+        lcd_print(lcd, "WiFi ");
+        lcd_print_char(lcd, lcd_glyph_get(lcd, LCD_GLYPH_WIFI_0 + bars));
+        lcd_set_cursor(lcd, 0, row + 1);
+        snprintf(line, sizeof(line), IPSTR, IP2STR(&ip.ip));
+        lcd_print(lcd, line);
+        return;
+    }
+
+    lcd_print(lcd, "WiFi ");
+    lcd_print_char(lcd, lcd_glyph_get(lcd, LCD_GLYPH_WIFI_0));
+    lcd_print(lcd, " AP ");
+    if (esp_wifi_ap_get_sta_list(&stations) == ESP_OK)
+    {
+        lcd_print_int(lcd, stations.num);
+        lcd_print(lcd, " conn");
+    }
+    lcd_set_cursor(lcd, 0, row + 1);
+    lcd_print(lcd, WIFI_AP_IP);
+}
+
+// Uptime page, redrawn once a minute
+
+static uint32_t display_app_uptime_inputs(const display_app_state_t *state)
+{
+    return display_app_hash(2166136261u, (uint32_t)(esp_timer_get_time() / 60000000));
+}
+
+static void display_app_uptime_render(lcd_t *lcd, uint8_t row, const display_app_state_t *state)
+{
+    char line[LCD_MAX_COLS + 1];
+    uint32_t minutes = (uint32_t)(esp_timer_get_time() / 60000000);
+
+    lcd_set_cursor(lcd, 0, row);
+    lcd_print(lcd, "Uptime");
+    snprintf(line, sizeof(line), "%lud %02lu:%02lu", (unsigned long)(minutes / 1440),
+             (unsigned long)(minutes / 60 % 24), (unsigned long)(minutes % 60));
+    lcd_set_cursor(lcd, 0, row + 1);
+    lcd_print(lcd, line);
+}
+
+// Errors page: failed sensor reads and the age of the last one
+
+static uint32_t display_app_errors_inputs(const display_app_state_t *state)
+{
+    uint32_t hash = display_app_hash(2166136261u, sensor_data_get_error_count());
+    return display_app_hash(hash, (uint32_t)((esp_timer_get_time() - state->error_us) / 60000000));
+}
+
+static void display_app_errors_render(lcd_t *lcd, uint8_t row, const display_app_state_t *state)
+{
+    uint32_t errors = sensor_data_get_error_count();
+
+    lcd_set_cursor(lcd, 0, row);
+    lcd_print(lcd, "Read errors: ");
+    lcd_print_int(lcd, (int)errors);
+    lcd_set_cursor(lcd, 0, row + 1);
+    if (errors == 0 || state->error_us == 0)
+    {
+        lcd_print(lcd, "None");
+        return;
+    }
+    lcd_print(lcd, "Last ");
+    lcd_print_int(lcd, (int)((esp_timer_get_time() - state->error_us) / 60000000));
+    lcd_print(lcd, "m ago");
+}
+
+// Rotation order, indexed by display_app_page_e
+static const display_app_page_def_t display_app_pages[DISPLAY_APP_PAGE_COUNT] =
+{
+    [DISPLAY_APP_PAGE_CURRENT]  = { display_app_current_inputs, display_app_current_render },
+    [DISPLAY_APP_PAGE_TREND]    = { display_app_trend_inputs, display_app_trend_render },
+    [DISPLAY_APP_PAGE_DAILY]    = { display_app_daily_inputs, display_app_daily_render },
+    [DISPLAY_APP_PAGE_WIFI]     = { display_app_wifi_inputs, display_app_wifi_render },
+    [DISPLAY_APP_PAGE_UPTIME]   = { display_app_uptime_inputs, display_app_uptime_render },
+    [DISPLAY_APP_PAGE_ERRORS]   = { display_app_errors_inputs, display_app_errors_render },
+};
+
+/**
+ * @brief Gets the signature of what a panel should show (its pages or the text).
+ * @param panel panel to draw.
+ * @param state state to show.
+ * @return signature, never DISPLAY_APP_SIGNATURE_NONE.
+ */
+static uint32_t display_app_signature(const display_app_panel_t *panel, const display_app_state_t *state)
+{
+    uint32_t hash;
+
+    if (state->text_active)
+    {
+        hash = 2166136261u;
+        for (const char *c = state->text[0]; *c; c++)
+        {
+            hash = display_app_hash(hash, (uint8_t)*c);
+        }
+        for (const char *c = state->text[1]; *c; c++)
+        {
+            hash = display_app_hash(hash, (uint8_t)*c);
+        }
+        hash = display_app_hash(hash, DISPLAY_APP_PAGE_COUNT);
+    }
+    else
+    {
+        // A taller panel shows the pages following the visible one below it
+        hash = 2166136261u;
+        for (int i = 0; i < panel->rows / 2; i++)
+        {
+            display_app_page_e page = (state->page + i) % DISPLAY_APP_PAGE_COUNT;
+            hash = display_app_hash(hash, display_app_pages[page].inputs(state));
+            hash = display_app_hash(hash, page);
+        }
+    }
+    return hash == DISPLAY_APP_SIGNATURE_NONE ? 1 : hash;
+}
+
+/**
+ * @brief Draws a state into a panel's framebuffer (sent by the caller's lcd_flush_all()).
+ * @param panel panel to draw.
+ * @param state state to draw.
+ */
+static void display_app_render(display_app_panel_t *panel, const display_app_state_t *state)
+{
+    lcd_t *lcd = &panel->lcd;
+
+    lcd_clear_frame(lcd);
+    lcd_glyph_begin_frame(lcd);
+
+    if (state->text_active)
+    {
+        lcd_set_cursor(lcd, 0, 0);
+        lcd_print(lcd, state->text[0]);
+        lcd_set_cursor(lcd, 0, 1);
+        lcd_print(lcd, state->text[1]);
+        return;
+    }
+
+    for (uint8_t row = 0; row + 1 < panel->rows; row += 2)
+    {
+        display_app_pages[(state->page + row / 2) % DISPLAY_APP_PAGE_COUNT].render(lcd, row, state);
+    }
+}
+
+/**
+ * @brief Display task: initializes the panels, then rotates the pages and draws them when their inputs change.
+ * @param pvParameters parameter which can be passed to the task.
+ */
+static void display_app_task(void *pvParameters)
+{
+    display_app_state_t state;
+    TickType_t page_since = xTaskGetTickCount();
+
+    for (size_t i = 0; i < DISPLAY_APP_PANELS; i++)
+    {
+        display_app_panel_t *panel = &display_app_panels[i];
+        panel->ok = liquid_crystal_i2c_init(&panel->lcd, panel->address, panel->cols, panel->rows) == ESP_OK;
+        if (!panel->ok)
+        {
+            ESP_LOGW(TAG, "display_app_task: no %dx%d panel at 0x%02X, left out", panel->cols, panel->rows, panel->address);
+        }
+    }
+
+    for (;;)
+    {
+        TickType_t now = xTaskGetTickCount();
+
+        portENTER_CRITICAL(&display_app_lock);
+        if (display_app_state.page_requested)
+        {
+            display_app_state.page_requested = false;
+            page_since = now;
+        }
+        else if (display_app_state.rotate && !display_app_state.text_active
+                 && now - page_since >= pdMS_TO_TICKS(DISPLAY_APP_PAGE_INTERVAL_MS))
+        {
+            display_app_state.page = (display_app_state.page + 1) % DISPLAY_APP_PAGE_COUNT;
+            page_since = now;
+        }
+        state = display_app_state;
+        portEXIT_CRITICAL(&display_app_lock);
+
+        // Only the visible pages are evaluated, and a panel only drawn if what it shows has changed
+        // or a write to it failed (the driver then resends the whole panel)
+        lcd_t *changed[DISPLAY_APP_PANELS];
+        size_t count = 0;
+        for (size_t i = 0; i < DISPLAY_APP_PANELS; i++)
+        {
+            display_app_panel_t *panel = &display_app_panels[i];
+            uint32_t signature = panel->ok ? display_app_signature(panel, &state) : DISPLAY_APP_SIGNATURE_NONE;
+            if (signature != panel->shown || (panel->ok && lcd_get_redraw_pending(&panel->lcd)))
+            {
+                display_app_render(panel, &state);
+                panel->shown = signature;
+                changed[count++] = &panel->lcd;
+            }
+        }
+
+        if (count > 0)
+        {
+            // Both panels' changes go out as one stream of queued writes
+            lcd_flush_all(changed, count);
+
+            // Requests arriving from here on are drawn together in the next frame
+            vTaskDelay(pdMS_TO_TICKS(DISPLAY_APP_FRAME_INTERVAL_MS));
+        }
+
+        // Sleep until a request, the next input check or the next page
+        TickType_t wait = pdMS_TO_TICKS(DISPLAY_APP_POLL_MS);
+        if (state.rotate && !state.text_active)
+        {
+            TickType_t elapsed = xTaskGetTickCount() - page_since;
+            TickType_t left = elapsed < pdMS_TO_TICKS(DISPLAY_APP_PAGE_INTERVAL_MS) ? pdMS_TO_TICKS(DISPLAY_APP_PAGE_INTERVAL_MS) - elapsed : 0;
+            wait = left < wait ? left : wait;
+        }
+        ulTaskNotifyTake(pdTRUE, wait);
+    }
+}
+
+void display_app_start(void)
+{
+    if (task_display_app != NULL)
+    {
+        return;
+    }
+
+    ESP_LOGI(TAG, "display_app_start: starting display task");
+    xTaskCreatePinnedToCore(&display_app_task, "display_app_task", DISPLAY_APP_TASK_STACK_SIZE, NULL, DISPLAY_APP_TASK_PRIORITY, &task_display_app, DISPLAY_APP_TASK_CORE_ID);
+}
+
+void display_app_show_text(const char *line1, const char *line2)
+{
+    portENTER_CRITICAL(&display_app_lock);
+    display_app_state.text_active = true;
+    snprintf(display_app_state.text[0], sizeof(display_app_state.text[0]), "%s", line1 ? line1 : "");
+    snprintf(display_app_state.text[1], sizeof(display_app_state.text[1]), "%s", line2 ? line2 : "");
+    portEXIT_CRITICAL(&display_app_lock);
+    display_app_notify();
+}
+
+void display_app_show_sample(int temperature, int humidity)
+{
+    // Local calendar day of the reading, for the daily range; until SNTP sets the clock
+    // the day is unknown and the range covers everything since boot
+    int day = DISPLAY_APP_DAY_BOOT;
+    if (time_sync_is_valid())
+    {
+        time_t now = time(NULL);
+        struct tm local;
+        localtime_r(&now, &local);
+        day = local.tm_year * 366 + local.tm_yday;
+    }
+
+    portENTER_CRITICAL(&display_app_lock);
+    if (!display_app_state.sample_valid || display_app_state.day != day)
+    {
+        display_app_state.day = day;
+        display_app_state.day_temperature[0] = display_app_state.day_temperature[1] = temperature;
+        display_app_state.day_humidity[0] = display_app_state.day_humidity[1] = humidity;
+    }
+    display_app_state.day_temperature[0] = temperature < display_app_state.day_temperature[0] ? temperature : display_app_state.day_temperature[0];
+    display_app_state.day_temperature[1] = temperature > display_app_state.day_temperature[1] ? temperature : display_app_state.day_temperature[1];
+    display_app_state.day_humidity[0] = humidity < display_app_state.day_humidity[0] ? humidity : display_app_state.day_humidity[0];
+    display_app_state.day_humidity[1] = humidity > display_app_state.day_humidity[1] ? humidity : display_app_state.day_humidity[1];
+
+    display_app_state.text_active = false;
+    display_app_state.sample_valid = true;
+    display_app_state.sensor_error = false;
+    display_app_state.temperature = temperature;
+    display_app_state.humidity = humidity;
+    memmove(&display_app_state.trend[0], &display_app_state.trend[1], sizeof(display_app_state.trend) - sizeof(int));
+    display_app_state.trend[DISPLAY_APP_TREND_LENGTH - 1] = temperature;
+    if (display_app_state.trend_count < DISPLAY_APP_TREND_LENGTH)
+    {
+        display_app_state.trend_count++;
+    }
+    portEXIT_CRITICAL(&display_app_lock);
+    display_app_notify();
+}
+
+void display_app_show_error(void)
+{
+    int64_t now = esp_timer_get_time();
+
+    portENTER_CRITICAL(&display_app_lock);
+    display_app_state.text_active = false;
+    display_app_state.sensor_error = true;
+    display_app_state.error_us = now;
+    portEXIT_CRITICAL(&display_app_lock);
+    display_app_notify();
+}
+
+void display_app_show_page(display_app_page_e page)
+{
+    if ((int)page < 0 || page >= DISPLAY_APP_PAGE_COUNT)
+    {
+        return;
+    }
+
+    portENTER_CRITICAL(&display_app_lock);
+    display_app_state.text_active = false;
+    display_app_state.page = page;
+    display_app_state.page_requested = true;
+    portEXIT_CRITICAL(&display_app_lock);
+    display_app_notify();
+}
+
+void display_app_set_rotation(bool enable)
+{
+    portENTER_CRITICAL(&display_app_lock);
+    display_app_state.rotate = enable;
+    display_app_state.page_requested = true;
+    portEXIT_CRITICAL(&display_app_lock);
+    display_app_notify();
+}
@@ -0,0 +1,95 @@
+/**
+ * @file display_app.h
+ * @brief LCD Display Service Header for ESP32 Weather Station
+ * @details This header file defines the display service, the task that owns
+ *          the I2C LCD. Other tasks do not draw on the panel themselves; they
+ *          post render requests ("show this sample", "show the sensor error",
+ *          "show page N", "show this text") that only update the service's
+ *          state and wake its task. Requests arriving faster than the panel
+ *          is redrawn are coalesced into the next frame, so a producer never
+ *          waits for the LCD or the I2C bus. The pages rotate on a timer, and
+ *          a page is only redrawn when the inputs it shows have changed. The
+ *          service drives a 20x4 front panel, showing the page and the next
+ *          one, and a 16x2 back panel; a panel that does not answer at start
+ *          is left out.
+ *
+ * @author christophermena
+ * @date July 30, 2025
+ * @version 1.0
+ * @note Last Updated: October 16, 2026
+ */
+
+#ifndef MAIN_DISPLAY_APP_H_
+#define MAIN_DISPLAY_APP_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Display Service Configuration
+#define DISPLAY_APP_FRONT_ADDRESS       0x27        ///< I2C address of the front panel's backpack
+#define DISPLAY_APP_FRONT_COLS          20          ///< Front panel columns
+#define DISPLAY_APP_FRONT_ROWS          4           ///< Front panel rows (the page and the next one)
+#define DISPLAY_APP_BACK_ADDRESS        0x26        ///< I2C address of the back panel's backpack (A0 bridged)
+#define DISPLAY_APP_BACK_COLS           16          ///< Back panel columns
+#define DISPLAY_APP_BACK_ROWS           2           ///< Back panel rows
+#define DISPLAY_APP_FRAME_INTERVAL_MS   200         ///< Shortest time between two renders
+#define DISPLAY_APP_TREND_LENGTH        16          ///< Readings kept for the sparkline (one per column)
+#define DISPLAY_APP_TREND_SPAN          5           ///< The trend arrow compares with the reading this many samples back
+#define DISPLAY_APP_PAGE_INTERVAL_MS    5000        ///< Time each page is shown while rotating
+#define DISPLAY_APP_POLL_MS             1000        ///< Interval of the visible page's input check (clock driven pages)
+
+/**
+ * @brief Display pages
+ */
+typedef enum display_app_page
+{
+    DISPLAY_APP_PAGE_CURRENT = 0,   ///< Latest reading, or the sensor error
+    DISPLAY_APP_PAGE_TREND,         ///< Temperature range and sparkline of the recent readings
+    DISPLAY_APP_PAGE_DAILY,         ///< Temperature and humidity range of the day (since boot until the clock is set)
+    DISPLAY_APP_PAGE_WIFI,          ///< Station IP and signal strength, or the access point
+    DISPLAY_APP_PAGE_UPTIME,        ///< Time since boot
+    DISPLAY_APP_PAGE_ERRORS,        ///< Failed sensor reads and the age of the last one
+    DISPLAY_APP_PAGE_COUNT,
+} display_app_page_e;
+
+/**
+ * @brief Start the display service task
+ *
+ * The task initializes the LCD itself, so the caller does not wait for the
+ * panel's power-up sequence. Requests posted before the start are kept and
+ * shown in the first frame.
+ */
+void display_app_start(void);
+
+/**
+ * @brief Show two lines of text on every panel until the next sample, error or page request
+ * @param line1 First line (truncated to the panel width)
+ * @param line2 Second line, or NULL for an empty line
+ */
+void display_app_show_text(const char *line1, const char *line2);
+
+/**
+ * @brief Show a sensor reading on the current conditions page
+ * @param temperature Temperature in degrees Celsius (shown in the configured unit)
+ * @param humidity Relative humidity in percent
+ */
+void display_app_show_sample(int temperature, int humidity);
+
+/**
+ * @brief Show the sensor error on the current conditions page until the next reading
+ */
+void display_app_show_error(void);
+
+/**
+ * @brief Switch to a page; with rotation on, the next page follows after DISPLAY_APP_PAGE_INTERVAL_MS
+ * @param page Page to show, out-of-range values are ignored
+ */
+void display_app_show_page(display_app_page_e page);
+
+/**
+ * @brief Turn the timed page rotation on or off (on by default)
+ * @param enable true to rotate, false to stay on the current page
+ */
+void display_app_set_rotation(bool enable);
+
+#endif /* MAIN_DISPLAY_APP_H_ */
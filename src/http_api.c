@@ -0,0 +1,784 @@
+/**
+ * @file http_api.c
+ * @brief JSON Data API Implementation for ESP32 Weather Station
+ * @details This file implements the /api request handlers. Long-poll
+ *          requests are parked as async request copies in a small table;
+ *          a new sample or the periodic timeout sweep queues a work item onto
+ *          the httpd task, which answers every waiter that is ready.
+ *          History exports pull records from the history iterator and encode
+ *          them into a fixed chunk buffer that is flushed with
+ *          httpd_resp_send_chunk(), so memory use does not depend on the range.
+ *          The same buffer serves the binary (CBOR/MessagePack) and CSV exports.
+ *          Handlers are dispatched by the API router and read their path and
+ *          query parameters from the router match.
+ *
+ * @author christophermena
+ * @date July 30, 2025
+ * @version 1.0
+ * @note Last Updated: October 16, 2026
+ */
+
+#include <math.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "sys/param.h"
+
+#include "app_settings.h"
+#include "DHT11.h"
+#include "http_api.h"
+#include "http_cache.h"
+#include "http_server.h"
+#include "sensor_data.h"
+#include "sensor_history.h"
+
+// Tag used for ESP serial console messages
+static const char TAG[] = "http_api";
+
+/**
+ * @brief One parked long-poll request
+ */
+typedef struct http_api_waiter
+{
+    httpd_req_t *req;       ///< Async request copy, NULL if the slot is free
+    int sockfd;             ///< Socket of the request
+    uint32_t after;         ///< Sequence number the client already has
+    int64_t deadline;       ///< esp_timer time at which the request times out
+} http_api_waiter_t;
+
+// Parked requests, only touched from the httpd task
+static http_api_waiter_t g_waiters[HTTP_API_LONGPOLL_MAX_WAITERS];
+
+// Number of parked requests, read by the listener and the sweep timer
+static volatile int g_waiter_count = 0;
+
+// Server the requests belong to
+static httpd_handle_t g_server = NULL;
+
+// Set while a wake-up is queued
+static volatile bool g_wake_queued = false;
+
+// Timeout sweep timer
+static esp_timer_handle_t http_api_sweep_timer = NULL;
+
+// Cached responses, rendered once per sample / settings change
+static http_cache_entry_t *g_sample_cache = NULL;
+static http_cache_entry_t *g_settings_cache = NULL;
+
+/**
+ * @brief Renders the latest sample as JSON.
+ * @param buff destination buffer.
+ * @param buff_size size of the destination buffer.
+ * @param arg unused.
+ * @return body length, -1 before the first sample.
+ */
+static int http_api_render_sample(char *buff, size_t buff_size, void *arg)
+{
+    sensor_sample_t sample;
+
+    if (!sensor_data_get_latest(&sample))
+    {
+        return -1;
+    }
+    return sensor_data_format_json(&sample, buff, buff_size);
+}
+
+/**
+ * @brief Sends the latest sample as the JSON response.
+ * @param req HTTP request to respond to (a sample must have been published).
+ * @return result of the send.
+ */
+static esp_err_t http_api_send_sample(httpd_req_t *req)
+{
+    httpd_resp_set_hdr(req, "Cache-Control", "no-store");
+    return http_cache_send(req, g_sample_cache);
+}
+
+/**
+ * @brief Answers a parked request and frees its slot.
+ * @param waiter parked request.
+ * @param sample latest sample, NULL to answer 204 No Content.
+ */
+static void http_api_release(http_api_waiter_t *waiter, const sensor_sample_t *sample)
+{
+    if (sample != NULL)
+    {
+        http_api_send_sample(waiter->req);
+    }
+    else
+    {
+        httpd_resp_set_status(waiter->req, "204 No Content");
+        httpd_resp_send(waiter->req, NULL, 0);
+    }
+    httpd_req_async_handler_complete(waiter->req);
+    waiter->req = NULL;
+    g_waiter_count--;
+}
+
+/**
+ * @brief Work item executed on the httpd task: answers waiters that have a newer sample or timed out.
+ * @param arg unused.
+ */
+static void http_api_wake(void *arg)
+{
+    sensor_sample_t sample;
+    int64_t now = esp_timer_get_time();
+
+    g_wake_queued = false;
+    bool have_sample = sensor_data_get_latest(&sample);
+
+    for (int i = 0; i < HTTP_API_LONGPOLL_MAX_WAITERS; i++)
+    {
+        http_api_waiter_t *waiter = &g_waiters[i];
+
+        if (waiter->req == NULL)
+        {
+            continue;
+        }
+        if (have_sample && sample.seq != waiter->after)
+        {
+            http_api_release(waiter, &sample);
+        }
+        else if (now >= waiter->deadline)
+        {
+            http_api_release(waiter, NULL);
+        }
+    }
+}
+
+/**
+ * @brief Queues a wake-up onto the httpd task if requests are parked.
+ */
+static void http_api_queue_wake(void)
+{
+    if (g_waiter_count == 0 || g_server == NULL || g_wake_queued)
+    {
+        return;
+    }
+    g_wake_queued = true;
+    if (httpd_queue_work(g_server, http_api_wake, NULL) != ESP_OK)
+    {
+        g_wake_queued = false;
+    }
+}
+
+/**
+ * @brief Sample listener, wakes the parked requests.
+ * @param sample published sample (read again by the wake-up).
+ */
+static void http_api_sample_listener(const sensor_sample_t *sample)
+{
+    http_api_queue_wake();
+}
+
+/**
+ * @brief Sweep timer callback, lets the wake-up time out expired requests.
+ * @param arg unused.
+ */
+static void http_api_sweep_callback(void *arg)
+{
+    http_api_queue_wake();
+}
+
+/**
+ * @brief Renders the settings as JSON.
+ * @param buff destination buffer.
+ * @param buff_size size of the destination buffer.
+ * @param arg unused.
+ * @return body length.
+ */
+static int http_api_render_settings(char *buff, size_t buff_size, void *arg)
+{
+    return snprintf(buff, buff_size, "{\"unit\":\"%c\"}", app_settings_get_fahrenheit() ? 'F' : 'C');
+}
+
+void http_api_init(void)
+{
+    http_cache_init();
+    g_sample_cache = http_cache_add("/api/current", HTTP_CACHE_TOPIC_SAMPLE, "application/json", http_api_render_sample, NULL);
+    g_settings_cache = http_cache_add("/api/settings", HTTP_CACHE_TOPIC_SETTINGS, "application/json", http_api_render_settings, NULL);
+
+    if (http_api_sweep_timer != NULL)
+    {
+        return;
+    }
+
+    const esp_timer_create_args_t sweep_args = {
+        .callback = &http_api_sweep_callback,
+        .arg = NULL,
+        .dispatch_method = ESP_TIMER_TASK,
+        .name = "api_sweep",
+    };
+    ESP_ERROR_CHECK(esp_timer_create(&sweep_args, &http_api_sweep_timer));
+    ESP_ERROR_CHECK(esp_timer_start_periodic(http_api_sweep_timer, HTTP_API_LONGPOLL_SWEEP_MS * 1000ULL));
+
+    sensor_data_add_listener(http_api_sample_listener);
+}
+
+/**
+ * @brief Checks the {id} path parameter, answers 404 for an unknown sensor.
+ * @param req HTTP request.
+ * @param match route match (routes without {id} address the only sensor).
+ * @return true if the sensor exists.
+ */
+static bool http_api_sensor_exists(httpd_req_t *req, const http_router_match_t *match)
+{
+    char id[16];
+
+    if (!http_router_get_param(match, "id", id, sizeof(id)) ||
+        strcmp(id, "0") == 0 || strcmp(id, HTTP_API_SENSOR_NAME) == 0)
+    {
+        return true;
+    }
+    httpd_resp_send_err(req, HTTPD_404_NOT_FOUND, "No such sensor");
+    return false;
+}
+
+esp_err_t http_api_sensors_handler(httpd_req_t *req, const http_router_match_t *match)
+{
+    httpd_resp_set_type(req, "application/json");
+    return httpd_resp_sendstr(req, "[{\"id\":0,\"name\":\"" HTTP_API_SENSOR_NAME "\"}]");
+}
+
+esp_err_t http_api_sensor_handler(httpd_req_t *req, const http_router_match_t *match)
+{
+    sensor_sample_t sample;
+
+    if (!http_api_sensor_exists(req, match))
+    {
+        return ESP_OK;
+    }
+    if (!sensor_data_get_latest(&sample))
+    {
+        httpd_resp_set_status(req, "503 Service Unavailable");
+        httpd_resp_set_hdr(req, "Retry-After", "5");
+        httpd_resp_sendstr(req, "No sample yet");
+        return ESP_OK;
+    }
+    return http_api_send_sample(req);
+}
+
+esp_err_t http_api_current_handler(httpd_req_t *req, const http_router_match_t *match)
+{
+    sensor_sample_t sample;
+    char value[12];
+    uint32_t after = 0;
+
+    bool wait = http_router_get_query(match, "after", value, sizeof(value));
+    if (!http_router_get_query_u32(match, "after", 0, &after))
+    {
+        httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, "Invalid after");
+        return ESP_OK;
+    }
+
+    // Answer right away if the client is behind (or ahead, after a reboot of the station)
+    bool have_sample = sensor_data_get_latest(&sample);
+    if (have_sample && (!wait || sample.seq != after))
+    {
+        return http_api_send_sample(req);
+    }
+    if (!wait)
+    {
+        httpd_resp_set_status(req, "503 Service Unavailable");
+        httpd_resp_set_hdr(req, "Retry-After", "5");
+        httpd_resp_sendstr(req, "No sample yet");
+        return ESP_OK;
+    }
+
+    http_api_waiter_t *waiter = NULL;
+    for (int i = 0; i < HTTP_API_LONGPOLL_MAX_WAITERS; i++)
+    {
+        if (g_waiters[i].req == NULL)
+        {
+            waiter = &g_waiters[i];
+            break;
+        }
+    }
+    if (waiter == NULL)
+    {
+        httpd_resp_set_status(req, "503 Service Unavailable");
+        httpd_resp_set_hdr(req, "Retry-After", "5");
+        httpd_resp_sendstr(req, "Too many waiting requests");
+        return ESP_OK;
+    }
+
+    // Park the request, it is answered from http_api_wake()
+    if (httpd_req_async_handler_begin(req, &waiter->req) != ESP_OK)
+    {
+        waiter->req = NULL;
+        return ESP_FAIL;
+    }
+    waiter->sockfd = httpd_req_to_sockfd(waiter->req);
+    waiter->after = after;
+    waiter->deadline = esp_timer_get_time() + HTTP_API_LONGPOLL_TIMEOUT_MS * 1000LL;
+    g_waiter_count++;
+    g_server = req->handle;
+
+    // A sample published between the check above and parking must not be missed
+    http_api_wake(NULL);
+
+    ESP_LOGI(TAG, "http_api_current_handler: waiting for sample after %lu (%d parked)", after, g_waiter_count);
+    return ESP_OK;
+}
+
+/**
+ * @brief Chunked response writer shared by the exports
+ */
+typedef struct http_api_stream
+{
+    httpd_req_t *req;                       ///< Request being answered
+    size_t len;                             ///< Bytes used in buff
+    esp_err_t err;                          ///< First send error
+    uint8_t buff[HTTP_API_CHUNK_SIZE];      ///< Chunk buffer
+} http_api_stream_t;
+
+/**
+ * @brief Appends bytes to the chunk buffer, sending it as a chunk when full.
+ * @param stream stream state.
+ * @param data bytes to append.
+ * @param len number of bytes (at most HTTP_API_CHUNK_SIZE).
+ */
+static void http_api_stream_write(http_api_stream_t *stream, const void *data, size_t len)
+{
+    if (stream->err != ESP_OK)
+    {
+        return;
+    }
+    if (stream->len + len > sizeof(stream->buff))
+    {
+        stream->err = httpd_resp_send_chunk(stream->req, (const char *)stream->buff, stream->len);
+        stream->len = 0;
+    }
+    memcpy(stream->buff + stream->len, data, len);
+    stream->len += len;
+}
+
+/**
+ * @brief Sends the buffered rest and terminates the chunked response.
+ * @param stream stream state.
+ * @return ESP_OK, otherwise the first send error.
+ */
+static esp_err_t http_api_stream_finish(http_api_stream_t *stream)
+{
+    if (stream->err == ESP_OK && stream->len > 0)
+    {
+        stream->err = httpd_resp_send_chunk(stream->req, (const char *)stream->buff, stream->len);
+    }
+    if (stream->err == ESP_OK)
+    {
+        stream->err = httpd_resp_send_chunk(stream->req, NULL, 0);
+    }
+    return stream->err;
+}
+
+/**
+ * @brief Formats text directly into the chunk buffer, sending it first if the text might not fit.
+ * @param stream stream state.
+ * @param fmt printf style format, the output must be shorter than HTTP_API_CSV_ROW_MAX.
+ */
+static void http_api_stream_printf(http_api_stream_t *stream, const char *fmt, ...)
+{
+    va_list args;
+
+    if (stream->err != ESP_OK)
+    {
+        return;
+    }
+    if (sizeof(stream->buff) - stream->len < HTTP_API_CSV_ROW_MAX)
+    {
+        stream->err = httpd_resp_send_chunk(stream->req, (const char *)stream->buff, stream->len);
+        stream->len = 0;
+    }
+
+    va_start(args, fmt);
+    int len = vsnprintf((char *)stream->buff + stream->len, sizeof(stream->buff) - stream->len, fmt, args);
+    va_end(args);
+
+    if (len > 0)
+    {
+        stream->len += MIN((size_t)len, sizeof(stream->buff) - stream->len - 1);
+    }
+}
+
+/**
+ * @brief Writes a CBOR data item head (major type and argument).
+ * @param stream stream state.
+ * @param major CBOR major type (0-7).
+ * @param value argument.
+ */
+static void http_api_cbor_head(http_api_stream_t *stream, uint8_t major, uint32_t value)
+{
+    uint8_t head[5];
+    size_t len;
+
+    major <<= 5;
+    if (value < 24)
+    {
+        head[0] = major | value;
+        len = 1;
+    }
+    else if (value <= 0xFF)
+    {
+        head[0] = major | 24;
+        head[1] = value;
+        len = 2;
+    }
+    else if (value <= 0xFFFF)
+    {
+        head[0] = major | 25;
+        head[1] = value >> 8;
+        head[2] = value & 0xFF;
+        len = 3;
+    }
+    else
+    {
+        head[0] = major | 26;
+        head[1] = value >> 24;
+        head[2] = (value >> 16) & 0xFF;
+        head[3] = (value >> 8) & 0xFF;
+        head[4] = value & 0xFF;
+        len = 5;
+    }
+    http_api_stream_write(stream, head, len);
+}
+
+/**
+ * @brief Writes a CBOR integer.
+ */
+static void http_api_cbor_int(http_api_stream_t *stream, int32_t value)
+{
+    if (value >= 0)
+    {
+        http_api_cbor_head(stream, 0, value);
+    }
+    else
+    {
+        http_api_cbor_head(stream, 1, -1 - value);
+    }
+}
+
+/**
+ * @brief Writes a MessagePack array header.
+ */
+static void http_api_msgpack_array(http_api_stream_t *stream, uint32_t count)
+{
+    uint8_t head[5];
+    size_t len;
+
+    if (count < 16)
+    {
+        head[0] = 0x90 | count;
+        len = 1;
+    }
+    else if (count <= 0xFFFF)
+    {
+        head[0] = 0xDC;
+        head[1] = count >> 8;
+        head[2] = count & 0xFF;
+        len = 3;
+    }
+    else
+    {
+        head[0] = 0xDD;
+        head[1] = count >> 24;
+        head[2] = (count >> 16) & 0xFF;
+        head[3] = (count >> 8) & 0xFF;
+        head[4] = count & 0xFF;
+        len = 5;
+    }
+    http_api_stream_write(stream, head, len);
+}
+
+/**
+ * @brief Writes a MessagePack integer in its shortest form.
+ */
+static void http_api_msgpack_int(http_api_stream_t *stream, int32_t value)
+{
+    uint8_t head[5];
+    size_t len;
+
+    if (value >= 0 && value < 128)
+    {
+        head[0] = value;
+        len = 1;
+    }
+    else if (value < 0 && value >= -32)
+    {
+        head[0] = (uint8_t)(int8_t)value;
+        len = 1;
+    }
+    else if (value < 0 && value >= -128)
+    {
+        head[0] = 0xD0;
+        head[1] = (uint8_t)(int8_t)value;
+        len = 2;
+    }
+    else if (value < 0)
+    {
+        head[0] = 0xD2;
+        head[1] = (uint32_t)value >> 24;
+        head[2] = ((uint32_t)value >> 16) & 0xFF;
+        head[3] = ((uint32_t)value >> 8) & 0xFF;
+        head[4] = (uint32_t)value & 0xFF;
+        len = 5;
+    }
+    else if (value <= 0xFF)
+    {
+        head[0] = 0xCC;
+        head[1] = value;
+        len = 2;
+    }
+    else if (value <= 0xFFFF)
+    {
+        head[0] = 0xCD;
+        head[1] = value >> 8;
+        head[2] = value & 0xFF;
+        len = 3;
+    }
+    else
+    {
+        head[0] = 0xCE;
+        head[1] = value >> 24;
+        head[2] = (value >> 16) & 0xFF;
+        head[3] = (value >> 8) & 0xFF;
+        head[4] = value & 0xFF;
+        len = 5;
+    }
+    http_api_stream_write(stream, head, len);
+}
+
+/**
+ * @brief Starts a history iterator for the from/to/res query parameters.
+ *
+ * Answers 404 for an unknown sensor, 400 for a malformed parameter and 503 if the store is unavailable.
+ *
+ * @param req HTTP request.
+ * @param match route match.
+ * @param iter iterator to initialize.
+ * @return true if the iterator is ready.
+ */
+static bool http_api_history_begin(httpd_req_t *req, const http_router_match_t *match, sensor_history_iter_t *iter)
+{
+    uint32_t from, to, res;
+
+    if (!http_api_sensor_exists(req, match))
+    {
+        return false;
+    }
+    if (!http_router_get_query_u32(match, "from", 0, &from) ||
+        !http_router_get_query_u32(match, "to", UINT32_MAX, &to) ||
+        !http_router_get_query_u32(match, "res", 0, &res))
+    {
+        httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, "Invalid from, to or res");
+        return false;
+    }
+    if (sensor_history_iter_begin(iter, from, to, res) != ESP_OK)
+    {
+        httpd_resp_set_status(req, "503 Service Unavailable");
+        httpd_resp_sendstr(req, "History not available");
+        return false;
+    }
+    return true;
+}
+
+esp_err_t http_api_history_handler(httpd_req_t *req, const http_router_match_t *match)
+{
+    char value[32];
+    bool msgpack = false;
+    sensor_history_iter_t iter;
+    sensor_history_record_t record;
+    http_api_stream_t stream = { .req = req, .len = 0, .err = ESP_OK };
+
+    if (http_router_get_query(match, "format", value, sizeof(value)))
+    {
+        msgpack = (strcmp(value, "msgpack") == 0);
+    }
+    else if (httpd_req_get_hdr_value_str(req, "Accept", value, sizeof(value)) != ESP_ERR_NOT_FOUND)
+    {
+        // A truncated header value is fine, only the start is searched
+        msgpack = (strstr(value, "msgpack") != NULL);
+    }
+
+    if (!http_api_history_begin(req, match, &iter))
+    {
+        return ESP_OK;
+    }
+
+    httpd_resp_set_type(req, msgpack ? "application/msgpack" : "application/cbor");
+    httpd_resp_set_hdr(req, "Cache-Control", "no-store");
+
+    if (msgpack)
+    {
+        // MessagePack arrays are counted: one decode-only pass over the mapped store first
+        uint32_t count = 0;
+        while (sensor_history_iter_next(&iter, &record))
+        {
+            count++;
+        }
+        sensor_history_iter_begin(&iter, iter.from, iter.to, iter.res);
+
+        http_api_msgpack_array(&stream, count);
+        while (count > 0 && stream.err == ESP_OK && sensor_history_iter_next(&iter, &record))
+        {
+            http_api_msgpack_array(&stream, 3);
+            http_api_msgpack_int(&stream, (int32_t)record.time);
+            http_api_msgpack_int(&stream, record.temperature);
+            http_api_msgpack_int(&stream, record.humidity);
+            count--;
+        }
+        if (count > 0 && stream.err == ESP_OK)
+        {
+            // The writer reused the oldest sector between the passes: the array would be short of its announced
+            // length, so end the response without its final chunk and let httpd close the connection
+            ESP_LOGW(TAG, "http_api_history_handler: %lu records evicted during the export, aborting", count);
+            return ESP_FAIL;
+        }
+    }
+    else
+    {
+        static const uint8_t cbor_array_begin = 0x9F;
+        static const uint8_t cbor_break = 0xFF;
+
+        http_api_stream_write(&stream, &cbor_array_begin, 1);
+        while (sensor_history_iter_next(&iter, &record) && stream.err == ESP_OK)
+        {
+            http_api_cbor_head(&stream, 4, 3);
+            http_api_cbor_head(&stream, 0, record.time);
+            http_api_cbor_int(&stream, record.temperature);
+            http_api_cbor_int(&stream, record.humidity);
+        }
+        http_api_stream_write(&stream, &cbor_break, 1);
+    }
+
+    if (http_api_stream_finish(&stream) != ESP_OK)
+    {
+        ESP_LOGI(TAG, "http_api_history_handler: client went away");
+        return ESP_FAIL;
+    }
+    return ESP_OK;
+}
+
+esp_err_t http_api_history_csv_handler(httpd_req_t *req, const http_router_match_t *match)
+{
+    char value[4];
+    char datetime[24];
+    struct tm tm;
+    sensor_history_iter_t iter;
+    sensor_history_record_t record;
+    http_api_stream_t stream = { .req = req, .len = 0, .err = ESP_OK };
+
+    bool fahrenheit = app_settings_get_fahrenheit();
+    if (http_router_get_query(match, "unit", value, sizeof(value)))
+    {
+        fahrenheit = (value[0] == 'F' || value[0] == 'f');
+    }
+
+    if (!http_api_history_begin(req, match, &iter))
+    {
+        return ESP_OK;
+    }
+
+    httpd_resp_set_type(req, "text/csv");
+    httpd_resp_set_hdr(req, "Content-Disposition", "attachment; filename=\"history.csv\"");
+    httpd_resp_set_hdr(req, "Cache-Control", "no-store");
+
+    http_api_stream_printf(&stream, "time,datetime,temperature_%c,humidity\r\n", fahrenheit ? 'f' : 'c');
+    while (sensor_history_iter_next(&iter, &record) && stream.err == ESP_OK)
+    {
+        time_t time = record.time;
+        int temperature = fahrenheit ? (int)lroundf(dht11_celsius_to_fahrenheit(record.temperature)) : record.temperature;
+
+        gmtime_r(&time, &tm);
+        strftime(datetime, sizeof(datetime), "%Y-%m-%d %H:%M:%S", &tm);
+        http_api_stream_printf(&stream, "%lu,%s,%d,%d\r\n", record.time, datetime, temperature, record.humidity);
+    }
+
+    if (http_api_stream_finish(&stream) != ESP_OK)
+    {
+        ESP_LOGI(TAG, "http_api_history_csv_handler: client went away");
+        return ESP_FAIL;
+    }
+    return ESP_OK;
+}
+
+esp_err_t http_api_settings_get_handler(httpd_req_t *req, const http_router_match_t *match)
+{
+    return http_cache_send(req, g_settings_cache);
+}
+
+esp_err_t http_api_settings_post_handler(httpd_req_t *req, const http_router_match_t *match)
+{
+    char body[64];
+    char value[4];
+
+    if (req->content_len == 0 || req->content_len >= sizeof(body))
+    {
+        httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, "Invalid settings body");
+        return ESP_OK;
+    }
+    if (!http_server_recv_exact(req, body, req->content_len))
+    {
+        return ESP_FAIL;
+    }
+    body[req->content_len] = '\0';
+
+    if (httpd_query_key_value(body, "unit", value, sizeof(value)) == ESP_OK)
+    {
+        if (strcmp(value, "F") != 0 && strcmp(value, "C") != 0)
+        {
+            httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, "unit must be F or C");
+            return ESP_OK;
+        }
+        if (app_settings_set_fahrenheit(value[0] == 'F') != ESP_OK)
+        {
+            httpd_resp_send_err(req, HTTPD_500_INTERNAL_SERVER_ERROR, "Cannot save settings");
+            return ESP_OK;
+        }
+        http_cache_invalidate(HTTP_CACHE_TOPIC_SETTINGS);
+    }
+
+    return http_cache_send(req, g_settings_cache);
+}
+
+void http_api_close_all(void)
+{
+    for (int i = 0; i < HTTP_API_LONGPOLL_MAX_WAITERS; i++)
+    {
+        if (g_waiters[i].req != NULL)
+        {
+            http_api_release(&g_waiters[i], NULL);
+        }
+    }
+    g_server = NULL;
+}
+
+bool http_api_has_sock(int sockfd)
+{
+    for (int i = 0; i < HTTP_API_LONGPOLL_MAX_WAITERS; i++)
+    {
+        if (g_waiters[i].req != NULL && g_waiters[i].sockfd == sockfd)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+void http_api_sock_close(int sockfd)
+{
+    for (int i = 0; i < HTTP_API_LONGPOLL_MAX_WAITERS; i++)
+    {
+        http_api_waiter_t *waiter = &g_waiters[i];
+
+        if (waiter->req != NULL && waiter->sockfd == sockfd)
+        {
+            httpd_req_async_handler_complete(waiter->req);
+            waiter->req = NULL;
+            g_waiter_count--;
+        }
+    }
+}
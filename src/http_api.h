@@ -0,0 +1,141 @@
+/**
+ * @file http_api.h
+ * @brief JSON Data API Header for ESP32 Weather Station
+ * @details This header file defines the /api request handlers that return
+ *          sensor data as JSON. GET /api/current?after=<seq> is a long-poll:
+ *          it answers immediately when a sample newer than <seq> exists and
+ *          otherwise parks the request, without holding the httpd task, until
+ *          the sensor publishes or the wait times out. GET /api/history
+ *          and /api/history.csv stream the stored history in chunks,
+ *          decoded on the fly. /api/settings reads and changes user settings.
+ *          /api/sensors/{id} exposes the same data per sensor. All handlers
+ *          are typed router handlers (see http_router.h).
+ *
+ * @author christophermena
+ * @date July 30, 2025
+ * @version 1.0
+ * @note Last Updated: October 16, 2026
+ */
+
+#ifndef MAIN_HTTP_API_H_
+#define MAIN_HTTP_API_H_
+
+#include "esp_http_server.h"
+
+#include "http_router.h"
+
+// Long-poll Configuration
+#define HTTP_API_LONGPOLL_MAX_WAITERS   8           ///< Requests that can be parked at the same time
+#define HTTP_API_LONGPOLL_TIMEOUT_MS    30000       ///< Wait before answering 204 No Content
+#define HTTP_API_LONGPOLL_SWEEP_MS      1000        ///< Timeout resolution
+
+// Export Configuration
+#define HTTP_API_CHUNK_SIZE             1024        ///< Chunk buffer of the streaming exports (on the httpd stack)
+#define HTTP_API_CSV_ROW_MAX            64          ///< Longest CSV row
+
+// Sensor addressed by /api/sensors/{id} ({id} is 0 or the name)
+#define HTTP_API_SENSOR_NAME            "dht11"
+
+/**
+ * @brief Register the sample listener and the long-poll timeout timer
+ * @note Call once before the HTTP server starts accepting /api requests
+ */
+void http_api_init(void);
+
+/**
+ * @brief GET /api/sensors handler, lists the sensors as JSON
+ * @param req HTTP request to respond to
+ * @param match Route match
+ * @return ESP_OK
+ */
+esp_err_t http_api_sensors_handler(httpd_req_t *req, const http_router_match_t *match);
+
+/**
+ * @brief GET /api/sensors/{id} handler, responds with the latest sample of the sensor
+ * @param req HTTP request to respond to
+ * @param match Route match ({id} is 0 or HTTP_API_SENSOR_NAME, anything else answers 404)
+ * @return ESP_OK
+ */
+esp_err_t http_api_sensor_handler(httpd_req_t *req, const http_router_match_t *match);
+
+/**
+ * @brief GET /api/current handler
+ *
+ * Without "after", or when the latest sample's sequence number differs from
+ * "after", the latest sample is returned right away. Otherwise the request
+ * waits for the next sample and answers 204 No Content after
+ * HTTP_API_LONGPOLL_TIMEOUT_MS. Answers 503 before the first sample when
+ * no wait was requested, and when all wait slots are in use.
+ *
+ * @param req HTTP request to respond to
+ * @param match Route match (query and path parameters)
+ * @return ESP_OK, otherwise ESP_FAIL if the request could not be parked
+ */
+esp_err_t http_api_current_handler(httpd_req_t *req, const http_router_match_t *match);
+
+/**
+ * @brief GET /api/history and /api/sensors/{id}/history handler
+ *
+ * Query parameters: from and to (seconds, [from, to)), res (seconds, 0 for
+ * raw samples) and format (cbor, the default, or msgpack; an Accept header
+ * naming msgpack also selects MessagePack). The body is an array of
+ * [time, temperature_c, humidity] arrays, oldest first: an indefinite-length
+ * array in CBOR, a counted array in MessagePack.
+ *
+ * @param req HTTP request to respond to
+ * @param match Route match (query and path parameters)
+ * @return ESP_OK, otherwise ESP_FAIL if the client went away
+ */
+esp_err_t http_api_history_handler(httpd_req_t *req, const http_router_match_t *match);
+
+/**
+ * @brief GET /api/history.csv and /api/sensors/{id}/history.csv handler
+ *
+ * Same range parameters as /api/history. Rows are
+ * "time,datetime,temperature_<unit>,humidity" with the datetime in UTC;
+ * unit=F or unit=C overrides the configured display unit.
+ *
+ * @param req HTTP request to respond to
+ * @param match Route match (query and path parameters)
+ * @return ESP_OK, otherwise ESP_FAIL if the client went away
+ */
+esp_err_t http_api_history_csv_handler(httpd_req_t *req, const http_router_match_t *match);
+
+/**
+ * @brief GET /api/settings handler, responds with {"unit":"F"} or {"unit":"C"}
+ * @param req HTTP request to respond to
+ * @param match Route match (query and path parameters)
+ * @return ESP_OK
+ */
+esp_err_t http_api_settings_get_handler(httpd_req_t *req, const http_router_match_t *match);
+
+/**
+ * @brief POST /api/settings handler, form body "unit=F" or "unit=C"
+ * @param req HTTP request to respond to
+ * @param match Route match (query and path parameters)
+ * @return ESP_OK, otherwise ESP_FAIL if the client went away
+ */
+esp_err_t http_api_settings_post_handler(httpd_req_t *req, const http_router_match_t *match);
+
+/**
+ * @brief Answer all parked requests
+ * @note Must be called before httpd_stop()
+ */
+void http_api_close_all(void);
+
+/**
+ * @brief Check whether a socket carries a parked long-poll request
+ * @param sockfd Socket descriptor
+ * @return true if the socket is parked in the waiter table
+ * @note Call from the httpd task only
+ */
+bool http_api_has_sock(int sockfd);
+
+/**
+ * @brief Release the parked request of a closed socket without answering it
+ * @param sockfd Closed socket
+ * @note Called from the httpd close_fn
+ */
+void http_api_sock_close(int sockfd);
+
+#endif /* MAIN_HTTP_API_H_ */
@@ -0,0 +1,147 @@
+/**
+ * @file http_cache.c
+ * @brief HTTP Response Cache Implementation for ESP32 Weather Station
+ * @details This file implements the response cache. Topic versions are plain
+ *          counters bumped by the publishers; entries are only rendered and
+ *          read on the httpd task, so the bodies need no locking. A body is
+ *          rendered when the version it was rendered at differs from the
+ *          current topic version, and is then sent with httpd_resp_send()
+ *          directly from the entry buffer.
+ *
+ * @author christophermena
+ * @date July 30, 2025
+ * @version 1.0
+ * @note Last Updated: October 16, 2026
+ */
+
+#include <string.h>
+#include "esp_log.h"
+#include "sys/param.h"
+
+#include "http_cache.h"
+#include "sensor_data.h"
+
+// Tag used for ESP serial console messages
+static const char TAG[] = "http_cache";
+
+/**
+ * @brief One cached response
+ */
+struct http_cache_entry
+{
+    const char *name;                   ///< Entry name (points into the caller's static string)
+    http_cache_topic_e topic;           ///< Data the body is rendered from
+    const char *content_type;           ///< Response content type
+    http_cache_render_t render;         ///< Body renderer
+    void *arg;                          ///< Renderer argument
+    bool valid;                         ///< Body holds a rendered response
+    uint32_t version;                   ///< Topic version the body was rendered at
+    uint16_t len;                       ///< Body length
+    uint32_t hits;                      ///< Requests answered from the body
+    uint32_t misses;                    ///< Requests that rendered the body
+    char body[HTTP_CACHE_BODY_MAX];     ///< Rendered body
+};
+
+// Entry table, only appended to during server start
+static http_cache_entry_t g_entries[HTTP_CACHE_MAX_ENTRIES];
+static int g_entry_count = 0;
+
+// Current version of each topic, bumped by the publishers
+static volatile uint32_t g_versions[HTTP_CACHE_TOPIC_COUNT];
+
+// Set once the sample listener is registered
+static bool g_initialized = false;
+
+/**
+ * @brief Sample listener, invalidates the sample responses.
+ * @param sample published sample (rendered again on the next request).
+ */
+static void http_cache_sample_listener(const sensor_sample_t *sample)
+{
+    http_cache_invalidate(HTTP_CACHE_TOPIC_SAMPLE);
+}
+
+void http_cache_init(void)
+{
+    if (g_initialized)
+    {
+        return;
+    }
+    g_initialized = true;
+
+    sensor_data_add_listener(http_cache_sample_listener);
+}
+
+http_cache_entry_t *http_cache_add(const char *name, http_cache_topic_e topic, const char *content_type, http_cache_render_t render, void *arg)
+{
+    for (int i = 0; i < g_entry_count; i++)
+    {
+        if (strcmp(g_entries[i].name, name) == 0)
+        {
+            return &g_entries[i];
+        }
+    }
+    if (g_entry_count >= HTTP_CACHE_MAX_ENTRIES)
+    {
+        ESP_LOGE(TAG, "http_cache_add: entry table full, %s not cached", name);
+        return NULL;
+    }
+
+    http_cache_entry_t *entry = &g_entries[g_entry_count++];
+    entry->name = name;
+    entry->topic = topic;
+    entry->content_type = content_type;
+    entry->render = render;
+    entry->arg = arg;
+    entry->valid = false;
+    return entry;
+}
+
+void http_cache_invalidate(http_cache_topic_e topic)
+{
+    g_versions[topic]++;
+}
+
+esp_err_t http_cache_send(httpd_req_t *req, http_cache_entry_t *entry)
+{
+    if (entry == NULL)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    // Read the version before rendering: a publish during the render leaves the entry stale
+    uint32_t version = g_versions[entry->topic];
+    if (entry->valid && entry->version == version)
+    {
+        entry->hits++;
+    }
+    else
+    {
+        entry->misses++;
+        int len = entry->render(entry->body, sizeof(entry->body), entry->arg);
+        if (len < 0)
+        {
+            entry->valid = false;
+            return ESP_ERR_NOT_FOUND;
+        }
+        entry->len = MIN(len, sizeof(entry->body) - 1);
+        entry->version = version;
+        entry->valid = true;
+    }
+
+    httpd_resp_set_type(req, entry->content_type);
+    return httpd_resp_send(req, entry->body, entry->len);
+}
+
+bool http_cache_get_stats(int index, http_cache_stats_t *stats)
+{
+    if (index < 0 || index >= g_entry_count)
+    {
+        return false;
+    }
+    stats->name = g_entries[index].name;
+    stats->hits = g_entries[index].hits;
+    stats->misses = g_entries[index].misses;
+    stats->size = g_entries[index].valid ? g_entries[index].len : 0;
+    return true;
+}
@@ -0,0 +1,106 @@
+/**
+ * @file http_cache.h
+ * @brief HTTP Response Cache Header for ESP32 Weather Station
+ * @details This header file defines a small cache of rendered response
+ *          bodies for dynamic endpoints. Each entry belongs to a topic (the
+ *          data it is rendered from) and remembers the topic version it was
+ *          rendered at. Publishers bump the topic version when the data
+ *          changes; the next request renders the body once and every later
+ *          request is answered straight from the cached buffer.
+ *
+ * @author christophermena
+ * @date July 30, 2025
+ * @version 1.0
+ * @note Last Updated: October 16, 2026
+ */
+
+#ifndef MAIN_HTTP_CACHE_H_
+#define MAIN_HTTP_CACHE_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "esp_http_server.h"
+
+// HTTP Cache Configuration
+#define HTTP_CACHE_MAX_ENTRIES          6           ///< Cached responses
+#define HTTP_CACHE_BODY_MAX             192         ///< Largest cached body in bytes
+
+/**
+ * @brief Data a cached response is rendered from
+ */
+typedef enum http_cache_topic
+{
+    HTTP_CACHE_TOPIC_SAMPLE = 0,        ///< Latest sensor sample (bumped by every published sample)
+    HTTP_CACHE_TOPIC_OTA,               ///< Firmware update status
+    HTTP_CACHE_TOPIC_SETTINGS,          ///< User settings
+    HTTP_CACHE_TOPIC_COUNT,
+} http_cache_topic_e;
+
+/**
+ * @brief Cached response (opaque)
+ */
+typedef struct http_cache_entry http_cache_entry_t;
+
+/**
+ * @brief Renders a response body
+ * @param buff Destination buffer
+ * @param buff_size Size of the destination buffer (HTTP_CACHE_BODY_MAX)
+ * @param arg Argument given to http_cache_add()
+ * @return Body length, negative if there is nothing to send yet
+ */
+typedef int (*http_cache_render_t)(char *buff, size_t buff_size, void *arg);
+
+/**
+ * @brief Cache statistics of one entry, as exposed at /metrics
+ */
+typedef struct http_cache_stats
+{
+    const char *name;       ///< Entry name
+    uint32_t hits;          ///< Requests answered from the cached body
+    uint32_t misses;        ///< Requests that had to render the body
+    uint16_t size;          ///< Length of the cached body
+} http_cache_stats_t;
+
+/**
+ * @brief Register the sample listener that invalidates HTTP_CACHE_TOPIC_SAMPLE
+ * @note Call once before the HTTP server starts
+ */
+void http_cache_init(void);
+
+/**
+ * @brief Get a cache entry, adding it if needed
+ * @param name Entry name, usually the route (must stay valid, typically a string literal)
+ * @param topic Data the body is rendered from
+ * @param content_type Content type of the response
+ * @param render Function rendering the body
+ * @param arg Argument passed to render()
+ * @return Entry, NULL if the entry table is full
+ */
+http_cache_entry_t *http_cache_add(const char *name, http_cache_topic_e topic, const char *content_type, http_cache_render_t render, void *arg);
+
+/**
+ * @brief Mark every entry of a topic as stale
+ * @param topic Topic whose data changed
+ * @note Safe to call from any task; rendering happens on the next request
+ */
+void http_cache_invalidate(http_cache_topic_e topic);
+
+/**
+ * @brief Send the cached body, rendering it first if it is stale
+ * @param req HTTP request to respond to (headers may be set before the call)
+ * @param entry Entry from http_cache_add()
+ * @return ESP_OK, ESP_ERR_NOT_FOUND if render() had nothing to send (no response sent),
+ *         ESP_ERR_INVALID_ARG for a NULL entry, otherwise the error of httpd_resp_send()
+ * @note Call from the httpd task only; the body is sent straight from the cache buffer
+ */
+esp_err_t http_cache_send(httpd_req_t *req, http_cache_entry_t *entry);
+
+/**
+ * @brief Read the statistics of one entry
+ * @param index Entry index, 0 to the number of entries - 1
+ * @param stats Receives the statistics
+ * @return false if index is out of range
+ */
+bool http_cache_get_stats(int index, http_cache_stats_t *stats);
+
+#endif /* MAIN_HTTP_CACHE_H_ */
@@ -0,0 +1,690 @@
+/**
+ * @file http_metrics.c
+ * @brief HTTP Server Instrumentation Implementation for ESP32 Weather Station
+ * @details This file implements per-route request instrumentation for the HTTP
+ *          server. All state lives in static tables sized at compile time:
+ *          one entry per registered route (counters plus a log2 latency
+ *          histogram) and one entry per lwIP socket (open time, last activity,
+ *          bytes in both directions, requests served and the status code of
+ *          the response in flight). Per-socket send and receive overrides feed
+ *          the socket table, and the handler wrapper attributes it to the
+ *          route. The /metrics handler renders everything in Prometheus text
+ *          format through a small reusable chunk buffer, together with the
+ *          counters of the response cache, the rate limiter and the shared
+ *          I2C bus.
+ *
+ * @author christophermena
+ * @date July 30, 2025
+ * @version 1.0
+ * @note Last Updated: October 16, 2026
+ */
+
+#include <stdarg.h>
+#include <stdlib.h>
+#include "esp_log.h"
+#include "esp_system.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "lwip/sockets.h"
+#include "sys/param.h"
+
+#include "http_cache.h"
+#include "http_metrics.h"
+#include "http_ratelimit.h"
+#include "i2c_bus_stats.h"
+
+// Tag used for ESP serial console messages
+static const char TAG[] = "http_metrics";
+
+// Size of the chunk buffer used to render /metrics
+#define HTTP_METRICS_RENDER_BUFF_SIZE   512
+
+/**
+ * @brief Statistics and original handler of one instrumented route
+ */
+struct http_metrics_route
+{
+    const char *uri;                                ///< Route URI (points into the caller's static string)
+    httpd_method_t method;                          ///< HTTP method of the route
+    esp_err_t (*handler)(httpd_req_t *r);           ///< Original handler (wrapped routes only)
+    void *user_ctx;                                 ///< Original user context (wrapped routes only)
+    uint32_t requests;                              ///< Requests handled
+    uint32_t errors;                                ///< Handler failures and 4xx/5xx responses
+    uint64_t bytes_sent;                            ///< Response bytes including headers
+    uint64_t latency_sum_us;                        ///< Sum of handler latencies
+    uint32_t buckets[HTTP_METRICS_BUCKETS + 1];     ///< Latency histogram, last entry counts overflows
+};
+
+/**
+ * @brief Per-socket accounting fed by the send override
+ */
+typedef struct http_metrics_sock
+{
+    bool open;                  ///< Socket belongs to a live session
+    int64_t opened_us;          ///< esp_timer time the socket was opened
+    int64_t last_active_us;     ///< esp_timer time of the last send or receive
+    uint64_t bytes_sent;        ///< Bytes sent on the socket since it was opened
+    uint64_t bytes_received;    ///< Bytes received on the socket since it was opened
+    uint32_t requests;          ///< Requests served on the socket
+    uint16_t status;            ///< Status code of the current response, 0 until the status line is sent
+    bool awaiting_status;       ///< True while the next send starts a new response
+} http_metrics_sock_t;
+
+// Route table, only appended to during server start
+static http_metrics_route_t g_routes[HTTP_METRICS_MAX_ROUTES];
+static int g_route_count = 0;
+
+// Socket table indexed by (sockfd - LWIP_SOCKET_OFFSET)
+static http_metrics_sock_t g_socks[CONFIG_LWIP_MAX_SOCKETS];
+
+// Hook run before every handler
+static http_metrics_request_hook_t g_request_hook = NULL;
+
+// Session counters: opened, closed for inactivity, most open at the same time
+static uint32_t g_socks_opened = 0;
+static uint32_t g_socks_idle_closed = 0;
+static int g_socks_open = 0;
+static int g_socks_open_max = 0;
+
+// Spinlock guarding the counters against concurrent readers
+static portMUX_TYPE http_metrics_lock = portMUX_INITIALIZER_UNLOCKED;
+
+/**
+ * @brief Maps a socket descriptor to its accounting entry.
+ * @param sockfd socket descriptor.
+ * @return entry or NULL if the descriptor is out of range.
+ */
+static http_metrics_sock_t *http_metrics_get_sock(int sockfd)
+{
+    int index = sockfd - LWIP_SOCKET_OFFSET;
+    if (index < 0 || index >= CONFIG_LWIP_MAX_SOCKETS)
+    {
+        return NULL;
+    }
+    return &g_socks[index];
+}
+
+/**
+ * @brief Maps a latency to its log2 histogram bucket.
+ * @param latency_us latency in microseconds.
+ * @return bucket index, HTTP_METRICS_BUCKETS for latencies beyond the last bucket.
+ */
+static int http_metrics_bucket(uint32_t latency_us)
+{
+    if (latency_us < 128)
+    {
+        return 0;
+    }
+    // floor(log2(latency)) - 6, i.e. bucket i holds [2^(i+6), 2^(i+7))
+    int bucket = (31 - __builtin_clz(latency_us)) - 6;
+    return bucket > HTTP_METRICS_BUCKETS ? HTTP_METRICS_BUCKETS : bucket;
+}
+
+/**
+ * @brief Send override counting the bytes and catching the status line of each response.
+ * Behaves like the default httpd transport (plain send()).
+ */
+static int http_metrics_send(httpd_handle_t hd, int sockfd, const char *buf, size_t buf_len, int flags)
+{
+    if (buf == NULL)
+    {
+        return HTTPD_SOCK_ERR_INVALID;
+    }
+
+    int ret = send(sockfd, buf, buf_len, flags);
+    if (ret < 0)
+    {
+        return (errno == EAGAIN || errno == EINTR || errno == EWOULDBLOCK) ? HTTPD_SOCK_ERR_TIMEOUT : HTTPD_SOCK_ERR_FAIL;
+    }
+
+    http_metrics_sock_t *sock = http_metrics_get_sock(sockfd);
+    if (sock != NULL)
+    {
+        sock->bytes_sent += ret;
+        sock->last_active_us = esp_timer_get_time();
+        // httpd sends the status line at the start of a buffer: "HTTP/1.1 200 OK"
+        if (sock->awaiting_status && ret >= 12 && strncmp(buf, "HTTP/1.", 7) == 0)
+        {
+            sock->status = (uint16_t)atoi(buf + 9);
+            sock->awaiting_status = false;
+        }
+    }
+
+    return ret;
+}
+
+/**
+ * @brief Receive override counting the bytes received and the time of the last activity.
+ * Behaves like the default httpd transport (plain recv()).
+ */
+static int http_metrics_recv(httpd_handle_t hd, int sockfd, char *buf, size_t buf_len, int flags)
+{
+    if (buf == NULL)
+    {
+        return HTTPD_SOCK_ERR_INVALID;
+    }
+
+    int ret = recv(sockfd, buf, buf_len, flags);
+    if (ret < 0)
+    {
+        return (errno == EAGAIN || errno == EINTR || errno == EWOULDBLOCK) ? HTTPD_SOCK_ERR_TIMEOUT : HTTPD_SOCK_ERR_FAIL;
+    }
+
+    http_metrics_sock_t *sock = http_metrics_get_sock(sockfd);
+    if (sock != NULL)
+    {
+        sock->bytes_received += ret;
+        sock->last_active_us = esp_timer_get_time();
+    }
+
+    return ret;
+}
+
+void http_metrics_set_request_hook(http_metrics_request_hook_t hook)
+{
+    g_request_hook = hook;
+}
+
+esp_err_t http_metrics_observe(http_metrics_route_t *route, httpd_req_t *req, http_metrics_call_t call, void *arg)
+{
+    http_metrics_sock_t *sock = http_metrics_get_sock(httpd_req_to_sockfd(req));
+    uint64_t bytes_before = 0;
+
+    // Route table was full when the route was added: serve it uninstrumented
+    if (route == NULL)
+    {
+        return (g_request_hook == NULL || g_request_hook(req)) ? call(req, arg) : ESP_OK;
+    }
+
+    if (sock != NULL)
+    {
+        bytes_before = sock->bytes_sent;
+        sock->requests++;
+        sock->status = 0;
+        sock->awaiting_status = true;
+    }
+
+    int64_t start = esp_timer_get_time();
+    esp_err_t err = (g_request_hook == NULL || g_request_hook(req)) ? call(req, arg) : ESP_OK;
+    uint32_t latency_us = (uint32_t)(esp_timer_get_time() - start);
+
+    bool failed = (err != ESP_OK);
+    uint64_t bytes = 0;
+    if (sock != NULL)
+    {
+        bytes = sock->bytes_sent - bytes_before;
+        failed |= (sock->status >= 400);
+        sock->awaiting_status = false;
+    }
+
+    portENTER_CRITICAL(&http_metrics_lock);
+    route->requests++;
+    route->errors += failed ? 1 : 0;
+    route->bytes_sent += bytes;
+    route->latency_sum_us += latency_us;
+    route->buckets[http_metrics_bucket(latency_us)]++;
+    portEXIT_CRITICAL(&http_metrics_lock);
+
+    return err;
+}
+
+/**
+ * @brief Calls the original handler of a wrapped route.
+ * @param req HTTP request, its user_ctx already restored.
+ * @param arg route entry.
+ * @return result of the original handler.
+ */
+static esp_err_t http_metrics_call_handler(httpd_req_t *req, void *arg)
+{
+    http_metrics_route_t *route = (http_metrics_route_t *)arg;
+
+    return route->handler(req);
+}
+
+/**
+ * @brief Wrapper installed for every route: times the original handler and records its statistics.
+ * @param req HTTP request for which the uri needs to be handled.
+ * @return result of the original handler.
+ */
+static esp_err_t http_metrics_route_handler(httpd_req_t *req)
+{
+    http_metrics_route_t *route = (http_metrics_route_t *)req->user_ctx;
+
+    // Hand the original context to the handler
+    req->user_ctx = route->user_ctx;
+
+    return http_metrics_observe(route, req, http_metrics_call_handler, route);
+}
+
+http_metrics_route_t *http_metrics_add_route(const char *uri, httpd_method_t method)
+{
+    // Re-registering after a server restart reuses the existing entry and keeps its counters
+    for (int i = 0; i < g_route_count; i++)
+    {
+        if (g_routes[i].method == method && strcmp(g_routes[i].uri, uri) == 0)
+        {
+            return &g_routes[i];
+        }
+    }
+    if (g_route_count >= HTTP_METRICS_MAX_ROUTES)
+    {
+        ESP_LOGE(TAG, "http_metrics_add_route: route table full, %s not instrumented", uri);
+        return NULL;
+    }
+
+    http_metrics_route_t *route = &g_routes[g_route_count++];
+    route->uri = uri;
+    route->method = method;
+    return route;
+}
+
+esp_err_t http_metrics_register_uri_handler(httpd_handle_t handle, const httpd_uri_t *uri_handler)
+{
+    http_metrics_route_t *route = http_metrics_add_route(uri_handler->uri, uri_handler->method);
+    if (route == NULL)
+    {
+        return ESP_ERR_NO_MEM;
+    }
+    route->handler = uri_handler->handler;
+    route->user_ctx = uri_handler->user_ctx;
+
+    httpd_uri_t wrapped = *uri_handler;
+    wrapped.handler = http_metrics_route_handler;
+    wrapped.user_ctx = route;
+
+    return httpd_register_uri_handler(handle, &wrapped);
+}
+
+void http_metrics_sock_open(httpd_handle_t hd, int sockfd)
+{
+    http_metrics_sock_t *sock = http_metrics_get_sock(sockfd);
+    if (sock != NULL)
+    {
+        memset(sock, 0, sizeof(*sock));
+        sock->open = true;
+        sock->opened_us = esp_timer_get_time();
+        sock->last_active_us = sock->opened_us;
+    }
+    httpd_sess_set_send_override(hd, sockfd, http_metrics_send);
+    httpd_sess_set_recv_override(hd, sockfd, http_metrics_recv);
+
+    g_socks_opened++;
+    g_socks_open++;
+    g_socks_open_max = MAX(g_socks_open_max, g_socks_open);
+}
+
+void http_metrics_sock_close(int sockfd)
+{
+    http_metrics_sock_t *sock = http_metrics_get_sock(sockfd);
+    if (sock != NULL)
+    {
+        sock->open = false;
+        sock->awaiting_status = false;
+    }
+    g_socks_open--;
+}
+
+void http_metrics_sock_expire(int sockfd)
+{
+    g_socks_idle_closed++;
+}
+
+bool http_metrics_get_sock_stats(int sockfd, http_metrics_sock_stats_t *stats)
+{
+    http_metrics_sock_t *sock = http_metrics_get_sock(sockfd);
+    if (sock == NULL || !sock->open)
+    {
+        return false;
+    }
+    stats->opened_us = sock->opened_us;
+    stats->last_active_us = sock->last_active_us;
+    stats->bytes_sent = sock->bytes_sent;
+    stats->bytes_received = sock->bytes_received;
+    stats->requests = sock->requests;
+    return true;
+}
+
+/**
+ * @brief Render state of the /metrics response
+ */
+typedef struct http_metrics_render
+{
+    httpd_req_t *req;                               ///< Request being answered
+    size_t len;                                     ///< Bytes used in buff
+    esp_err_t err;                                  ///< First send error
+    char buff[HTTP_METRICS_RENDER_BUFF_SIZE];       ///< Chunk buffer
+} http_metrics_render_t;
+
+/**
+ * @brief Appends formatted text to the render buffer, flushing it as a chunk when full.
+ * @param render render state.
+ * @param fmt printf style format.
+ */
+static void http_metrics_printf(http_metrics_render_t *render, const char *fmt, ...)
+{
+    va_list args;
+
+    for (int attempt = 0; attempt < 2 && render->err == ESP_OK; attempt++)
+    {
+        va_start(args, fmt);
+        int len = vsnprintf(render->buff + render->len, sizeof(render->buff) - render->len, fmt, args);
+        va_end(args);
+
+        if (len >= 0 && render->len + len < sizeof(render->buff))
+        {
+            render->len += len;
+            return;
+        }
+        // Did not fit, send what we have and retry on an empty buffer
+        render->err = httpd_resp_send_chunk(render->req, render->buff, render->len);
+        render->len = 0;
+    }
+}
+
+/**
+ * @brief Returns the method name used as label value.
+ * @param method HTTP method.
+ * @return method name.
+ */
+static const char *http_metrics_method_name(httpd_method_t method)
+{
+    switch ((int)method)
+    {
+    case HTTP_GET:      return "GET";
+    case HTTP_POST:     return "POST";
+    case HTTP_PUT:      return "PUT";
+    case HTTP_DELETE:   return "DELETE";
+    default:            return "OTHER";
+    }
+}
+
+/**
+ * @brief Returns the priority name used as label value.
+ * @param priority I2C bus priority of a device.
+ * @return priority name.
+ */
+static const char *http_metrics_i2c_priority_name(i2c_bus_priority_e priority)
+{
+    return priority == I2C_BUS_PRIORITY_SENSOR ? "sensor" : "display";
+}
+
+/**
+ * @brief Estimates a latency quantile as the upper bound of the bucket holding the quantile rank.
+ * @param route route snapshot.
+ * @param quantile quantile in percent (e.g. 99).
+ * @return latency in seconds, +Inf represented as the last bucket bound times two.
+ */
+static double http_metrics_quantile(const http_metrics_route_t *route, uint32_t quantile)
+{
+    uint32_t rank = (route->requests * quantile + 99) / 100;
+    uint32_t cumulative = 0;
+
+    for (int i = 0; i <= HTTP_METRICS_BUCKETS; i++)
+    {
+        cumulative += route->buckets[i];
+        if (cumulative >= rank)
+        {
+            return (double)(1u << (i + 7)) / 1e6;
+        }
+    }
+    return (double)(1u << (HTTP_METRICS_BUCKETS + 7)) / 1e6;
+}
+
+/**
+ * @brief Takes a consistent snapshot of one route's counters.
+ * @param index route index, below g_route_count.
+ * @param route receives the snapshot.
+ */
+static void http_metrics_get_route(int index, http_metrics_route_t *route)
+{
+    portENTER_CRITICAL(&http_metrics_lock);
+    *route = g_routes[index];
+    portEXIT_CRITICAL(&http_metrics_lock);
+}
+
+esp_err_t http_metrics_handler(httpd_req_t *req)
+{
+    static const uint32_t quantiles[] = { 50, 90, 99 };
+    http_metrics_render_t *render = malloc(sizeof(http_metrics_render_t));
+    http_metrics_route_t route;
+
+    if (render == NULL)
+    {
+        httpd_resp_send_500(req);
+        return ESP_OK;
+    }
+    render->req = req;
+    render->len = 0;
+    render->err = ESP_OK;
+
+    httpd_resp_set_type(req, "text/plain; version=0.0.4");
+
+    // Every family is one contiguous group under its HELP/TYPE lines, as the text format requires
+    http_metrics_printf(render, "# HELP http_requests_total Requests handled per route.\n# TYPE http_requests_total counter\n");
+    for (int i = 0; i < g_route_count; i++)
+    {
+        http_metrics_get_route(i, &route);
+        http_metrics_printf(render, "http_requests_total{route=\"%s\",method=\"%s\"} %lu\n",
+                            route.uri, http_metrics_method_name(route.method), route.requests);
+    }
+
+    http_metrics_printf(render, "# HELP http_request_errors_total Handler failures and 4xx/5xx responses per route.\n# TYPE http_request_errors_total counter\n");
+    for (int i = 0; i < g_route_count; i++)
+    {
+        http_metrics_get_route(i, &route);
+        http_metrics_printf(render, "http_request_errors_total{route=\"%s\",method=\"%s\"} %lu\n",
+                            route.uri, http_metrics_method_name(route.method), route.errors);
+    }
+
+    http_metrics_printf(render, "# HELP http_response_bytes_total Response bytes sent per route.\n# TYPE http_response_bytes_total counter\n");
+    for (int i = 0; i < g_route_count; i++)
+    {
+        http_metrics_get_route(i, &route);
+        http_metrics_printf(render, "http_response_bytes_total{route=\"%s\",method=\"%s\"} %llu\n",
+                            route.uri, http_metrics_method_name(route.method), route.bytes_sent);
+    }
+
+    http_metrics_printf(render, "# HELP http_request_duration_seconds Handler latency per route.\n# TYPE http_request_duration_seconds histogram\n");
+    for (int i = 0; i < g_route_count; i++)
+    {
+        http_metrics_get_route(i, &route);
+
+        const char *method = http_metrics_method_name(route.method);
+        uint32_t cumulative = 0;
+        for (int b = 0; b < HTTP_METRICS_BUCKETS; b++)
+        {
+            cumulative += route.buckets[b];
+            http_metrics_printf(render, "http_request_duration_seconds_bucket{route=\"%s\",method=\"%s\",le=\"%g\"} %lu\n",
+                                route.uri, method, (double)(1u << (b + 7)) / 1e6, cumulative);
+        }
+        http_metrics_printf(render, "http_request_duration_seconds_bucket{route=\"%s\",method=\"%s\",le=\"+Inf\"} %lu\n", route.uri, method, route.requests);
+        http_metrics_printf(render, "http_request_duration_seconds_sum{route=\"%s\",method=\"%s\"} %.6f\n", route.uri, method, (double)route.latency_sum_us / 1e6);
+        http_metrics_printf(render, "http_request_duration_seconds_count{route=\"%s\",method=\"%s\"} %lu\n", route.uri, method, route.requests);
+    }
+
+    http_metrics_printf(render, "# HELP http_request_latency_seconds Latency quantiles estimated from the histogram buckets.\n# TYPE http_request_latency_seconds gauge\n");
+    for (int i = 0; i < g_route_count; i++)
+    {
+        http_metrics_get_route(i, &route);
+        if (route.requests == 0)
+        {
+            continue;
+        }
+        for (size_t q = 0; q < sizeof(quantiles) / sizeof(quantiles[0]); q++)
+        {
+            http_metrics_printf(render, "http_request_latency_seconds{route=\"%s\",method=\"%s\",quantile=\"0.%lu\"} %g\n",
+                                route.uri, http_metrics_method_name(route.method), quantiles[q], http_metrics_quantile(&route, quantiles[q]));
+        }
+    }
+
+    http_cache_stats_t cache;
+    http_metrics_printf(render, "# HELP http_cache_hits_total Requests answered from a cached body.\n# TYPE http_cache_hits_total counter\n");
+    for (int i = 0; http_cache_get_stats(i, &cache); i++)
+    {
+        http_metrics_printf(render, "http_cache_hits_total{entry=\"%s\"} %lu\n", cache.name, cache.hits);
+    }
+    http_metrics_printf(render, "# HELP http_cache_misses_total Requests that rendered the body.\n# TYPE http_cache_misses_total counter\n");
+    for (int i = 0; http_cache_get_stats(i, &cache); i++)
+    {
+        http_metrics_printf(render, "http_cache_misses_total{entry=\"%s\"} %lu\n", cache.name, cache.misses);
+    }
+    http_metrics_printf(render, "# HELP http_cache_hit_ratio Share of requests answered from the cache.\n# TYPE http_cache_hit_ratio gauge\n");
+    for (int i = 0; http_cache_get_stats(i, &cache); i++)
+    {
+        uint32_t lookups = cache.hits + cache.misses;
+        http_metrics_printf(render, "http_cache_hit_ratio{entry=\"%s\"} %g\n", cache.name, lookups ? (double)cache.hits / lookups : 0.0);
+    }
+    http_metrics_printf(render, "# HELP http_cache_body_bytes Size of the cached body.\n# TYPE http_cache_body_bytes gauge\n");
+    for (int i = 0; http_cache_get_stats(i, &cache); i++)
+    {
+        http_metrics_printf(render, "http_cache_body_bytes{entry=\"%s\"} %u\n", cache.name, cache.size);
+    }
+
+    http_ratelimit_stats_t client;
+    http_metrics_printf(render, "# HELP http_ratelimit_throttled_total Requests answered with 429.\n# TYPE http_ratelimit_throttled_total counter\nhttp_ratelimit_throttled_total %lu\n", http_ratelimit_get_throttled());
+    http_metrics_printf(render, "# HELP http_ratelimit_evictions_total Tracked clients replaced by another client.\n# TYPE http_ratelimit_evictions_total counter\nhttp_ratelimit_evictions_total %lu\n", http_ratelimit_get_evictions());
+    http_metrics_printf(render, "# HELP http_ratelimit_client_throttled Requests answered with 429 per tracked client.\n# TYPE http_ratelimit_client_throttled gauge\n");
+    for (int i = 0; i < HTTP_RATELIMIT_SLOTS; i++)
+    {
+        if (http_ratelimit_get_stats(i, &client))
+        {
+            const uint8_t *ip = (const uint8_t *)&client.ip;
+            http_metrics_printf(render, "http_ratelimit_client_throttled{client=\"%u.%u.%u.%u\"} %lu\n", ip[0], ip[1], ip[2], ip[3], client.throttled);
+        }
+    }
+    http_metrics_printf(render, "# HELP http_ratelimit_client_allowed Requests let through per tracked client.\n# TYPE http_ratelimit_client_allowed gauge\n");
+    for (int i = 0; i < HTTP_RATELIMIT_SLOTS; i++)
+    {
+        if (http_ratelimit_get_stats(i, &client))
+        {
+            const uint8_t *ip = (const uint8_t *)&client.ip;
+            http_metrics_printf(render, "http_ratelimit_client_allowed{client=\"%u.%u.%u.%u\"} %lu\n", ip[0], ip[1], ip[2], ip[3], client.allowed);
+        }
+    }
+
+    i2c_bus_stats_t devs[I2C_BUS_MAX_DEVICES];
+    bool dev_valid[I2C_BUS_MAX_DEVICES];
+    for (int i = 0; i < I2C_BUS_MAX_DEVICES; i++)
+    {
+        // One snapshot for all families, so they agree with each other
+        dev_valid[i] = i2c_bus_get_stats(i, &devs[i]);
+    }
+    http_metrics_printf(render, "# HELP i2c_bus_busy_seconds_total Time the I2C bus was busy, all devices.\n# TYPE i2c_bus_busy_seconds_total counter\ni2c_bus_busy_seconds_total %.6f\n", (double)i2c_bus_get_busy_us() / 1e6);
+    http_metrics_printf(render, "# HELP i2c_device_transactions_total I2C transactions per device.\n# TYPE i2c_device_transactions_total counter\n");
+    for (int i = 0; i < I2C_BUS_MAX_DEVICES; i++)
+    {
+        if (dev_valid[i])
+        {
+            http_metrics_printf(render, "i2c_device_transactions_total{address=\"0x%02X\",priority=\"%s\"} %lu\n",
+                                devs[i].address, http_metrics_i2c_priority_name(devs[i].priority), devs[i].transactions);
+        }
+    }
+    http_metrics_printf(render, "# HELP i2c_device_errors_total Failed I2C transactions per device.\n# TYPE i2c_device_errors_total counter\n");
+    for (int i = 0; i < I2C_BUS_MAX_DEVICES; i++)
+    {
+        if (dev_valid[i])
+        {
+            http_metrics_printf(render, "i2c_device_errors_total{address=\"0x%02X\",priority=\"%s\"} %lu\n",
+                                devs[i].address, http_metrics_i2c_priority_name(devs[i].priority), devs[i].errors);
+        }
+    }
+    http_metrics_printf(render, "# HELP i2c_device_bytes_total Bytes written and read per device.\n# TYPE i2c_device_bytes_total counter\n");
+    for (int i = 0; i < I2C_BUS_MAX_DEVICES; i++)
+    {
+        if (dev_valid[i])
+        {
+            http_metrics_printf(render, "i2c_device_bytes_total{address=\"0x%02X\",priority=\"%s\"} %llu\n",
+                                devs[i].address, http_metrics_i2c_priority_name(devs[i].priority), devs[i].bytes);
+        }
+    }
+    http_metrics_printf(render, "# HELP i2c_device_busy_seconds_total Bus time per device.\n# TYPE i2c_device_busy_seconds_total counter\n");
+    for (int i = 0; i < I2C_BUS_MAX_DEVICES; i++)
+    {
+        if (dev_valid[i])
+        {
+            http_metrics_printf(render, "i2c_device_busy_seconds_total{address=\"0x%02X\",priority=\"%s\"} %.6f\n",
+                                devs[i].address, http_metrics_i2c_priority_name(devs[i].priority), (double)devs[i].busy_us / 1e6);
+        }
+    }
+    http_metrics_printf(render, "# HELP i2c_device_wait_seconds_total Time transactions waited for the bus per device.\n# TYPE i2c_device_wait_seconds_total counter\n");
+    for (int i = 0; i < I2C_BUS_MAX_DEVICES; i++)
+    {
+        if (dev_valid[i])
+        {
+            http_metrics_printf(render, "i2c_device_wait_seconds_total{address=\"0x%02X\",priority=\"%s\"} %.6f\n",
+                                devs[i].address, http_metrics_i2c_priority_name(devs[i].priority), (double)devs[i].wait_us / 1e6);
+        }
+    }
+    http_metrics_printf(render, "# HELP i2c_device_wait_max_seconds Longest wait for the bus per device.\n# TYPE i2c_device_wait_max_seconds gauge\n");
+    for (int i = 0; i < I2C_BUS_MAX_DEVICES; i++)
+    {
+        if (dev_valid[i])
+        {
+            http_metrics_printf(render, "i2c_device_wait_max_seconds{address=\"0x%02X\",priority=\"%s\"} %.6f\n",
+                                devs[i].address, http_metrics_i2c_priority_name(devs[i].priority), (double)devs[i].wait_max_us / 1e6);
+        }
+    }
+
+    int64_t now = esp_timer_get_time();
+    http_metrics_printf(render, "# HELP http_sockets_opened_total Client sessions opened.\n# TYPE http_sockets_opened_total counter\nhttp_sockets_opened_total %lu\n", g_socks_opened);
+    http_metrics_printf(render, "# HELP http_sockets_idle_closed_total Sessions closed for inactivity.\n# TYPE http_sockets_idle_closed_total counter\nhttp_sockets_idle_closed_total %lu\n", g_socks_idle_closed);
+    http_metrics_printf(render, "# HELP http_sockets_open Open client sessions.\n# TYPE http_sockets_open gauge\nhttp_sockets_open %d\n", g_socks_open);
+    http_metrics_printf(render, "# HELP http_sockets_open_max Most client sessions open at the same time.\n# TYPE http_sockets_open_max gauge\nhttp_sockets_open_max %d\n", g_socks_open_max);
+    http_metrics_printf(render, "# HELP http_socket_open_seconds Age of each open client socket.\n# TYPE http_socket_open_seconds gauge\n");
+    for (int i = 0; i < CONFIG_LWIP_MAX_SOCKETS; i++)
+    {
+        if (g_socks[i].open)
+        {
+            http_metrics_printf(render, "http_socket_open_seconds{fd=\"%d\"} %.1f\n", i + LWIP_SOCKET_OFFSET, (double)(now - g_socks[i].opened_us) / 1e6);
+        }
+    }
+    http_metrics_printf(render, "# HELP http_socket_idle_seconds Time since the last send or receive on each open socket.\n# TYPE http_socket_idle_seconds gauge\n");
+    for (int i = 0; i < CONFIG_LWIP_MAX_SOCKETS; i++)
+    {
+        if (g_socks[i].open)
+        {
+            http_metrics_printf(render, "http_socket_idle_seconds{fd=\"%d\"} %.1f\n", i + LWIP_SOCKET_OFFSET, (double)(now - g_socks[i].last_active_us) / 1e6);
+        }
+    }
+    http_metrics_printf(render, "# HELP http_socket_requests Requests served on each open socket.\n# TYPE http_socket_requests gauge\n");
+    for (int i = 0; i < CONFIG_LWIP_MAX_SOCKETS; i++)
+    {
+        if (g_socks[i].open)
+        {
+            http_metrics_printf(render, "http_socket_requests{fd=\"%d\"} %lu\n", i + LWIP_SOCKET_OFFSET, g_socks[i].requests);
+        }
+    }
+    http_metrics_printf(render, "# HELP http_socket_sent_bytes Bytes sent on each open socket.\n# TYPE http_socket_sent_bytes gauge\n");
+    for (int i = 0; i < CONFIG_LWIP_MAX_SOCKETS; i++)
+    {
+        if (g_socks[i].open)
+        {
+            http_metrics_printf(render, "http_socket_sent_bytes{fd=\"%d\"} %llu\n", i + LWIP_SOCKET_OFFSET, g_socks[i].bytes_sent);
+        }
+    }
+    http_metrics_printf(render, "# HELP http_socket_received_bytes Bytes received on each open socket.\n# TYPE http_socket_received_bytes gauge\n");
+    for (int i = 0; i < CONFIG_LWIP_MAX_SOCKETS; i++)
+    {
+        if (g_socks[i].open)
+        {
+            http_metrics_printf(render, "http_socket_received_bytes{fd=\"%d\"} %llu\n", i + LWIP_SOCKET_OFFSET, g_socks[i].bytes_received);
+        }
+    }
+
+    http_metrics_printf(render, "# HELP process_uptime_seconds Time since boot.\n# TYPE process_uptime_seconds gauge\nprocess_uptime_seconds %lld\n", esp_timer_get_time() / 1000000);
+    http_metrics_printf(render, "# HELP heap_free_bytes Free heap.\n# TYPE heap_free_bytes gauge\nheap_free_bytes %lu\n", esp_get_free_heap_size());
+    http_metrics_printf(render, "# HELP heap_min_free_bytes Lowest free heap since boot.\n# TYPE heap_min_free_bytes gauge\nheap_min_free_bytes %lu\n", esp_get_minimum_free_heap_size());
+
+    if (render->err == ESP_OK && render->len > 0)
+    {
+        render->err = httpd_resp_send_chunk(req, render->buff, render->len);
+    }
+    if (render->err == ESP_OK)
+    {
+        render->err = httpd_resp_send_chunk(req, NULL, 0);
+    }
+
+    esp_err_t err = render->err;
+    free(render);
+    return err == ESP_OK ? ESP_OK : ESP_FAIL;
+}
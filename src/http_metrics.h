@@ -0,0 +1,144 @@
+/**
+ * @file http_metrics.h
+ * @brief HTTP Server Instrumentation Header for ESP32 Weather Station
+ * @details This header file defines the fixed-memory instrumentation layer of
+ *          the HTTP server. Every URI handler is registered through this layer,
+ *          which wraps it to record request count, bytes sent, errors and a
+ *          log-bucketed latency histogram per route. The collected data is
+ *          exposed at /metrics in Prometheus text format.
+ *
+ * @author christophermena
+ * @date July 30, 2025
+ * @version 1.0
+ * @note Last Updated: October 16, 2026
+ */
+
+#ifndef MAIN_HTTP_METRICS_H_
+#define MAIN_HTTP_METRICS_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "esp_http_server.h"
+
+// HTTP Metrics Configuration
+#define HTTP_METRICS_MAX_ROUTES         32          ///< Maximum number of instrumented routes
+#define HTTP_METRICS_BUCKETS            16          ///< Latency buckets, bucket i ends at 2^(i+7) us (128 us ... 4.2 s)
+
+/**
+ * @brief Statistics entry of one route (opaque)
+ */
+typedef struct http_metrics_route http_metrics_route_t;
+
+/**
+ * @brief Request processing function timed by http_metrics_observe()
+ */
+typedef esp_err_t (*http_metrics_call_t)(httpd_req_t *req, void *arg);
+
+/**
+ * @brief Hook run before every instrumented handler
+ * @param req HTTP request, not yet answered
+ * @return true to dispatch the request, false if the hook answered it itself
+ */
+typedef bool (*http_metrics_request_hook_t)(httpd_req_t *req);
+
+/**
+ * @brief Statistics of one open client socket
+ */
+typedef struct http_metrics_sock_stats
+{
+    int64_t opened_us;          ///< esp_timer time the socket was opened
+    int64_t last_active_us;     ///< esp_timer time of the last send or receive
+    uint64_t bytes_sent;        ///< Bytes sent since the socket was opened
+    uint64_t bytes_received;    ///< Bytes received since the socket was opened
+    uint32_t requests;          ///< Requests served on the socket
+} http_metrics_sock_stats_t;
+
+/**
+ * @brief Register a URI handler wrapped with instrumentation
+ *
+ * Drop-in replacement for httpd_register_uri_handler(). The original handler
+ * and user context are kept in a static route table; the server sees a
+ * wrapper that times the handler and attributes sent bytes and errors to it.
+ *
+ * @param handle HTTP server handle
+ * @param uri_handler URI handler description (copied)
+ * @return ESP_OK on success, ESP_ERR_NO_MEM if the route table is full,
+ *         otherwise the error of httpd_register_uri_handler()
+ */
+esp_err_t http_metrics_register_uri_handler(httpd_handle_t handle, const httpd_uri_t *uri_handler);
+
+/**
+ * @brief Get the statistics entry of a route, adding it if needed
+ *
+ * For request dispatchers that serve several routes behind one httpd
+ * registration (see http_router.c) and record each route themselves.
+ *
+ * @param uri Route pattern (must stay valid, typically a string literal)
+ * @param method HTTP method of the route
+ * @return Route entry, NULL if the route table is full
+ */
+http_metrics_route_t *http_metrics_add_route(const char *uri, httpd_method_t method);
+
+/**
+ * @brief Install the request hook
+ *
+ * The hook sees every request of every instrumented route before its
+ * handler, e.g. to reject it early (rate limiting). A request the hook
+ * answers is recorded for its route like any other.
+ *
+ * @param hook Hook, NULL to remove it
+ */
+void http_metrics_set_request_hook(http_metrics_request_hook_t hook);
+
+/**
+ * @brief Run a request through call() and record it for the route
+ * @param route Route entry from http_metrics_add_route(), NULL to only call call()
+ * @param req HTTP request
+ * @param call Function processing the request
+ * @param arg Argument passed to call()
+ * @return Result of call()
+ */
+esp_err_t http_metrics_observe(http_metrics_route_t *route, httpd_req_t *req, http_metrics_call_t call, void *arg);
+
+/**
+ * @brief Track a newly opened client socket
+ *
+ * Installs send and receive overrides on the socket so traffic, activity
+ * and the response status line can be attributed to the socket and to the
+ * route being served.
+ *
+ * @param hd HTTP server handle
+ * @param sockfd Socket descriptor of the new session
+ * @note Call from the httpd open_fn callback
+ */
+void http_metrics_sock_open(httpd_handle_t hd, int sockfd);
+
+/**
+ * @brief Stop tracking a client socket
+ * @param sockfd Socket descriptor of the closing session
+ * @note Call from the httpd close_fn callback
+ */
+void http_metrics_sock_close(int sockfd);
+
+/**
+ * @brief Count a session that is being closed for inactivity
+ * @param sockfd Socket descriptor of the session
+ */
+void http_metrics_sock_expire(int sockfd);
+
+/**
+ * @brief Read the statistics of an open client socket
+ * @param sockfd Socket descriptor
+ * @param stats Receives the statistics
+ * @return false if the socket is not tracked (closed or out of range)
+ */
+bool http_metrics_get_sock_stats(int sockfd, http_metrics_sock_stats_t *stats);
+
+/**
+ * @brief /metrics handler, renders all counters in Prometheus text format
+ * @param req HTTP request to respond to
+ * @return ESP_OK, otherwise ESP_FAIL if sending failed
+ */
+esp_err_t http_metrics_handler(httpd_req_t *req);
+
+#endif /* MAIN_HTTP_METRICS_H_ */
@@ -0,0 +1,215 @@
+/**
+ * @file http_ratelimit.c
+ * @brief HTTP Rate Limiter Implementation for ESP32 Weather Station
+ * @details This file implements the per-client token buckets. Clients are
+ *          keyed by their IPv4 address (IPv4-mapped IPv6 peers included) and
+ *          hashed into a fixed table; a lookup probes at most
+ *          HTTP_RATELIMIT_PROBE slots and, when the client is not found and
+ *          no slot is free, takes over the slot used least recently. Tokens
+ *          are kept in thousandths so slow refill rates do not round to zero.
+ *          The buckets are only touched on the httpd task, so they need no
+ *          locking.
+ *
+ * @author christophermena
+ * @date July 30, 2025
+ * @version 1.0
+ * @note Last Updated: October 16, 2026
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "lwip/sockets.h"
+#include "sys/param.h"
+
+#include "http_ratelimit.h"
+
+// Tag used for ESP serial console messages
+static const char TAG[] = "http_ratelimit";
+
+// One token in bucket units
+#define HTTP_RATELIMIT_TOKEN            1000
+
+/**
+ * @brief Token bucket of one client
+ */
+typedef struct http_ratelimit_slot
+{
+    bool used;                  ///< Slot holds a client
+    uint32_t ip;                ///< Client address (network byte order)
+    uint32_t tokens;            ///< Tokens in thousandths
+    int64_t last_us;            ///< esp_timer time of the last refill
+    uint32_t allowed;           ///< Requests let through
+    uint32_t throttled;         ///< Requests answered with 429
+} http_ratelimit_slot_t;
+
+// Bucket table
+static http_ratelimit_slot_t g_slots[HTTP_RATELIMIT_SLOTS];
+
+// Bucket parameters
+static uint16_t g_rate = HTTP_RATELIMIT_DEFAULT_RATE;
+static uint16_t g_burst = HTTP_RATELIMIT_DEFAULT_BURST;
+
+// Totals since boot
+static uint32_t g_throttled = 0;
+static uint32_t g_evictions = 0;
+
+/**
+ * @brief Gets the address of the client that sent a request.
+ * @param req HTTP request.
+ * @param ip receives the IPv4 address (network byte order), or a fold of the IPv6 address.
+ * @return false if the peer address is unavailable.
+ */
+static bool http_ratelimit_client_ip(httpd_req_t *req, uint32_t *ip)
+{
+    struct sockaddr_storage addr;
+    socklen_t len = sizeof(addr);
+
+    if (getpeername(httpd_req_to_sockfd(req), (struct sockaddr *)&addr, &len) != 0)
+    {
+        return false;
+    }
+    if (addr.ss_family == AF_INET)
+    {
+        *ip = ((struct sockaddr_in *)&addr)->sin_addr.s_addr;
+        return true;
+    }
+    if (addr.ss_family == AF_INET6)
+    {
+        uint32_t words[4];
+        memcpy(words, &((struct sockaddr_in6 *)&addr)->sin6_addr, sizeof(words));
+        // httpd listens on IPv6, IPv4 clients arrive as ::ffff:a.b.c.d
+        bool mapped = words[0] == 0 && words[1] == 0 && words[2] == htonl(0xffff);
+        *ip = mapped ? words[3] : (words[0] ^ words[1] ^ words[2] ^ words[3]);
+        return true;
+    }
+    return false;
+}
+
+/**
+ * @brief Finds the slot of a client, taking over a free or the least recently used probed slot if needed.
+ * @param ip client address.
+ * @param now current esp_timer time.
+ * @return slot of the client.
+ */
+static http_ratelimit_slot_t *http_ratelimit_lookup(uint32_t ip, int64_t now)
+{
+    // Fibonacci hashing: only the top bits of the product depend on every address byte
+    uint32_t start = (ntohl(ip) * 2654435761u) >> (32 - HTTP_RATELIMIT_SLOT_BITS);
+    http_ratelimit_slot_t *victim = NULL;
+
+    for (int p = 0; p < HTTP_RATELIMIT_PROBE; p++)
+    {
+        http_ratelimit_slot_t *slot = &g_slots[(start + p) & (HTTP_RATELIMIT_SLOTS - 1)];
+        if (slot->used && slot->ip == ip)
+        {
+            return slot;
+        }
+        if (victim == NULL || (victim->used && (!slot->used || slot->last_us < victim->last_us)))
+        {
+            victim = slot;
+        }
+    }
+
+    if (victim->used)
+    {
+        g_evictions++;
+    }
+    victim->used = true;
+    victim->ip = ip;
+    victim->tokens = (uint32_t)g_burst * HTTP_RATELIMIT_TOKEN;
+    victim->last_us = now;
+    victim->allowed = 0;
+    victim->throttled = 0;
+    return victim;
+}
+
+void http_ratelimit_configure(uint16_t rate, uint16_t burst)
+{
+    g_rate = rate;
+    g_burst = (rate > 0 && burst == 0) ? 1 : burst;
+    ESP_LOGI(TAG, "http_ratelimit_configure: %u requests/s, burst %u", g_rate, g_burst);
+}
+
+/**
+ * @brief Takes a token from the bucket of the client of a request.
+ * @param req HTTP request.
+ * @return 0 if a token was taken, otherwise the milliseconds until the next token.
+ */
+static uint32_t http_ratelimit_take(httpd_req_t *req)
+{
+    uint32_t ip;
+
+    if (g_rate == 0 || !http_ratelimit_client_ip(req, &ip))
+    {
+        return 0;
+    }
+
+    int64_t now = esp_timer_get_time();
+    http_ratelimit_slot_t *slot = http_ratelimit_lookup(ip, now);
+
+    // Refill: rate tokens per second is rate thousandths per millisecond
+    uint64_t refill = (uint64_t)(now - slot->last_us) * g_rate / 1000;
+    uint64_t capacity = (uint64_t)g_burst * HTTP_RATELIMIT_TOKEN;
+    slot->tokens = (uint32_t)MIN(slot->tokens + refill, capacity);
+    slot->last_us = now;
+
+    if (slot->tokens >= HTTP_RATELIMIT_TOKEN)
+    {
+        slot->tokens -= HTTP_RATELIMIT_TOKEN;
+        slot->allowed++;
+        return 0;
+    }
+
+    slot->throttled++;
+    g_throttled++;
+
+    return MAX((HTTP_RATELIMIT_TOKEN - slot->tokens + g_rate - 1) / g_rate, 1);
+}
+
+bool http_ratelimit_check(httpd_req_t *req)
+{
+    uint32_t wait_ms = http_ratelimit_take(req);
+
+    if (wait_ms == 0)
+    {
+        return true;
+    }
+
+    // Whole seconds until the next token, at least 1
+    char retry_after[12];
+    snprintf(retry_after, sizeof(retry_after), "%lu", (unsigned long)MAX((wait_ms + 999) / 1000, 1));
+
+    httpd_resp_set_status(req, "429 Too Many Requests");
+    httpd_resp_set_hdr(req, "Retry-After", retry_after);
+    httpd_resp_sendstr(req, "Too many requests");
+    return false;
+}
+
+bool http_ratelimit_allow(httpd_req_t *req)
+{
+    return http_ratelimit_take(req) == 0;
+}
+
+uint32_t http_ratelimit_get_throttled(void)
+{
+    return g_throttled;
+}
+
+uint32_t http_ratelimit_get_evictions(void)
+{
+    return g_evictions;
+}
+
+bool http_ratelimit_get_stats(int index, http_ratelimit_stats_t *stats)
+{
+    if (index < 0 || index >= HTTP_RATELIMIT_SLOTS || !g_slots[index].used)
+    {
+        return false;
+    }
+    stats->ip = g_slots[index].ip;
+    stats->allowed = g_slots[index].allowed;
+    stats->throttled = g_slots[index].throttled;
+    return true;
+}
@@ -0,0 +1,94 @@
+/**
+ * @file http_ratelimit.h
+ * @brief HTTP Rate Limiter Header for ESP32 Weather Station
+ * @details This header file defines a per-client token-bucket rate limiter.
+ *          Each client IP owns a bucket that refills at a steady rate up to a
+ *          burst size; every request takes one token, and a request finding
+ *          the bucket empty is answered with 429 Too Many Requests and a
+ *          Retry-After header before its handler runs. The buckets live in a
+ *          small fixed table (open addressing over a bounded probe window),
+ *          so memory is constant and a lookup touches at most a few slots.
+ *
+ * @author christophermena
+ * @date July 30, 2025
+ * @version 1.0
+ * @note Last Updated: October 16, 2026
+ */
+
+#ifndef MAIN_HTTP_RATELIMIT_H_
+#define MAIN_HTTP_RATELIMIT_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "esp_http_server.h"
+
+// HTTP Rate Limiter Configuration
+#define HTTP_RATELIMIT_SLOT_BITS        5           ///< log2 of the tracked clients
+#define HTTP_RATELIMIT_SLOTS            (1 << HTTP_RATELIMIT_SLOT_BITS) ///< Tracked clients
+#define HTTP_RATELIMIT_PROBE            4           ///< Slots searched per lookup
+#define HTTP_RATELIMIT_DEFAULT_RATE     10          ///< Default sustained requests per second per client
+#define HTTP_RATELIMIT_DEFAULT_BURST    30          ///< Default requests a client may send at once
+
+/**
+ * @brief Statistics of one tracked client, as exposed at /metrics
+ */
+typedef struct http_ratelimit_stats
+{
+    uint32_t ip;                ///< IPv4 address in network byte order (IPv6 clients: folded address)
+    uint32_t allowed;           ///< Requests let through since the client got its slot
+    uint32_t throttled;         ///< Requests answered with 429 since the client got its slot
+} http_ratelimit_stats_t;
+
+/**
+ * @brief Set the bucket parameters
+ * @param rate Tokens added per second, 0 disables rate limiting
+ * @param burst Bucket size (at least 1 when enabled)
+ * @note Call before the server starts; existing buckets keep their tokens
+ */
+void http_ratelimit_configure(uint16_t rate, uint16_t burst);
+
+/**
+ * @brief Take a token for the client of a request
+ *
+ * Answers the request with 429 Too Many Requests and a Retry-After header
+ * (seconds until the next token) if the client's bucket is empty.
+ *
+ * @param req HTTP request, not yet answered
+ * @return true if the request may be dispatched, false if it was answered with 429
+ * @note Call from the httpd task only
+ */
+bool http_ratelimit_check(httpd_req_t *req);
+
+/**
+ * @brief Take a token for the client of a request without answering it
+ *
+ * For requests that can no longer be answered with a status line, such as a
+ * WebSocket upgrade that httpd has already accepted.
+ *
+ * @param req HTTP request
+ * @return true if a token was taken, false if the client is throttled
+ * @note Call from the httpd task only
+ */
+bool http_ratelimit_allow(httpd_req_t *req);
+
+/**
+ * @brief Get the total number of throttled requests
+ * @return Requests answered with 429 since boot
+ */
+uint32_t http_ratelimit_get_throttled(void);
+
+/**
+ * @brief Get the number of clients whose slot was taken over by another client
+ * @return Evictions since boot
+ */
+uint32_t http_ratelimit_get_evictions(void);
+
+/**
+ * @brief Read the statistics of one slot
+ * @param index Slot index, 0 to HTTP_RATELIMIT_SLOTS - 1
+ * @param stats Receives the statistics
+ * @return false if the index is out of range or the slot is unused
+ */
+bool http_ratelimit_get_stats(int index, http_ratelimit_stats_t *stats);
+
+#endif /* MAIN_HTTP_RATELIMIT_H_ */
@@ -0,0 +1,467 @@
+/**
+ * @file http_router.c
+ * @brief HTTP API Router Implementation for ESP32 Weather Station
+ * @details This file implements the route trie and the dispatcher. Each
+ *          trie node is one path segment; literal and parameter children are
+ *          kept in sibling lists and routes hang off the node that ends their
+ *          pattern. Dispatch walks the request path segment by segment,
+ *          trying literal children before parameters and backtracking when a
+ *          branch dead-ends. Every route is recorded in the metrics layer
+ *          under its pattern.
+ *
+ * @author christophermena
+ * @date July 30, 2025
+ * @version 1.0
+ * @note Last Updated: October 16, 2026
+ */
+
+#include <ctype.h>
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+#include "esp_log.h"
+#include "sys/param.h"
+
+#include "http_metrics.h"
+#include "http_router.h"
+
+// Tag used for ESP serial console messages
+static const char TAG[] = "http_router";
+
+#define HTTP_ROUTER_NONE                0xFF        ///< Empty node/route link
+
+/**
+ * @brief Trie node, one path segment
+ */
+typedef struct http_router_node
+{
+    http_router_view_t segment;     ///< Literal text, or the parameter name for parameter nodes
+    bool param;                     ///< Segment is a {parameter}
+    uint8_t first_child;            ///< First child node
+    uint8_t next_sibling;           ///< Next node with the same parent
+    uint8_t first_route;            ///< First route ending at this node
+} http_router_node_t;
+
+/**
+ * @brief One route (pattern + method)
+ */
+typedef struct http_router_route
+{
+    const char *pattern;                ///< Route pattern
+    httpd_method_t method;              ///< HTTP method
+    http_router_handler_t handler;      ///< Typed handler
+    void *user_ctx;                     ///< Handler context
+    http_metrics_route_t *metrics;      ///< Statistics entry of the pattern
+    uint8_t next_route;                 ///< Next route ending at the same node
+} http_router_route_t;
+
+/**
+ * @brief Handler call passed through the metrics layer
+ */
+typedef struct http_router_call
+{
+    const http_router_route_t *route;   ///< Route being served
+    http_router_match_t *match;         ///< Parameters of the request
+} http_router_call_t;
+
+// Trie (node 0 is the root "/") and route table, only modified during start-up
+static http_router_node_t g_nodes[HTTP_ROUTER_MAX_NODES] = {
+    [0] = { .first_child = HTTP_ROUTER_NONE, .next_sibling = HTTP_ROUTER_NONE, .first_route = HTTP_ROUTER_NONE },
+};
+static uint8_t g_node_count = 1;
+static http_router_route_t g_routes[HTTP_ROUTER_MAX_ROUTES];
+static uint8_t g_route_count = 0;
+
+// Statistics of requests that match no route
+static http_metrics_route_t *g_unmatched_metrics[2];
+
+/**
+ * @brief Compares a view with a NUL terminated string.
+ */
+static bool http_router_view_equals(const http_router_view_t *view, const char *str)
+{
+    return strncmp(view->ptr, str, view->len) == 0 && str[view->len] == '\0';
+}
+
+/**
+ * @brief Copies a view into a buffer, decoding %XX escapes and '+'.
+ * @param view source view.
+ * @param buff destination buffer.
+ * @param buff_size size of the destination buffer.
+ */
+static void http_router_decode(const http_router_view_t *view, char *buff, size_t buff_size)
+{
+    size_t out = 0;
+
+    for (size_t in = 0; in < view->len && out + 1 < buff_size; in++)
+    {
+        char c = view->ptr[in];
+        if (c == '%' && in + 2 < view->len &&
+            isxdigit((unsigned char)view->ptr[in + 1]) && isxdigit((unsigned char)view->ptr[in + 2]))
+        {
+            char hex[3] = { view->ptr[in + 1], view->ptr[in + 2], '\0' };
+            c = (char)strtoul(hex, NULL, 16);
+            in += 2;
+        }
+        else if (c == '+')
+        {
+            c = ' ';
+        }
+        buff[out++] = c;
+    }
+    if (buff_size > 0)
+    {
+        buff[out] = '\0';
+    }
+}
+
+/**
+ * @brief Finds or creates the child of a node for a pattern segment.
+ * @param parent parent node.
+ * @param segment pattern segment, "{name}" for parameters.
+ * @return child node index, HTTP_ROUTER_NONE if the node table is full.
+ */
+static uint8_t http_router_child(uint8_t parent, http_router_view_t segment)
+{
+    bool param = segment.len >= 2 && segment.ptr[0] == '{' && segment.ptr[segment.len - 1] == '}';
+    if (param)
+    {
+        segment.ptr++;
+        segment.len -= 2;
+    }
+
+    for (uint8_t child = g_nodes[parent].first_child; child != HTTP_ROUTER_NONE; child = g_nodes[child].next_sibling)
+    {
+        if (g_nodes[child].param == param && g_nodes[child].segment.len == segment.len &&
+            strncmp(g_nodes[child].segment.ptr, segment.ptr, segment.len) == 0)
+        {
+            return child;
+        }
+    }
+
+    if (g_node_count >= HTTP_ROUTER_MAX_NODES)
+    {
+        return HTTP_ROUTER_NONE;
+    }
+    uint8_t child = g_node_count++;
+    g_nodes[child].segment = segment;
+    g_nodes[child].param = param;
+    g_nodes[child].first_child = HTTP_ROUTER_NONE;
+    g_nodes[child].first_route = HTTP_ROUTER_NONE;
+    g_nodes[child].next_sibling = g_nodes[parent].first_child;
+    g_nodes[parent].first_child = child;
+    return child;
+}
+
+esp_err_t http_router_add(const char *pattern, httpd_method_t method, http_router_handler_t handler, void *user_ctx)
+{
+    uint8_t node = 0;
+    int params = 0;
+
+    if (pattern[0] != '/')
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    // Re-adding after a server restart keeps the existing route
+    for (uint8_t i = 0; i < g_route_count; i++)
+    {
+        if (g_routes[i].method == method && strcmp(g_routes[i].pattern, pattern) == 0)
+        {
+            g_routes[i].handler = handler;
+            g_routes[i].user_ctx = user_ctx;
+            return ESP_OK;
+        }
+    }
+    if (g_route_count >= HTTP_ROUTER_MAX_ROUTES)
+    {
+        ESP_LOGE(TAG, "http_router_add: route table full, %s not added", pattern);
+        return ESP_ERR_NO_MEM;
+    }
+
+    // Walk/extend the trie one segment at a time
+    const char *segment = pattern + 1;
+    while (*segment != '\0')
+    {
+        size_t len = strcspn(segment, "/");
+        if (len == 0)
+        {
+            return ESP_ERR_INVALID_ARG;
+        }
+        http_router_view_t view = { .ptr = segment, .len = len };
+        params += (segment[0] == '{') ? 1 : 0;
+
+        node = http_router_child(node, view);
+        if (node == HTTP_ROUTER_NONE)
+        {
+            ESP_LOGE(TAG, "http_router_add: node table full, %s not added", pattern);
+            return ESP_ERR_NO_MEM;
+        }
+        segment += len;
+        segment += (*segment == '/') ? 1 : 0;
+    }
+    if (params > HTTP_ROUTER_MAX_PARAMS)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    http_router_route_t *route = &g_routes[g_route_count];
+    route->pattern = pattern;
+    route->method = method;
+    route->handler = handler;
+    route->user_ctx = user_ctx;
+    route->metrics = http_metrics_add_route(pattern, method);
+    route->next_route = g_nodes[node].first_route;
+    g_nodes[node].first_route = g_route_count++;
+
+    return ESP_OK;
+}
+
+/**
+ * @brief Matches the rest of a path below a node.
+ * @param node current node.
+ * @param path remaining path (after the '/' that ends the node's segment).
+ * @param len length of the remaining path.
+ * @param match collects the parameters on the way down.
+ * @return node that ends the path and has routes, HTTP_ROUTER_NONE if none.
+ */
+static uint8_t http_router_match_node(uint8_t node, const char *path, size_t len, http_router_match_t *match)
+{
+    if (len == 0)
+    {
+        return (g_nodes[node].first_route != HTTP_ROUTER_NONE) ? node : HTTP_ROUTER_NONE;
+    }
+
+    size_t segment_len = 0;
+    while (segment_len < len && path[segment_len] != '/')
+    {
+        segment_len++;
+    }
+    const char *rest = path + segment_len;
+    size_t rest_len = len - segment_len;
+    if (rest_len > 0)
+    {
+        // Skip the separator
+        rest++;
+        rest_len--;
+    }
+
+    // Literal children first
+    for (uint8_t child = g_nodes[node].first_child; child != HTTP_ROUTER_NONE; child = g_nodes[child].next_sibling)
+    {
+        if (!g_nodes[child].param && g_nodes[child].segment.len == segment_len &&
+            strncmp(g_nodes[child].segment.ptr, path, segment_len) == 0)
+        {
+            uint8_t found = http_router_match_node(child, rest, rest_len, match);
+            if (found != HTTP_ROUTER_NONE)
+            {
+                return found;
+            }
+        }
+    }
+
+    // Then parameters, which match any non-empty segment
+    if (segment_len == 0 || match->param_count >= HTTP_ROUTER_MAX_PARAMS)
+    {
+        return HTTP_ROUTER_NONE;
+    }
+    for (uint8_t child = g_nodes[node].first_child; child != HTTP_ROUTER_NONE; child = g_nodes[child].next_sibling)
+    {
+        if (g_nodes[child].param)
+        {
+            uint8_t index = match->param_count++;
+            match->param_names[index] = g_nodes[child].segment;
+            match->params[index].ptr = path;
+            match->params[index].len = segment_len;
+
+            uint8_t found = http_router_match_node(child, rest, rest_len, match);
+            if (found != HTTP_ROUTER_NONE)
+            {
+                return found;
+            }
+            match->param_count--;
+        }
+    }
+    return HTTP_ROUTER_NONE;
+}
+
+/**
+ * @brief Splits the query string into key/value views.
+ * @param query query string (after '?').
+ * @param match receives the views.
+ */
+static void http_router_parse_query(const char *query, http_router_match_t *match)
+{
+    while (*query != '\0' && *query != '#' && match->query_count < HTTP_ROUTER_MAX_QUERY)
+    {
+        size_t pair_len = strcspn(query, "&#");
+        size_t key_len = strcspn(query, "=&#");
+
+        if (pair_len > 0)
+        {
+            uint8_t index = match->query_count++;
+            match->query_keys[index].ptr = query;
+            match->query_keys[index].len = key_len;
+            match->query_values[index].ptr = query + MIN(key_len + 1, pair_len);
+            match->query_values[index].len = (key_len < pair_len) ? pair_len - key_len - 1 : 0;
+        }
+        query += pair_len;
+        query += (*query == '&') ? 1 : 0;
+    }
+}
+
+/**
+ * @brief Calls a typed handler (through http_metrics_observe()).
+ */
+static esp_err_t http_router_call(httpd_req_t *req, void *arg)
+{
+    http_router_call_t *call = (http_router_call_t *)arg;
+
+    return call->route->handler(req, call->match);
+}
+
+/**
+ * @brief Answers a request that matched no route.
+ */
+static esp_err_t http_router_not_found(httpd_req_t *req, void *arg)
+{
+    return httpd_resp_send_err(req, HTTPD_404_NOT_FOUND, "No such API endpoint");
+}
+
+/**
+ * @brief Answers a request whose path matched but whose method did not.
+ */
+static esp_err_t http_router_method_not_allowed(httpd_req_t *req, void *arg)
+{
+    char *allow = (char *)arg;
+
+    httpd_resp_set_status(req, "405 Method Not Allowed");
+    httpd_resp_set_hdr(req, "Allow", allow);
+    return httpd_resp_sendstr(req, "Method not allowed");
+}
+
+/**
+ * @brief httpd handler registered for HTTP_ROUTER_PREFIX: matches the request and dispatches it.
+ * @param req HTTP request.
+ * @return result of the route handler.
+ */
+static esp_err_t http_router_dispatch(httpd_req_t *req)
+{
+    http_router_match_t match;
+    const char *uri = req->uri;
+    size_t path_len = strcspn(uri, "?#");
+
+    memset(&match, 0, sizeof(match));
+    if (uri[path_len] == '?')
+    {
+        http_router_parse_query(uri + path_len + 1, &match);
+    }
+
+    // A trailing slash names the same resource
+    if (path_len > 1 && uri[path_len - 1] == '/')
+    {
+        path_len--;
+    }
+
+    uint8_t node = http_router_match_node(0, uri + 1, path_len - 1, &match);
+    http_metrics_route_t *unmatched = g_unmatched_metrics[req->method == HTTP_POST ? 1 : 0];
+    if (node == HTTP_ROUTER_NONE)
+    {
+        return http_metrics_observe(unmatched, req, http_router_not_found, NULL);
+    }
+
+    char allow[32] = "";
+    for (uint8_t index = g_nodes[node].first_route; index != HTTP_ROUTER_NONE; index = g_routes[index].next_route)
+    {
+        const http_router_route_t *route = &g_routes[index];
+        if (route->method == req->method)
+        {
+            http_router_call_t call = { .route = route, .match = &match };
+            match.user_ctx = route->user_ctx;
+            return http_metrics_observe(route->metrics, req, http_router_call, &call);
+        }
+        if (strlen(allow) + 8 < sizeof(allow))
+        {
+            strcat(allow, allow[0] ? ", " : "");
+            strcat(allow, (route->method == HTTP_POST) ? "POST" : "GET");
+        }
+    }
+    return http_metrics_observe(unmatched, req, http_router_method_not_allowed, allow);
+}
+
+esp_err_t http_router_register(httpd_handle_t handle)
+{
+    static const httpd_method_t methods[] = { HTTP_GET, HTTP_POST };
+
+    for (size_t i = 0; i < sizeof(methods) / sizeof(methods[0]); i++)
+    {
+        httpd_uri_t router =
+            {
+                .uri = HTTP_ROUTER_PREFIX,
+                .method = methods[i],
+                .handler = http_router_dispatch,
+                .user_ctx = NULL,
+            };
+        g_unmatched_metrics[i] = http_metrics_add_route(HTTP_ROUTER_PREFIX, methods[i]);
+
+        esp_err_t err = httpd_register_uri_handler(handle, &router);
+        if (err != ESP_OK)
+        {
+            return err;
+        }
+    }
+
+    ESP_LOGI(TAG, "http_router_register: %d routes, %d trie nodes", g_route_count, g_node_count);
+    return ESP_OK;
+}
+
+bool http_router_get_param(const http_router_match_t *match, const char *name, char *buff, size_t buff_size)
+{
+    for (int i = 0; i < match->param_count; i++)
+    {
+        if (http_router_view_equals(&match->param_names[i], name))
+        {
+            http_router_decode(&match->params[i], buff, buff_size);
+            return true;
+        }
+    }
+    return false;
+}
+
+bool http_router_get_query(const http_router_match_t *match, const char *key, char *buff, size_t buff_size)
+{
+    for (int i = 0; i < match->query_count; i++)
+    {
+        if (http_router_view_equals(&match->query_keys[i], key))
+        {
+            http_router_decode(&match->query_values[i], buff, buff_size);
+            return true;
+        }
+    }
+    return false;
+}
+
+bool http_router_get_query_u32(const http_router_match_t *match, const char *key, uint32_t default_value, uint32_t *value)
+{
+    char buff[16];
+    char *end;
+
+    if (!http_router_get_query(match, key, buff, sizeof(buff)))
+    {
+        *value = default_value;
+        return true;
+    }
+    // strtoul would skip blanks and wrap a leading '-', and a full buffer may have cut off digits
+    if (!isdigit((unsigned char)buff[0]) || strlen(buff) == sizeof(buff) - 1)
+    {
+        return false;
+    }
+    errno = 0;
+    unsigned long parsed = strtoul(buff, &end, 10);
+    if (*end != '\0' || errno == ERANGE || parsed > UINT32_MAX)
+    {
+        return false;
+    }
+    *value = (uint32_t)parsed;
+    return true;
+}
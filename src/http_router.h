@@ -0,0 +1,116 @@
+/**
+ * @file http_router.h
+ * @brief HTTP API Router Header for ESP32 Weather Station
+ * @details This header file defines the routing layer used for the /api
+ *          endpoints. Route patterns such as "/api/sensors/{id}/history" are
+ *          compiled into a static trie; the router is registered with
+ *          esp_http_server as a single wildcard handler per method and
+ *          dispatches each request to the matching typed handler. Path
+ *          parameters and the query string are exposed as views into the
+ *          request URI, so matching and parsing never allocate or copy.
+ *
+ * @author christophermena
+ * @date July 30, 2025
+ * @version 1.0
+ * @note Last Updated: October 16, 2026
+ */
+
+#ifndef MAIN_HTTP_ROUTER_H_
+#define MAIN_HTTP_ROUTER_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "esp_http_server.h"
+
+// HTTP Router Configuration
+#define HTTP_ROUTER_PREFIX              "/api/*"    ///< httpd wildcard registered for the router
+#define HTTP_ROUTER_MAX_ROUTES          24          ///< Routes (pattern + method)
+#define HTTP_ROUTER_MAX_NODES           32          ///< Trie nodes (distinct path segments)
+#define HTTP_ROUTER_MAX_PARAMS          4           ///< Path parameters per route
+#define HTTP_ROUTER_MAX_QUERY           8           ///< Query parameters parsed per request
+
+/**
+ * @brief A slice of the request URI (not NUL terminated, still percent-encoded)
+ */
+typedef struct http_router_view
+{
+    const char *ptr;        ///< Start of the slice
+    uint16_t len;           ///< Length of the slice
+} http_router_view_t;
+
+/**
+ * @brief Result of matching a request against the route trie
+ */
+typedef struct http_router_match
+{
+    void *user_ctx;                                         ///< User context of the route
+    uint8_t param_count;                                    ///< Number of path parameters
+    http_router_view_t param_names[HTTP_ROUTER_MAX_PARAMS]; ///< Parameter names (from the pattern)
+    http_router_view_t params[HTTP_ROUTER_MAX_PARAMS];      ///< Parameter values (from the URI)
+    uint8_t query_count;                                    ///< Number of query parameters
+    http_router_view_t query_keys[HTTP_ROUTER_MAX_QUERY];   ///< Query keys
+    http_router_view_t query_values[HTTP_ROUTER_MAX_QUERY]; ///< Query values (empty for "?key")
+} http_router_match_t;
+
+/**
+ * @brief Typed route handler
+ * @param req HTTP request
+ * @param match Path parameters, query view and user context of the route
+ * @return ESP_OK, otherwise an error to close the connection
+ */
+typedef esp_err_t (*http_router_handler_t)(httpd_req_t *req, const http_router_match_t *match);
+
+/**
+ * @brief Add a route
+ *
+ * Patterns are absolute paths below HTTP_ROUTER_PREFIX. A segment written
+ * as {name} matches any single segment and is captured as a parameter;
+ * literal segments take precedence over parameters.
+ *
+ * @param pattern Route pattern (must stay valid, typically a string literal)
+ * @param method HTTP method
+ * @param handler Handler called for matching requests
+ * @param user_ctx Context passed in match->user_ctx
+ * @return ESP_OK, ESP_ERR_NO_MEM if a table is full, ESP_ERR_INVALID_ARG for a malformed pattern
+ */
+esp_err_t http_router_add(const char *pattern, httpd_method_t method, http_router_handler_t handler, void *user_ctx);
+
+/**
+ * @brief Register the router with the HTTP server
+ * @param handle HTTP server handle (started with uri_match_fn = httpd_uri_match_wildcard)
+ * @return ESP_OK, otherwise the error of httpd_register_uri_handler()
+ */
+esp_err_t http_router_register(httpd_handle_t handle);
+
+/**
+ * @brief Copy a decoded path parameter
+ * @param match Match passed to the handler
+ * @param name Parameter name as written in the pattern
+ * @param buff Destination buffer (NUL terminated, truncated to fit)
+ * @param buff_size Size of the destination buffer
+ * @return true if the parameter exists
+ */
+bool http_router_get_param(const http_router_match_t *match, const char *name, char *buff, size_t buff_size);
+
+/**
+ * @brief Copy a decoded query parameter
+ * @param match Match passed to the handler
+ * @param key Query key
+ * @param buff Destination buffer (NUL terminated, truncated to fit)
+ * @param buff_size Size of the destination buffer
+ * @return true if the key is present
+ */
+bool http_router_get_query(const http_router_match_t *match, const char *key, char *buff, size_t buff_size);
+
+/**
+ * @brief Read an unsigned decimal integer query parameter
+ * @param match Match passed to the handler
+ * @param key Query key
+ * @param default_value Value stored if the key is missing
+ * @param value Receives the parameter value
+ * @return false if the value is empty, not a decimal number or above UINT32_MAX
+ *         (callers answer 400), true otherwise
+ */
+bool http_router_get_query_u32(const http_router_match_t *match, const char *key, uint32_t default_value, uint32_t *value);
+
+#endif /* MAIN_HTTP_ROUTER_H_ */
@@ -14,20 +14,60 @@
  * @note Last Updated: August 1, 2025 at 10:30 AM
  */
 
+#include <ctype.h>
 #include <stdbool.h>
+#include <stdlib.h>
 #include "esp_http_server.h"
 #include "esp_log.h"
 #include "esp_ota_ops.h"
+#include "esp_system.h"
 #include "sys/param.h"
 #include "esp_timer.h"
-
+#include "lwip/sockets.h"
+#include "nvs.h"
+
+#include "http_api.h"
+#include "http_cache.h"
+#include "http_metrics.h"
+#include "http_ratelimit.h"
+#include "http_router.h"
 #include "http_server.h"
+#include "http_sse.h"
+#include "http_ws.h"
+#include "ota_fetch.h"
+#include "ota_update.h"
 #include "tasks_common.h"
+#include "webui_store.h"
 #include "wifi_app.h"
 
 // Tag used for ESP serial console messages
 static const char TAG[] = "http_server";
 
+// Client sockets available to httpd (3 of the LWIP sockets are used internally)
+#define HTTP_SERVER_MAX_SOCKETS         (CONFIG_LWIP_MAX_SOCKETS - 3)
+
+// Socket pool configuration used until one is saved
+static const http_server_config_t http_server_default_config = {
+    .max_open_sockets = HTTP_SERVER_MAX_SOCKETS,
+    .lru_purge_enable = true,
+    .idle_timeout_s = 60,
+    .keep_alive_enable = true,
+    .keep_alive_idle_s = 30,
+    .keep_alive_interval_s = 5,
+    .keep_alive_count = 3,
+    .recv_wait_timeout_s = 10,
+    .send_wait_timeout_s = 10,
+    .sock_recv_buf = 0,
+    .ratelimit_rate = HTTP_RATELIMIT_DEFAULT_RATE,
+    .ratelimit_burst = HTTP_RATELIMIT_DEFAULT_BURST,
+};
+
+// Socket pool configuration, loaded from NVS when the server starts
+static http_server_config_t g_server_config;
+
+// Periodic idle session sweep
+static esp_timer_handle_t http_server_idle_timer = NULL;
+
 // Firmware update status
 static int g_fw_update_status = OTA_UPDATE_PENDING;
 
@@ -40,6 +80,12 @@ static TaskHandle_t task_http_server_monitor = NULL;
 // Queue handle used to manipulate the queue of events
 static QueueHandle_t http_server_monitor_queue_handle = NULL;
 
+// Cached /OTAstatus body
+static http_cache_entry_t *http_server_ota_status_cache = NULL;
+
+// Receive buffer for resumable OTA chunks and web UI uploads (handlers run on the single httpd task)
+static uint8_t http_server_ota_chunk_buff[OTA_UPDATE_CHUNK_MAX_SIZE];
+
 /**
  * ESP32 timer configuration passed to esp_timer_create
  */
@@ -51,17 +97,24 @@ const esp_timer_create_args_t fw_update_reset_args = {
 };
 esp_timer_handle_t fw_update_reset;
 
-// Embedded files: JQuery, index.html, app.css, app.js and favicon.ico files
-extern const uint8_t jquery_3_3_1_min_js_start[] asm("_binary_jquery_3_3_1_min_js_start");
-extern const uint8_t jquery_3_3_1_min_js_end[] asm("_binary_jquery_3_3_1_min_js_end");
-extern const uint8_t index_html_start[] asm("_binary_index_html_start");
-extern const uint8_t index_html_end[] asm("_binary_index_html_end");
-extern const uint8_t app_css_start[] asm("_binary_app_css_start");
-extern const uint8_t app_css_end[] asm("_binary_app_css_end");
-extern const uint8_t app_js_start[] asm("_binary_app_js_start");
-extern const uint8_t app_js_end[] asm("_binary_app_js_end");
-extern const uint8_t favicon_ico_start[] asm("_binary_favicon_ico_start");
-extern const uint8_t favicon_ico_end[] asm("_binary_favicon_ico_end");
+// Page served while no web UI image is installed in the "webui" partition
+static const char http_server_webui_missing_html[] =
+    "<!DOCTYPE html><html><head><meta charset=\"utf-8\"><title>Weather Station</title></head><body>"
+    "<h2>Web UI not installed</h2><p>Upload an image built by tools/webui_pack.py:</p>"
+    "<input type=\"file\" id=\"image\"><button onclick=\"fetch('/webui',{method:'POST',body:"
+    "document.getElementById('image').files[0]}).then(function(r){location.reload()})\">Upload</button>"
+    "</body></html>";
+
+/**
+ * @brief Sets the firmware update status and notifies its readers (cached /OTAstatus body, WebSocket clients).
+ * @param status new OTA_UPDATE_* status.
+ */
+static void http_server_set_fw_update_status(int status)
+{
+    g_fw_update_status = status;
+    http_cache_invalidate(HTTP_CACHE_TOPIC_OTA);
+    http_ws_publish_ota(status, 0, 0);
+}
 
 /**
  * @brief Checks the g_fw_update_status and creates the fw_update_reset timer if g_fw_update_status is true.
@@ -114,13 +167,13 @@ static void http_server_monitor(void *pvParameters)
 
             case HTTP_MSG_OTA_UPDATE_SUCCESSFUL:
                 ESP_LOGI(TAG, "HTTP_MSG_OTA_UPDATE_SUCCESSFUL");
-                g_fw_update_status = OTA_UPDATE_SUCCESSFUL;
+                http_server_set_fw_update_status(OTA_UPDATE_SUCCESSFUL);
                 http_server_fw_reset_timer();
                 break;
 
             case HTTP_MSG_OTA_UPDATE_FAILED:
                 ESP_LOGI(TAG, "HTTP_MSG_OTA_UPDATE_FAILED");
-                g_fw_update_status = OTA_UPDATE_FAILED;
+                http_server_set_fw_update_status(OTA_UPDATE_FAILED);
                 break;
 
             default:
@@ -131,78 +184,116 @@ static void http_server_monitor(void *pvParameters)
 }
 
 /**
- * @brief JQuery get handler is requested when accessing the webpage.
+ * @brief Sends a web UI asset (index.html, favicon.ico, ...) straight from the mapped "webui" partition.
  * @param req HTTP request for which the uri needs to be handled.
  * @return ESP_OK
  */
-static esp_err_t http_server_jquery_handler(httpd_req_t *req)
+static esp_err_t http_server_webui_asset_handler(httpd_req_t *req)
 {
-    ESP_LOGI(TAG, "JQuery requested");
-
-    httpd_resp_set_type(req, "application/javascript");
-    httpd_resp_send(req, (const char *)jquery_3_3_1_min_js_start, jquery_3_3_1_min_js_end - jquery_3_3_1_min_js_start);
+    webui_asset_t asset;
+    char path[WEBUI_STORE_PATH_MAX];
+    char etag[12];
+    char if_none_match[12];
 
-    return ESP_OK;
-}
+    snprintf(path, sizeof(path), "%.*s", (int)strcspn(req->uri, "?#"), req->uri);
+    ESP_LOGI(TAG, "%s requested", path);
 
-/**
- * @brief Sends the index.html page.
- * @param req HTTP request for which the uri needs to be handled.
- * @return ESP_OK
- */
-static esp_err_t http_server_index_html_handler(httpd_req_t *req)
-{
-    ESP_LOGI(TAG, "index.html requested");
+    if (!webui_store_find(path, &asset))
+    {
+        if (strcmp(path, "/") == 0)
+        {
+            httpd_resp_set_type(req, "text/html");
+            return httpd_resp_send(req, http_server_webui_missing_html, sizeof(http_server_webui_missing_html) - 1);
+        }
+        return httpd_resp_send_err(req, HTTPD_404_NOT_FOUND, "Not found");
+    }
 
-    httpd_resp_set_type(req, "text/html");
-    httpd_resp_send(req, (const char *)index_html_start, index_html_end - index_html_start);
+    // The image CRC changes with every upload, so it identifies all assets of the image
+    snprintf(etag, sizeof(etag), "\"%08lx\"", webui_store_get_crc());
+    httpd_resp_set_hdr(req, "ETag", etag);
+    httpd_resp_set_hdr(req, "Cache-Control", "no-cache");
+    if (httpd_req_get_hdr_value_str(req, "If-None-Match", if_none_match, sizeof(if_none_match)) == ESP_OK &&
+        strcmp(if_none_match, etag) == 0)
+    {
+        httpd_resp_set_status(req, "304 Not Modified");
+        return httpd_resp_send(req, NULL, 0);
+    }
 
-    return ESP_OK;
+    httpd_resp_set_type(req, asset.content_type);
+    if (asset.gzip)
+    {
+        httpd_resp_set_hdr(req, "Content-Encoding", "gzip");
+        httpd_resp_set_hdr(req, "Vary", "Accept-Encoding");
+    }
+    return httpd_resp_send(req, (const char *)asset.data, asset.size);
 }
 
-/**
- * @brief app.css get handler is requested when accessing the webpage.
- * @param req HTTP request for which the uri needs to be handled.
- * @return ESP_OK
- */
-static esp_err_t http_server_app_css_handler(httpd_req_t *req)
+bool http_server_recv_exact(httpd_req_t *req, void *buff, size_t len)
 {
-    ESP_LOGI(TAG, "app.css requested");
+    size_t received = 0;
 
-    httpd_resp_set_type(req, "text/css");
-    httpd_resp_send(req, (const char *)app_css_start, app_css_end - app_css_start);
-
-    return ESP_OK;
+    while (received < len)
+    {
+        int recv_len = httpd_req_recv(req, (char *)buff + received, len - received);
+        if (recv_len == HTTPD_SOCK_ERR_TIMEOUT)
+        {
+            continue;
+        }
+        if (recv_len <= 0)
+        {
+            return false;
+        }
+        received += recv_len;
+    }
+    return true;
 }
 
 /**
- * @brief app.js get handler is requested when accessing the webpage.
+ * @brief Receives a web UI image (built by tools/webui_pack.py) and installs it in the "webui" partition.
  * @param req HTTP request for which the uri needs to be handled.
- * @return ESP_OK
+ * @return ESP_OK, otherwise ESP_FAIL if the client went away.
  */
-static esp_err_t http_server_app_js_handler(httpd_req_t *req)
+static esp_err_t http_server_webui_upload_handler(httpd_req_t *req)
 {
-    ESP_LOGI(TAG, "app.js requested");
-
-    httpd_resp_set_type(req, "application/javascript");
-    httpd_resp_send(req, (const char *)app_js_start, app_js_end - app_js_start);
+    webui_store_header_t header;
 
-    return ESP_OK;
-}
+    if (req->content_len < sizeof(header) || !http_server_recv_exact(req, &header, sizeof(header)))
+    {
+        return httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, "Not a web UI image");
+    }
+    if (header.size != req->content_len)
+    {
+        return httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, "Image size does not match the body");
+    }
 
-/**
- * @brief Sends the .ico (icon) file when accessing the web page.
- * @param req HTTP request for which the uri needs to be handled.
- * @return ESP_OK
- */
-static esp_err_t http_server_favicon_ico_handler(httpd_req_t *req)
-{
-    ESP_LOGI(TAG, "favicon.ico requested");
+    esp_err_t err = webui_store_update_begin(&header);
+    if (err == ESP_OK)
+    {
+        err = webui_store_update_write(&header, sizeof(header));
+        for (size_t offset = sizeof(header); offset < header.size && err == ESP_OK; )
+        {
+            size_t len = MIN(header.size - offset, sizeof(http_server_ota_chunk_buff));
+            if (!http_server_recv_exact(req, http_server_ota_chunk_buff, len))
+            {
+                webui_store_update_end();
+                return ESP_FAIL;
+            }
+            err = webui_store_update_write(http_server_ota_chunk_buff, len);
+            offset += len;
+        }
 
-    httpd_resp_set_type(req, "image/x-icon");
-    httpd_resp_send(req, (const char *)favicon_ico_start, favicon_ico_end - favicon_ico_start);
+        // Maps and validates the new image (a bad CRC leaves the fallback page in place)
+        esp_err_t end_err = webui_store_update_end();
+        err = (err == ESP_OK) ? end_err : err;
+    }
 
-    return ESP_OK;
+    if (err != ESP_OK)
+    {
+        ESP_LOGE(TAG, "http_server_webui_upload_handler: %s", esp_err_to_name(err));
+        httpd_resp_set_status(req, err == ESP_ERR_INVALID_SIZE ? "413 Payload Too Large" : HTTPD_400);
+        return httpd_resp_sendstr(req, esp_err_to_name(err));
+    }
+    return httpd_resp_sendstr(req, "Web UI installed");
 }
 
 /**
@@ -221,6 +312,14 @@ esp_err_t http_server_OTA_update_handler(httpd_req_t *req)
     bool flash_successful = false;
     const esp_partition_t *update_partition = esp_ota_get_next_update_partition(NULL);
 
+    if (ota_fetch_is_running())
+    {
+        // The download is writing the same partition
+        httpd_resp_set_status(req, "409 Conflict");
+        httpd_resp_sendstr(req, "A firmware download is in progress");
+        return ESP_OK;
+    }
+
     do
     {
         // Read the data from the request
@@ -249,6 +348,9 @@ esp_err_t http_server_OTA_update_handler(httpd_req_t *req)
 
             printf("http_server_OTA_update_handler: OTA file size: %d", content_length);
 
+            // A full upload replaces any interrupted chunked transfer to the same partition
+            ota_update_abort();
+
             esp_err_t err =  esp_ota_begin(update_partition, OTA_SIZE_UNKNOWN, &ota_handle);
             if (err != ESP_OK)
             {
@@ -303,6 +405,248 @@ esp_err_t http_server_OTA_update_handler(httpd_req_t *req)
     return ESP_OK;
 }
 
+/**
+ * @brief Reads a numeric request header (decimal or 0x-prefixed hex).
+ * @param req HTTP request to read the header from.
+ * @param field header name.
+ * @param value destination for the parsed value.
+ * @return true if the header exists and is a valid number, false otherwise.
+ */
+static bool http_server_get_hdr_u32(httpd_req_t *req, const char *field, uint32_t *value)
+{
+    char buff[16];
+    char *end;
+
+    if (httpd_req_get_hdr_value_str(req, field, buff, sizeof(buff)) != ESP_OK)
+    {
+        return false;
+    }
+    *value = strtoul(buff, &end, 0);
+
+    return end != buff && *end == '\0';
+}
+
+/**
+ * @brief Sends the state of the resumable OTA session as JSON.
+ * @param req HTTP request to respond to.
+ * @param status HTTP status line to respond with.
+ * @return ESP_OK
+ */
+static esp_err_t http_server_OTA_send_session(httpd_req_t *req, const char *status)
+{
+    char sessionJSON[128];
+    ota_update_state_t state;
+
+    ota_update_get_state(&state);
+    sprintf(sessionJSON, "{\"active\":%s,\"offset\":%lu,\"size\":%lu,\"crc\":%lu,\"chunk_max\":%d}",
+            state.active ? "true" : "false", state.committed, state.image_size, state.image_crc, OTA_UPDATE_CHUNK_MAX_SIZE);
+
+    httpd_resp_set_status(req, status);
+    httpd_resp_set_type(req, "application/json");
+    httpd_resp_send(req, sessionJSON, strlen(sessionJSON));
+
+    return ESP_OK;
+}
+
+/**
+ * @brief Reports the committed offset of the resumable OTA session so the client knows where to continue.
+ * @param req HTTP request for which the uri needs to be handled.
+ * @return ESP_OK
+ */
+static esp_err_t http_server_OTA_resume_handler(httpd_req_t *req)
+{
+    ESP_LOGI(TAG, "OTAresume requested");
+
+    return http_server_OTA_send_session(req, HTTPD_200);
+}
+
+/**
+ * @brief Receives one CRC protected chunk of a resumable firmware update.
+ * The chunk is described by the X-OTA-Image-Size, X-OTA-Image-CRC, X-OTA-Offset and X-OTA-Chunk-CRC headers,
+ * the body carries the raw image bytes. Responds with the committed offset, which is where the next chunk must start.
+ * @param req HTTP request for which the uri needs to be handled.
+ * @return ESP_OK, otherwise ESP_FAIL if the connection dropped while receiving the chunk.
+ */
+static esp_err_t http_server_OTA_chunk_handler(httpd_req_t *req)
+{
+    uint32_t image_size, image_crc, offset, chunk_crc;
+    size_t content_received = 0;
+    int recv_len;
+
+    if (!http_server_get_hdr_u32(req, "X-OTA-Image-Size", &image_size) ||
+        !http_server_get_hdr_u32(req, "X-OTA-Image-CRC", &image_crc) ||
+        !http_server_get_hdr_u32(req, "X-OTA-Offset", &offset) ||
+        !http_server_get_hdr_u32(req, "X-OTA-Chunk-CRC", &chunk_crc))
+    {
+        httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, "Missing OTA chunk headers");
+        return ESP_OK;
+    }
+    if (req->content_len == 0 || req->content_len > sizeof(http_server_ota_chunk_buff))
+    {
+        httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, "Invalid OTA chunk length");
+        return ESP_OK;
+    }
+    if (ota_fetch_is_running())
+    {
+        // The download owns the session, beginning ours would reset it under the writer
+        httpd_resp_set_status(req, "409 Conflict");
+        httpd_resp_sendstr(req, "A firmware download is in progress");
+        return ESP_OK;
+    }
+
+    esp_err_t err = ota_update_begin(image_size, image_crc);
+    if (err != ESP_OK)
+    {
+        ESP_LOGI(TAG, "http_server_OTA_chunk_handler: cannot start session: %s", esp_err_to_name(err));
+        httpd_resp_set_status(req, err == ESP_ERR_INVALID_SIZE ? "413 Payload Too Large" : HTTPD_500);
+        httpd_resp_sendstr(req, err == ESP_ERR_INVALID_SIZE ? "Image does not fit the update partition" : esp_err_to_name(err));
+        return ESP_OK;
+    }
+
+    // Receive the whole chunk before anything is written, a partial chunk is never committed
+    while (content_received < req->content_len)
+    {
+        recv_len = httpd_req_recv(req, (char *)http_server_ota_chunk_buff + content_received, req->content_len - content_received);
+        if (recv_len == HTTPD_SOCK_ERR_TIMEOUT)
+        {
+            continue;
+        }
+        if (recv_len <= 0)
+        {
+            ESP_LOGI(TAG, "http_server_OTA_chunk_handler: connection lost at chunk offset %lu", offset);
+            return ESP_FAIL;
+        }
+        content_received += recv_len;
+    }
+
+    err = ota_update_write_chunk(offset, http_server_ota_chunk_buff, content_received, chunk_crc);
+    switch (err)
+    {
+    case ESP_OK:
+        {
+            ota_update_state_t state;
+            ota_update_get_state(&state);
+            if (!state.active)
+            {
+                ESP_LOGI(TAG, "http_server_OTA_chunk_handler: image complete and verified");
+                http_server_monitor_send_message(HTTP_MSG_OTA_UPDATE_SUCCESSFUL);
+            }
+            else
+            {
+                http_ws_publish_ota(OTA_UPDATE_PENDING, state.committed, state.image_size);
+            }
+            return http_server_OTA_send_session(req, HTTPD_200);
+        }
+
+    case ESP_ERR_INVALID_STATE:
+        // Client is out of sync, tell it where to continue
+        return http_server_OTA_send_session(req, "409 Conflict");
+
+    case ESP_ERR_INVALID_CRC:
+        ESP_LOGI(TAG, "http_server_OTA_chunk_handler: CRC mismatch at offset %lu", offset);
+        return http_server_OTA_send_session(req, "422 Unprocessable Entity");
+
+    case ESP_ERR_OTA_VALIDATE_FAILED:
+        ESP_LOGI(TAG, "http_server_OTA_chunk_handler: image verification failed");
+        http_server_monitor_send_message(HTTP_MSG_OTA_UPDATE_FAILED);
+        return http_server_OTA_send_session(req, HTTPD_500);
+
+    default:
+        ESP_LOGI(TAG, "http_server_OTA_chunk_handler: write error %s", esp_err_to_name(err));
+        return http_server_OTA_send_session(req, HTTPD_500);
+    }
+}
+
+/**
+ * @brief Decodes a percent-encoded form value in place ("%2F" -> '/', '+' -> ' ').
+ * @param str value to decode.
+ */
+static void http_server_url_decode(char *str)
+{
+    char *out = str;
+
+    while (*str)
+    {
+        if (*str == '%' && isxdigit((unsigned char)str[1]) && isxdigit((unsigned char)str[2]))
+        {
+            char hex[3] = { str[1], str[2], '\0' };
+            *out++ = (char)strtol(hex, NULL, 16);
+            str += 3;
+        }
+        else
+        {
+            *out++ = (*str == '+') ? ' ' : *str;
+            str++;
+        }
+    }
+    *out = '\0';
+}
+
+/**
+ * @brief Starts a pull-mode firmware update: the device downloads the image from the given URL itself.
+ * The form encoded body carries url=<firmware URL>&crc=<CRC-32 of the image>.
+ * @param req HTTP request for which the uri needs to be handled.
+ * @return ESP_OK, otherwise ESP_FAIL if the body cannot be received.
+ */
+static esp_err_t http_server_OTA_fetch_handler(httpd_req_t *req)
+{
+    char body[OTA_FETCH_URL_MAX_LENGTH * 3 + 32];
+    char url[sizeof(body)];
+    char crc[16];
+    char *end;
+
+    if (req->content_len == 0 || req->content_len >= sizeof(body))
+    {
+        httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, "Invalid request body");
+        return ESP_OK;
+    }
+    if (!http_server_recv_exact(req, body, req->content_len))
+    {
+        return ESP_FAIL;
+    }
+    body[req->content_len] = '\0';
+
+    if (httpd_query_key_value(body, "url", url, sizeof(url)) != ESP_OK ||
+        httpd_query_key_value(body, "crc", crc, sizeof(crc)) != ESP_OK)
+    {
+        httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, "Expected url=...&crc=...");
+        return ESP_OK;
+    }
+    http_server_url_decode(url);
+    uint32_t image_crc = strtoul(crc, &end, 0);
+    if (end == crc || *end != '\0')
+    {
+        httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, "Invalid crc");
+        return ESP_OK;
+    }
+
+    ESP_LOGI(TAG, "OTAfetch requested: %s", url);
+
+    esp_err_t err = ota_fetch_start(url, image_crc);
+    if (err != ESP_OK)
+    {
+        httpd_resp_set_status(req, err == ESP_ERR_INVALID_STATE ? "409 Conflict" : HTTPD_400);
+        httpd_resp_sendstr(req, esp_err_to_name(err));
+        return ESP_OK;
+    }
+
+    // The download result is reported through /OTAstatus like a pushed update
+    http_server_set_fw_update_status(OTA_UPDATE_PENDING);
+    return http_server_OTA_send_session(req, "202 Accepted");
+}
+
+/**
+ * @brief Renders the /OTAstatus body.
+ * @param buff destination buffer.
+ * @param buff_size size of the destination buffer.
+ * @param arg unused.
+ * @return body length.
+ */
+static int http_server_OTA_status_render(char *buff, size_t buff_size, void *arg)
+{
+    return snprintf(buff, buff_size, "{\"ota_update_status\":%d,\"compiled_time\":\"%s\",\"compiled_date\":\"%s\"}", g_fw_update_status, __TIME__, __DATE__);
+}
+
 /**
  * @brief OTA status handler responds with the firmware update status after the OTA update is started
  * and responds with the compiled time/date when the pafe is first requested.
@@ -311,18 +655,356 @@ esp_err_t http_server_OTA_update_handler(httpd_req_t *req)
  */
 esp_err_t http_server_OTA_status_handler(httpd_req_t *req)
 {
-    char otaJSON[256];
-
     ESP_LOGI(TAG, "OATstatus is requested.");
 
-    sprintf(otaJSON, "{\"ota_update_status\":%d,\"compiled_time\":\"%s\",\"compiled_date\":\"%s\"}", g_fw_update_status, __TIME__, __DATE__ );
+    // Rendered once per status change, see http_server_OTA_status_render()
+    return http_cache_send(req, http_server_ota_status_cache);
+}
+
+
+/**
+ * @brief Checks that every value of a socket pool configuration is in range.
+ * @param config configuration to check.
+ * @return true if the configuration can be applied.
+ */
+static bool http_server_config_valid(const http_server_config_t *config)
+{
+    // A shorter idle timeout would cut off long-polls and event streams between their answers and heartbeats
+    uint32_t idle_timeout_ms = (uint32_t)config->idle_timeout_s * 1000;
+
+    return (config->idle_timeout_s == 0 ||
+            (idle_timeout_ms > HTTP_API_LONGPOLL_TIMEOUT_MS && idle_timeout_ms > HTTP_SSE_KEEPALIVE_PERIOD_MS)) &&
+           config->max_open_sockets >= 1 && config->max_open_sockets <= HTTP_SERVER_MAX_SOCKETS &&
+           config->recv_wait_timeout_s >= 1 && config->send_wait_timeout_s >= 1 &&
+           (!config->keep_alive_enable ||
+            (config->keep_alive_idle_s >= 1 && config->keep_alive_interval_s >= 1 && config->keep_alive_count >= 1)) &&
+           (config->ratelimit_rate == 0 || config->ratelimit_burst >= 1);
+}
+
+/**
+ * @brief Loads the socket pool configuration from NVS, falling back to the defaults.
+ */
+static void http_server_load_config(void)
+{
+    nvs_handle_t handle;
+    http_server_config_t config;
+    size_t size = sizeof(config);
+
+    g_server_config = http_server_default_config;
+    if (nvs_open(HTTP_SERVER_NVS_NAMESPACE, NVS_READONLY, &handle) != ESP_OK)
+    {
+        // Nothing saved yet
+        return;
+    }
+    // A blob of a different size was written by another firmware version
+    if (nvs_get_blob(handle, HTTP_SERVER_NVS_KEY_CONFIG, &config, &size) == ESP_OK && size == sizeof(config) &&
+        http_server_config_valid(&config))
+    {
+        g_server_config = config;
+    }
+    nvs_close(handle);
+}
 
+void http_server_get_config(http_server_config_t *config)
+{
+    if (http_server_handle == NULL)
+    {
+        http_server_load_config();
+    }
+    *config = g_server_config;
+}
+
+esp_err_t http_server_set_config(const http_server_config_t *config)
+{
+    nvs_handle_t handle;
+
+    if (!http_server_config_valid(config))
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    esp_err_t err = nvs_open(HTTP_SERVER_NVS_NAMESPACE, NVS_READWRITE, &handle);
+    if (err != ESP_OK)
+    {
+        return err;
+    }
+    err = nvs_set_blob(handle, HTTP_SERVER_NVS_KEY_CONFIG, config, sizeof(*config));
+    if (err == ESP_OK)
+    {
+        err = nvs_commit(handle);
+    }
+    nvs_close(handle);
+
+    if (err == ESP_OK)
+    {
+        g_server_config = *config;
+        ESP_LOGI(TAG, "http_server_set_config: %u sockets, LRU purge %d, idle timeout %u s, applied on the next start",
+                 config->max_open_sockets, config->lru_purge_enable, config->idle_timeout_s);
+    }
+    return err;
+}
+
+/**
+ * @brief Renders the socket pool configuration as JSON.
+ * @param config configuration.
+ * @param buff destination buffer.
+ * @param buff_size size of buff.
+ * @return length of the JSON text.
+ */
+static int http_server_config_json(const http_server_config_t *config, char *buff, size_t buff_size)
+{
+    return snprintf(buff, buff_size,
+                    "{\"max_open_sockets\":%u,\"max_sockets\":%d,\"lru_purge\":%d,\"idle_timeout\":%u,"
+                    "\"keep_alive\":%d,\"keep_alive_idle\":%u,\"keep_alive_interval\":%u,\"keep_alive_count\":%u,"
+                    "\"recv_timeout\":%u,\"send_timeout\":%u,\"sock_recv_buf\":%u,\"ratelimit_rate\":%u,\"ratelimit_burst\":%u}",
+                    config->max_open_sockets, HTTP_SERVER_MAX_SOCKETS, config->lru_purge_enable, config->idle_timeout_s,
+                    config->keep_alive_enable, config->keep_alive_idle_s, config->keep_alive_interval_s, config->keep_alive_count,
+                    config->recv_wait_timeout_s, config->send_wait_timeout_s, config->sock_recv_buf,
+                    config->ratelimit_rate, config->ratelimit_burst);
+}
+
+/**
+ * @brief GET /api/server: reports the stored socket pool configuration.
+ * @param req HTTP request for which the uri needs to be handled.
+ * @param match router match (unused).
+ * @return result of the send.
+ */
+static esp_err_t http_server_config_get_handler(httpd_req_t *req, const http_router_match_t *match)
+{
+    char json[320];
+    http_server_config_t config;
+
+    http_server_get_config(&config);
+    int len = http_server_config_json(&config, json, sizeof(json));
+
+    httpd_resp_set_type(req, "application/json");
+    return httpd_resp_send(req, json, len);
+}
+
+/**
+ * @brief Reads one numeric field of a form encoded body.
+ * @param body form encoded body.
+ * @param key field name.
+ * @param max largest accepted value.
+ * @param value receives the value, left unchanged if the field is missing.
+ * @return false if the field is present but not a number up to max.
+ */
+static bool http_server_form_u32(const char *body, const char *key, uint32_t max, uint32_t *value)
+{
+    char buff[12];
+    char *end;
+
+    if (httpd_query_key_value(body, key, buff, sizeof(buff)) != ESP_OK)
+    {
+        return true;
+    }
+    uint32_t parsed = strtoul(buff, &end, 10);
+    if (end == buff || *end != '\0' || parsed > max)
+    {
+        return false;
+    }
+    *value = parsed;
+    return true;
+}
+
+/**
+ * @brief POST /api/server: changes fields of the socket pool configuration.
+ * The form encoded body carries any of max_open_sockets, lru_purge, idle_timeout, keep_alive, keep_alive_idle,
+ * keep_alive_interval, keep_alive_count, recv_timeout, send_timeout, sock_recv_buf, ratelimit_rate and ratelimit_burst;
+ * missing fields keep their value.
+ * @param req HTTP request for which the uri needs to be handled.
+ * @param match router match (unused).
+ * @return ESP_OK
+ */
+static esp_err_t http_server_config_post_handler(httpd_req_t *req, const http_router_match_t *match)
+{
+    char body[256];
+    char json[320];
+    http_server_config_t config;
+    uint32_t max_open_sockets, lru_purge, idle_timeout, keep_alive, keep_alive_idle, keep_alive_interval, keep_alive_count;
+    uint32_t recv_timeout, send_timeout, sock_recv_buf, ratelimit_rate, ratelimit_burst;
+
+    if (req->content_len == 0 || req->content_len >= sizeof(body) || !http_server_recv_exact(req, body, req->content_len))
+    {
+        httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, "Invalid configuration body");
+        return ESP_OK;
+    }
+    body[req->content_len] = '\0';
+
+    http_server_get_config(&config);
+    max_open_sockets = config.max_open_sockets;
+    lru_purge = config.lru_purge_enable;
+    idle_timeout = config.idle_timeout_s;
+    keep_alive = config.keep_alive_enable;
+    keep_alive_idle = config.keep_alive_idle_s;
+    keep_alive_interval = config.keep_alive_interval_s;
+    keep_alive_count = config.keep_alive_count;
+    recv_timeout = config.recv_wait_timeout_s;
+    send_timeout = config.send_wait_timeout_s;
+    sock_recv_buf = config.sock_recv_buf;
+    ratelimit_rate = config.ratelimit_rate;
+    ratelimit_burst = config.ratelimit_burst;
+
+    if (!http_server_form_u32(body, "max_open_sockets", UINT16_MAX, &max_open_sockets) ||
+        !http_server_form_u32(body, "lru_purge", 1, &lru_purge) ||
+        !http_server_form_u32(body, "idle_timeout", UINT16_MAX, &idle_timeout) ||
+        !http_server_form_u32(body, "keep_alive", 1, &keep_alive) ||
+        !http_server_form_u32(body, "keep_alive_idle", UINT16_MAX, &keep_alive_idle) ||
+        !http_server_form_u32(body, "keep_alive_interval", UINT16_MAX, &keep_alive_interval) ||
+        !http_server_form_u32(body, "keep_alive_count", UINT8_MAX, &keep_alive_count) ||
+        !http_server_form_u32(body, "recv_timeout", UINT16_MAX, &recv_timeout) ||
+        !http_server_form_u32(body, "send_timeout", UINT16_MAX, &send_timeout) ||
+        !http_server_form_u32(body, "sock_recv_buf", UINT16_MAX, &sock_recv_buf) ||
+        !http_server_form_u32(body, "ratelimit_rate", UINT16_MAX, &ratelimit_rate) ||
+        !http_server_form_u32(body, "ratelimit_burst", UINT16_MAX, &ratelimit_burst))
+    {
+        httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, "Invalid configuration value");
+        return ESP_OK;
+    }
+
+    config.max_open_sockets = max_open_sockets;
+    config.lru_purge_enable = lru_purge;
+    config.idle_timeout_s = idle_timeout;
+    config.keep_alive_enable = keep_alive;
+    config.keep_alive_idle_s = keep_alive_idle;
+    config.keep_alive_interval_s = keep_alive_interval;
+    config.keep_alive_count = keep_alive_count;
+    config.recv_wait_timeout_s = recv_timeout;
+    config.send_wait_timeout_s = send_timeout;
+    config.sock_recv_buf = sock_recv_buf;
+    config.ratelimit_rate = ratelimit_rate;
+    config.ratelimit_burst = ratelimit_burst;
+
+    esp_err_t err = http_server_set_config(&config);
+    if (err == ESP_ERR_INVALID_ARG)
+    {
+        httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, "Configuration out of range");
+        return ESP_OK;
+    }
+    if (err != ESP_OK)
+    {
+        httpd_resp_send_err(req, HTTPD_500_INTERNAL_SERVER_ERROR, "Cannot save configuration");
+        return ESP_OK;
+    }
+
+    int len = http_server_config_json(&config, json, sizeof(json));
     httpd_resp_set_type(req, "application/json");
-    httpd_resp_send(req, otaJSON, strlen(otaJSON));
+    return httpd_resp_send(req, json, len);
+}
+
+/**
+ * @brief Runs before every handler: applies the per-client rate limit.
+ * Firmware and web UI uploads are exempt, they are paced by the flash writes and must not be cut off halfway.
+ * httpd also calls the WebSocket handler for every frame; only the upgrade request takes a token, and as httpd
+ * has already sent 101 Switching Protocols by then, a throttled upgrade is closed instead of answered with 429.
+ * @param req HTTP request, not yet answered.
+ * @return true to dispatch the request, false if it was answered with 429 or its session is being closed.
+ */
+static bool http_server_request_hook(httpd_req_t *req)
+{
+    int sockfd = httpd_req_to_sockfd(req);
+
+    if (req->method == HTTP_POST &&
+        (strcmp(req->uri, "/OTAchunk") == 0 || strcmp(req->uri, "/OTAupdate") == 0 || strcmp(req->uri, "/webui") == 0))
+    {
+        return true;
+    }
+    if (httpd_ws_get_fd_info(req->handle, sockfd) == HTTPD_WS_CLIENT_WEBSOCKET)
+    {
+        if (req->method != HTTP_GET || http_ratelimit_allow(req))
+        {
+            return true;
+        }
+        httpd_sess_trigger_close(req->handle, sockfd);
+        return false;
+    }
+    return http_ratelimit_check(req);
+}
+
+/**
+ * @brief Closes the sessions that sent and received nothing for longer than the idle timeout (runs on the httpd task).
+ * WebSocket clients may legitimately go quiet for minutes (OTA topic only, long sample interval), and parked event
+ * streams and long-polls are owned by their modules, so only plain HTTP sessions are swept.
+ * @param arg unused.
+ */
+static void http_server_idle_sweep(void *arg)
+{
+    int client_fds[CONFIG_LWIP_MAX_SOCKETS];
+    size_t count = sizeof(client_fds) / sizeof(client_fds[0]);
+    http_metrics_sock_stats_t stats;
+
+    if (http_server_handle == NULL || httpd_get_client_list(http_server_handle, &count, client_fds) != ESP_OK)
+    {
+        return;
+    }
+
+    int64_t idle_limit_us = (int64_t)g_server_config.idle_timeout_s * 1000000;
+    int64_t now = esp_timer_get_time();
+    for (size_t i = 0; i < count; i++)
+    {
+        if (httpd_ws_get_fd_info(http_server_handle, client_fds[i]) == HTTPD_WS_CLIENT_WEBSOCKET ||
+            http_sse_has_sock(client_fds[i]) || http_api_has_sock(client_fds[i]))
+        {
+            continue;
+        }
+        if (http_metrics_get_sock_stats(client_fds[i], &stats) && now - stats.last_active_us > idle_limit_us)
+        {
+            ESP_LOGI(TAG, "http_server_idle_sweep: closing socket %d, idle for %lld s after %lu requests",
+                     client_fds[i], (now - stats.last_active_us) / 1000000, stats.requests);
+            http_metrics_sock_expire(client_fds[i]);
+            httpd_sess_trigger_close(http_server_handle, client_fds[i]);
+        }
+    }
+}
+
+/**
+ * @brief Idle sweep timer callback, hands the sweep to the httpd task.
+ * @param arg unused.
+ */
+static void http_server_idle_timer_callback(void *arg)
+{
+    if (http_server_handle != NULL)
+    {
+        httpd_queue_work(http_server_handle, http_server_idle_sweep, NULL);
+    }
+}
+
+/**
+ * @brief Called by httpd when a client socket is opened, applies the socket options and hooks the socket into the instrumentation layer.
+ * @param hd HTTP server handle.
+ * @param sockfd socket descriptor of the new session.
+ * @return ESP_OK to accept the session.
+ */
+static esp_err_t http_server_open_fn(httpd_handle_t hd, int sockfd)
+{
+    if (g_server_config.sock_recv_buf > 0)
+    {
+        int size = g_server_config.sock_recv_buf;
+        if (setsockopt(sockfd, SOL_SOCKET, SO_RCVBUF, &size, sizeof(size)) != 0)
+        {
+            ESP_LOGW(TAG, "http_server_open_fn: SO_RCVBUF not supported (enable CONFIG_LWIP_SO_RCVBUF)");
+        }
+    }
+
+    http_metrics_sock_open(hd, sockfd);
 
     return ESP_OK;
 }
 
+/**
+ * @brief Called by httpd when a client socket is closed. With a close_fn installed httpd leaves closing the socket to us.
+ * Parked requests of the session are released first, so nothing is sent on the descriptor once it is reused.
+ * @param hd HTTP server handle.
+ * @param sockfd socket descriptor of the session.
+ */
+static void http_server_close_fn(httpd_handle_t hd, int sockfd)
+{
+    http_metrics_sock_close(sockfd);
+    http_ws_sock_close(sockfd);
+    http_sse_sock_close(sockfd);
+    http_api_sock_close(sockfd);
+    close(sockfd);
+}
 
 /**
  * @brief Sets up the default httpd server configuration
@@ -351,9 +1033,32 @@ static httpd_handle_t http_server_configure(void)
     // Increase uri handler
     config.max_uri_handlers = 20;
 
-    // Increase timeout limit
-    config.recv_wait_timeout = 10;
-    config.send_wait_timeout = 10;
+    // Let "/api/*" reach the API router
+    config.uri_match_fn = httpd_uri_match_wildcard;
+
+    // Socket pool and session limits, tunable per deployment (GET/POST /api/server)
+    http_server_load_config();
+    config.max_open_sockets = g_server_config.max_open_sockets;
+    config.lru_purge_enable = g_server_config.lru_purge_enable;
+    config.recv_wait_timeout = g_server_config.recv_wait_timeout_s;
+    config.send_wait_timeout = g_server_config.send_wait_timeout_s;
+    config.keep_alive_enable = g_server_config.keep_alive_enable;
+    config.keep_alive_idle = g_server_config.keep_alive_idle_s;
+    config.keep_alive_interval = g_server_config.keep_alive_interval_s;
+    config.keep_alive_count = g_server_config.keep_alive_count;
+
+    // Per-client rate limit, checked before any handler runs
+    http_ratelimit_configure(g_server_config.ratelimit_rate, g_server_config.ratelimit_burst);
+    http_metrics_set_request_hook(http_server_request_hook);
+
+#ifdef CONFIG_IDF_TARGET_LINUX
+    // Host build for load testing (tools/loadtest/host) runs unprivileged
+    config.server_port = 8080;
+#endif
+
+    // Session hooks used by the instrumentation layer (per-socket byte and status accounting)
+    config.open_fn = http_server_open_fn;
+    config.close_fn = http_server_close_fn;
 
     ESP_LOGI(TAG, "http_server_configure: Starting server on port: '%d' with task priority '%d'", config.ctrl_port, config.task_priority);
 
@@ -362,75 +1067,133 @@ static httpd_handle_t http_server_configure(void)
     {
         ESP_LOGI(TAG, "http_server_configure: Registering URI handlers");
 
-        // resgiter the jquery handler
-        httpd_uri_t jquery_js =
+        // register web UI upload handler
+        webui_store_init();
+        httpd_uri_t webui_upload =
             {
-                .uri = "/jquery-3.3.1.min.js",
-                .method = HTTP_GET,
-                .handler = http_server_jquery_handler,
+                .uri = "/webui",
+                .method = HTTP_POST,
+                .handler = http_server_webui_upload_handler,
                 .user_ctx = NULL,
             };
-        httpd_register_uri_handler(http_server_handle, &jquery_js);
+        http_metrics_register_uri_handler(http_server_handle, &webui_upload);
 
-        // resgiter the index.html handler
-        httpd_uri_t index_html =
+        // register OTAupdate handler
+        httpd_uri_t OTA_update = 
             {
-                .uri = "/",
-                .method = HTTP_GET,
-                .handler = http_server_index_html_handler,
+                .uri = "/OTAupdate",
+                .method = HTTP_POST,
+                .handler = http_server_OTA_update_handler,
                 .user_ctx = NULL,
             };
-        httpd_register_uri_handler(http_server_handle, &index_html);
+        http_metrics_register_uri_handler(http_server_handle, &OTA_update);
 
-        // resgiter the app.css handler
-        httpd_uri_t app_css =
+        // register OTAstatus handler, answered from the response cache
+        http_cache_init();
+        http_server_ota_status_cache = http_cache_add("/OTAstatus", HTTP_CACHE_TOPIC_OTA, "application/json", http_server_OTA_status_render, NULL);
+        httpd_uri_t OTA_status = 
             {
-                .uri = "/app.css",
-                .method = HTTP_GET,
-                .handler = http_server_app_css_handler,
+                .uri = "/OTAstatus",
+                .method = HTTP_POST,
+                .handler = http_server_OTA_status_handler,
                 .user_ctx = NULL,
             };
-        httpd_register_uri_handler(http_server_handle, &app_css);
+        http_metrics_register_uri_handler(http_server_handle, &OTA_status);
 
-        // resgiter the app.js handler
-        httpd_uri_t app_js =
+        // register OTAresume handler
+        httpd_uri_t OTA_resume =
             {
-                .uri = "/app.js",
+                .uri = "/OTAresume",
                 .method = HTTP_GET,
-                .handler = http_server_app_js_handler,
+                .handler = http_server_OTA_resume_handler,
                 .user_ctx = NULL,
             };
-        httpd_register_uri_handler(http_server_handle, &app_js);
+        http_metrics_register_uri_handler(http_server_handle, &OTA_resume);
 
-        // resgiter the favicon.ico handler
-        httpd_uri_t favicon_ico =
+        // register OTAchunk handler
+        httpd_uri_t OTA_chunk =
             {
-                .uri = "/favicon.ico",
-                .method = HTTP_GET,
-                .handler = http_server_favicon_ico_handler,
+                .uri = "/OTAchunk",
+                .method = HTTP_POST,
+                .handler = http_server_OTA_chunk_handler,
                 .user_ctx = NULL,
             };
-        httpd_register_uri_handler(http_server_handle, &favicon_ico);
+        http_metrics_register_uri_handler(http_server_handle, &OTA_chunk);
 
-        // register OTAupdate handler
-        httpd_uri_t OTA_update = 
+        // register OTAfetch handler
+        httpd_uri_t OTA_fetch =
             {
-                .uri = "/OTAupdate",
+                .uri = "/OTAfetch",
                 .method = HTTP_POST,
-                .handler = http_server_OTA_update_handler,
+                .handler = http_server_OTA_fetch_handler,
                 .user_ctx = NULL,
             };
-        httpd_register_uri_handler(http_server_handle, &OTA_update);
+        http_metrics_register_uri_handler(http_server_handle, &OTA_fetch);
 
-        // register OTAstatus handler
-        httpd_uri_t OTA_status = 
+        // register metrics handler
+        httpd_uri_t metrics =
             {
-                .uri = "/OTAstatus",
-                .method = HTTP_POST,
-                .handler = http_server_OTA_status_handler,
+                .uri = "/metrics",
+                .method = HTTP_GET,
+                .handler = http_metrics_handler,
                 .user_ctx = NULL,
             };
-        httpd_register_uri_handler(http_server_handle, &OTA_status);
+        http_metrics_register_uri_handler(http_server_handle, &metrics);
+
+        // register the API routes, dispatched by the router below "/api/"
+        http_sse_init();
+        http_api_init();
+        http_router_add("/api/stream", HTTP_GET, http_sse_stream_handler, NULL);
+        http_router_add("/api/current", HTTP_GET, http_api_current_handler, NULL);
+        http_router_add("/api/history", HTTP_GET, http_api_history_handler, NULL);
+        http_router_add("/api/history.csv", HTTP_GET, http_api_history_csv_handler, NULL);
+        http_router_add("/api/settings", HTTP_GET, http_api_settings_get_handler, NULL);
+        http_router_add("/api/settings", HTTP_POST, http_api_settings_post_handler, NULL);
+        http_router_add("/api/sensors", HTTP_GET, http_api_sensors_handler, NULL);
+        http_router_add("/api/sensors/{id}", HTTP_GET, http_api_sensor_handler, NULL);
+        http_router_add("/api/sensors/{id}/history", HTTP_GET, http_api_history_handler, NULL);
+        http_router_add("/api/sensors/{id}/history.csv", HTTP_GET, http_api_history_csv_handler, NULL);
+        http_router_add("/api/server", HTTP_GET, http_server_config_get_handler, NULL);
+        http_router_add("/api/server", HTTP_POST, http_server_config_post_handler, NULL);
+        http_router_register(http_server_handle);
+
+        // register WebSocket telemetry handler
+        http_ws_init();
+        httpd_uri_t ws =
+            {
+                .uri = "/ws",
+                .method = HTTP_GET,
+                .handler = http_ws_handler,
+                .user_ctx = NULL,
+                .is_websocket = true,
+            };
+        http_metrics_register_uri_handler(http_server_handle, &ws);
+
+        // register web UI asset handler last, it matches every remaining GET
+        httpd_uri_t webui_asset =
+            {
+                .uri = "/*",
+                .method = HTTP_GET,
+                .handler = http_server_webui_asset_handler,
+                .user_ctx = NULL,
+            };
+        http_metrics_register_uri_handler(http_server_handle, &webui_asset);
+
+        // Close stale sessions so they do not hold sockets other clients are waiting for
+        if (g_server_config.idle_timeout_s > 0)
+        {
+            if (http_server_idle_timer == NULL)
+            {
+                const esp_timer_create_args_t idle_args = {
+                    .callback = &http_server_idle_timer_callback,
+                    .arg = NULL,
+                    .dispatch_method = ESP_TIMER_TASK,
+                    .name = "http_idle_sweep",
+                };
+                ESP_ERROR_CHECK(esp_timer_create(&idle_args, &http_server_idle_timer));
+            }
+            esp_timer_start_periodic(http_server_idle_timer, HTTP_SERVER_IDLE_SWEEP_MS * 1000ULL);
+        }
 
         return http_server_handle;
     }
@@ -449,6 +1212,12 @@ void http_server_stop(void)
 {
     if (http_server_handle)
     {
+        if (http_server_idle_timer != NULL)
+        {
+            esp_timer_stop(http_server_idle_timer);
+        }
+        http_sse_close_all();
+        http_api_close_all();
         httpd_stop(http_server_handle);
         ESP_LOGI(TAG, "http_server_stop: stopping HTTP server");
         http_server_handle = NULL;
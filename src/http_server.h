@@ -16,6 +16,10 @@
 #ifndef MAIN_HTTP_SERVER_H_
 #define MAIN_HTTP_SERVER_H_
 
+#include <stdbool.h>
+#include <stdint.h>
+#include "esp_err.h"
+#include "esp_http_server.h"
 #include "freertos/FreeRTOS.h"
 
 // OTA Update Status Constants
@@ -23,6 +27,35 @@
 #define OTA_UPDATE_SUCCESSFUL   1               ///< OTA update completed successfully
 #define OTA_UPDATE_FAILED       -1              ///< OTA update failed
 
+// Socket Pool Configuration Storage
+#define HTTP_SERVER_NVS_NAMESPACE       "http_server"   ///< NVS namespace holding the socket pool configuration
+#define HTTP_SERVER_NVS_KEY_CONFIG      "config"        ///< Blob key of http_server_config_t
+#define HTTP_SERVER_IDLE_SWEEP_MS       5000            ///< Period of the idle session sweep
+
+/**
+ * @brief Socket pool and session configuration
+ *
+ * Trades RAM against concurrency per deployment: every open socket costs an
+ * httpd session plus its lwIP buffers. Loaded from NVS when the server
+ * starts; changes made with http_server_set_config() (or POST /api/server)
+ * are applied the next time the server is started.
+ */
+typedef struct http_server_config
+{
+    uint16_t max_open_sockets;          ///< Client sockets, 1 to CONFIG_LWIP_MAX_SOCKETS - 3
+    bool lru_purge_enable;              ///< Close the least recently used session when a client connects to a full pool
+    uint16_t idle_timeout_s;            ///< Close sessions that sent and received nothing for this long, 0 to never close
+    bool keep_alive_enable;             ///< Send TCP keep-alive probes, drops clients that vanished without a FIN
+    uint16_t keep_alive_idle_s;         ///< Idle time before the first probe
+    uint16_t keep_alive_interval_s;     ///< Time between probes
+    uint8_t keep_alive_count;           ///< Unanswered probes before the connection is dropped
+    uint16_t recv_wait_timeout_s;       ///< Receive timeout of a request in progress
+    uint16_t send_wait_timeout_s;       ///< Send timeout of a response in progress
+    uint16_t sock_recv_buf;             ///< Receive buffer (SO_RCVBUF) of each client socket in bytes, 0 for the lwIP default
+    uint16_t ratelimit_rate;            ///< Sustained requests per second per client IP, 0 disables rate limiting
+    uint16_t ratelimit_burst;           ///< Requests a client IP may send at once
+} http_server_config_t;
+
 /**
  * @brief HTTP server message types for inter-task communication
  * 
@@ -87,6 +120,40 @@ void http_server_start(void);
  */
 void http_server_stop(void);
 
+/**
+ * @brief Get the socket pool configuration
+ *
+ * Returns the stored configuration, which is the one the running server
+ * uses unless it was changed since the server started.
+ *
+ * @param config Destination for the configuration
+ */
+void http_server_get_config(http_server_config_t *config);
+
+/**
+ * @brief Validate and persist a new socket pool configuration
+ *
+ * @param config New configuration
+ * @return ESP_OK on success, ESP_ERR_INVALID_ARG if a value is out of range,
+ *         otherwise the NVS error
+ *
+ * @note Applied the next time the server starts (reboot or WiFi reconnect)
+ */
+esp_err_t http_server_set_config(const http_server_config_t *config);
+
+/**
+ * @brief Receive exactly len bytes of a request body
+ *
+ * Loops over httpd_req_recv(), which may return part of the body, and
+ * retries on HTTPD_SOCK_ERR_TIMEOUT.
+ *
+ * @param req HTTP request
+ * @param buff Destination buffer
+ * @param len Number of bytes to receive
+ * @return true on success, false if the client went away
+ */
+bool http_server_recv_exact(httpd_req_t *req, void *buff, size_t len);
+
 /**
  * @brief Timer callback for firmware update reset
  * 
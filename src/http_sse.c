@@ -0,0 +1,300 @@
+/**
+ * @file http_sse.c
+ * @brief Server-Sent Events Stream Implementation for ESP32 Weather Station
+ * @details This file implements the GET /api/stream endpoint. Each stream is
+ *          an async request copy kept in a small fixed table. When the sensor
+ *          publishes a sample, a flush is queued onto the httpd task with
+ *          httpd_queue_work(); the flush writes the newest sample to every
+ *          client whose socket can take it without blocking. A client that
+ *          cannot keep up is skipped and receives only the newest sample once
+ *          it drains (latest-wins coalescing), so one slow dashboard never
+ *          stalls the server or the other streams. A periodic heartbeat keeps
+ *          idle connections alive, retries backpressured clients and detects
+ *          closed ones.
+ *
+ * @author christophermena
+ * @date July 30, 2025
+ * @version 1.0
+ * @note Last Updated: October 16, 2026
+ */
+
+#include <string.h>
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "lwip/sockets.h"
+
+#include "http_sse.h"
+#include "sensor_data.h"
+
+// Tag used for ESP serial console messages
+static const char TAG[] = "http_sse";
+
+/**
+ * @brief One open event stream
+ */
+typedef struct http_sse_client
+{
+    httpd_req_t *req;       ///< Async request copy, NULL if the slot is free
+    int sockfd;             ///< Socket of the stream
+    uint32_t last_seq;      ///< Sequence number of the last sample sent
+    uint32_t skipped;       ///< Samples coalesced away because the client was not ready
+} http_sse_client_t;
+
+// Stream table, only touched from the httpd task
+static http_sse_client_t g_clients[HTTP_SSE_MAX_CLIENTS];
+
+// Number of open streams, read by the sample listener
+static volatile int g_client_count = 0;
+
+// Server the streams belong to
+static httpd_handle_t g_server = NULL;
+
+// Set while a flush is queued, so a burst of samples queues only one
+static volatile bool g_flush_queued = false;
+
+// Heartbeat timer
+static esp_timer_handle_t http_sse_keepalive_timer = NULL;
+
+/**
+ * @brief Checks whether the socket can accept more data right now.
+ * @param sockfd socket descriptor.
+ * @return true if a send would not block.
+ */
+static bool http_sse_writable(int sockfd)
+{
+    fd_set write_fds;
+    struct timeval timeout = { 0 };
+
+    FD_ZERO(&write_fds);
+    FD_SET(sockfd, &write_fds);
+
+    return select(sockfd + 1, NULL, &write_fds, NULL, &timeout) > 0;
+}
+
+/**
+ * @brief Sends one sample as an SSE "sample" event.
+ * @param client stream to send to.
+ * @param sample sample to send.
+ * @return ESP_OK, otherwise the send error.
+ */
+static esp_err_t http_sse_send_sample(http_sse_client_t *client, const sensor_sample_t *sample)
+{
+    char event[160];
+    int len = snprintf(event, sizeof(event), "id: %lu\nevent: sample\ndata: ", sample->seq);
+    len += sensor_data_format_json(sample, event + len, sizeof(event) - len);
+    len += snprintf(event + len, sizeof(event) - len, "\n\n");
+
+    if (client->last_seq != 0 && sample->seq > client->last_seq + 1)
+    {
+        client->skipped += sample->seq - client->last_seq - 1;
+    }
+    client->last_seq = sample->seq;
+
+    return httpd_resp_send_chunk(client->req, event, len);
+}
+
+/**
+ * @brief Closes a stream and releases its slot.
+ * @param client stream to close.
+ */
+static void http_sse_drop(http_sse_client_t *client)
+{
+    ESP_LOGI(TAG, "http_sse_drop: stream on socket %d closed (%lu samples coalesced)", client->sockfd, client->skipped);
+
+    httpd_req_async_handler_complete(client->req);
+    memset(client, 0, sizeof(*client));
+    g_client_count--;
+}
+
+/**
+ * @brief Work item executed on the httpd task: pushes the newest sample to every ready stream.
+ * @param arg non-NULL for a heartbeat flush, which also pings idle streams.
+ */
+static void http_sse_flush(void *arg)
+{
+    bool heartbeat = (arg != NULL);
+    sensor_sample_t sample;
+
+    g_flush_queued = false;
+    bool have_sample = sensor_data_get_latest(&sample);
+
+    for (int i = 0; i < HTTP_SSE_MAX_CLIENTS; i++)
+    {
+        http_sse_client_t *client = &g_clients[i];
+        esp_err_t err = ESP_OK;
+
+        if (client->req == NULL)
+        {
+            continue;
+        }
+        // Backpressure: leave slow clients alone, they get the newest sample once they drain
+        if (!http_sse_writable(client->sockfd))
+        {
+            continue;
+        }
+
+        if (have_sample && sample.seq != client->last_seq)
+        {
+            err = http_sse_send_sample(client, &sample);
+        }
+        else if (heartbeat)
+        {
+            err = httpd_resp_send_chunk(client->req, ": keepalive\n\n", HTTPD_RESP_USE_STRLEN);
+        }
+
+        if (err != ESP_OK)
+        {
+            http_sse_drop(client);
+        }
+    }
+}
+
+/**
+ * @brief Queues a flush onto the httpd task.
+ * @param heartbeat true for the periodic heartbeat flush.
+ */
+static void http_sse_queue_flush(bool heartbeat)
+{
+    if (g_client_count == 0 || g_server == NULL)
+    {
+        return;
+    }
+    if (!heartbeat)
+    {
+        if (g_flush_queued)
+        {
+            return;
+        }
+        g_flush_queued = true;
+    }
+    if (httpd_queue_work(g_server, http_sse_flush, heartbeat ? (void *)1 : NULL) != ESP_OK)
+    {
+        g_flush_queued = false;
+    }
+}
+
+/**
+ * @brief Sample listener, runs in the sensor task and only schedules the flush.
+ * @param sample published sample (read again by the flush).
+ */
+static void http_sse_sample_listener(const sensor_sample_t *sample)
+{
+    http_sse_queue_flush(false);
+}
+
+/**
+ * @brief Heartbeat timer callback.
+ * @param arg unused.
+ */
+static void http_sse_keepalive_callback(void *arg)
+{
+    http_sse_queue_flush(true);
+}
+
+void http_sse_init(void)
+{
+    if (http_sse_keepalive_timer != NULL)
+    {
+        return;
+    }
+
+    const esp_timer_create_args_t keepalive_args = {
+        .callback = &http_sse_keepalive_callback,
+        .arg = NULL,
+        .dispatch_method = ESP_TIMER_TASK,
+        .name = "sse_keepalive",
+    };
+    ESP_ERROR_CHECK(esp_timer_create(&keepalive_args, &http_sse_keepalive_timer));
+    ESP_ERROR_CHECK(esp_timer_start_periodic(http_sse_keepalive_timer, HTTP_SSE_KEEPALIVE_PERIOD_MS * 1000ULL));
+
+    sensor_data_add_listener(http_sse_sample_listener);
+}
+
+esp_err_t http_sse_stream_handler(httpd_req_t *req, const http_router_match_t *match)
+{
+    http_sse_client_t *client = NULL;
+    sensor_sample_t sample;
+    char prelude[24];
+
+    for (int i = 0; i < HTTP_SSE_MAX_CLIENTS; i++)
+    {
+        if (g_clients[i].req == NULL)
+        {
+            client = &g_clients[i];
+            break;
+        }
+    }
+    if (client == NULL)
+    {
+        httpd_resp_set_status(req, "503 Service Unavailable");
+        httpd_resp_set_hdr(req, "Retry-After", "30");
+        httpd_resp_sendstr(req, "Too many streams");
+        return ESP_OK;
+    }
+
+    // Park the request: from here on the stream lives in the table, not on the httpd task
+    if (httpd_req_async_handler_begin(req, &client->req) != ESP_OK)
+    {
+        client->req = NULL;
+        return ESP_FAIL;
+    }
+    client->sockfd = httpd_req_to_sockfd(client->req);
+    client->last_seq = 0;
+    client->skipped = 0;
+    g_client_count++;
+    g_server = req->handle;
+
+    httpd_resp_set_type(client->req, "text/event-stream");
+    httpd_resp_set_hdr(client->req, "Cache-Control", "no-cache");
+
+    // First chunk carries the headers and the reconnect delay, followed by the current sample
+    snprintf(prelude, sizeof(prelude), "retry: %d\n\n", HTTP_SSE_RETRY_MS);
+    esp_err_t err = httpd_resp_send_chunk(client->req, prelude, HTTPD_RESP_USE_STRLEN);
+    if (err == ESP_OK && sensor_data_get_latest(&sample))
+    {
+        err = http_sse_send_sample(client, &sample);
+    }
+    if (err != ESP_OK)
+    {
+        http_sse_drop(client);
+        return ESP_OK;
+    }
+
+    ESP_LOGI(TAG, "http_sse_stream_handler: stream opened on socket %d (%d open)", client->sockfd, g_client_count);
+    return ESP_OK;
+}
+
+void http_sse_close_all(void)
+{
+    for (int i = 0; i < HTTP_SSE_MAX_CLIENTS; i++)
+    {
+        if (g_clients[i].req != NULL)
+        {
+            http_sse_drop(&g_clients[i]);
+        }
+    }
+    g_server = NULL;
+}
+
+bool http_sse_has_sock(int sockfd)
+{
+    for (int i = 0; i < HTTP_SSE_MAX_CLIENTS; i++)
+    {
+        if (g_clients[i].req != NULL && g_clients[i].sockfd == sockfd)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+void http_sse_sock_close(int sockfd)
+{
+    for (int i = 0; i < HTTP_SSE_MAX_CLIENTS; i++)
+    {
+        if (g_clients[i].req != NULL && g_clients[i].sockfd == sockfd)
+        {
+            http_sse_drop(&g_clients[i]);
+        }
+    }
+}
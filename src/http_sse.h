@@ -0,0 +1,68 @@
+/**
+ * @file http_sse.h
+ * @brief Server-Sent Events Stream Header for ESP32 Weather Station
+ * @details This header file defines the interface of the GET /api/stream
+ *          endpoint. Clients open one long-lived connection and receive every
+ *          new sensor sample as an SSE "sample" event, instead of polling the
+ *          server. Connections are parked with esp_http_server's async request
+ *          support, so an open stream does not occupy the httpd task.
+ *
+ * @author christophermena
+ * @date July 30, 2025
+ * @version 1.0
+ * @note Last Updated: October 16, 2026
+ */
+
+#ifndef MAIN_HTTP_SSE_H_
+#define MAIN_HTTP_SSE_H_
+
+#include "esp_http_server.h"
+
+#include "http_router.h"
+
+// SSE Stream Configuration
+#define HTTP_SSE_MAX_CLIENTS            10          ///< Concurrent streams (each holds one of the httpd sockets)
+#define HTTP_SSE_KEEPALIVE_PERIOD_MS    15000       ///< Heartbeat period, also retries clients that were backpressured
+#define HTTP_SSE_RETRY_MS               5000        ///< Reconnect delay advertised to EventSource clients
+
+/**
+ * @brief Register the sample listener and heartbeat timer
+ * @note Call once before the HTTP server starts accepting /api/stream requests
+ */
+void http_sse_init(void);
+
+/**
+ * @brief GET /api/stream handler
+ *
+ * Sends the event-stream headers and the latest sample, then hands the
+ * connection over to the stream table. Responds 503 if all stream slots are
+ * in use.
+ *
+ * @param req HTTP request to respond to
+ * @param match Route match (unused)
+ * @return ESP_OK, otherwise ESP_FAIL if the connection could not be parked
+ */
+esp_err_t http_sse_stream_handler(httpd_req_t *req, const http_router_match_t *match);
+
+/**
+ * @brief Terminate all open streams
+ * @note Must be called before httpd_stop()
+ */
+void http_sse_close_all(void);
+
+/**
+ * @brief Check whether a socket carries an open event stream
+ * @param sockfd Socket descriptor
+ * @return true if the socket is parked in the stream table
+ * @note Call from the httpd task only
+ */
+bool http_sse_has_sock(int sockfd);
+
+/**
+ * @brief Release the stream of a closed socket without sending on it
+ * @param sockfd Closed socket
+ * @note Called from the httpd close_fn
+ */
+void http_sse_sock_close(int sockfd);
+
+#endif /* MAIN_HTTP_SSE_H_ */
@@ -0,0 +1,429 @@
+/**
+ * @file http_ws.c
+ * @brief WebSocket Telemetry Channel Implementation for ESP32 Weather Station
+ * @details This file implements the /ws endpoint. Publishers (sensor listener,
+ *          health timer, OTA code) encode each event once into the latest
+ *          frame of its topic and queue a flush onto the httpd task. The
+ *          flush walks the subscriber table and sends the stored frame to
+ *          every client that is subscribed, has not seen it yet and whose
+ *          rate limit allows it. Clients that are rate limited or whose socket
+ *          is not writable keep the topic pending and receive the newest
+ *          frame later (latest-wins), scheduled by a one-shot timer.
+ *
+ * @author christophermena
+ * @date July 30, 2025
+ * @version 1.0
+ * @note Last Updated: October 16, 2026
+ */
+
+#include <stdint.h>
+#include <string.h>
+#include "esp_bit_defs.h"
+#include "esp_log.h"
+#include "esp_system.h"
+#include "esp_timer.h"
+#include "lwip/sockets.h"
+#include "sys/param.h"
+
+#include "http_server.h"
+#include "http_ws.h"
+#include "sensor_data.h"
+
+// Tag used for ESP serial console messages
+static const char TAG[] = "http_ws";
+
+#define HTTP_WS_HEADER_SIZE             8           ///< Common header of all server frames
+#define HTTP_WS_FRAME_MAX_SIZE          24          ///< Header plus the largest payload (health)
+#define HTTP_WS_BACKPRESSURE_RETRY_US   200000      ///< Retry delay for clients whose socket is full
+
+/**
+ * @brief Latest encoded frame of a topic
+ */
+typedef struct http_ws_topic
+{
+    uint32_t seq;                               ///< Event sequence number, 0 if nothing was published yet
+    uint8_t len;                                ///< Frame length
+    uint8_t frame[HTTP_WS_FRAME_MAX_SIZE];      ///< Encoded frame, shared by all subscribers
+} http_ws_topic_t;
+
+/**
+ * @brief One connected WebSocket client
+ */
+typedef struct http_ws_client
+{
+    int sockfd;                                     ///< Socket, -1 if the slot is free
+    uint8_t mask;                                   ///< Subscribed topics
+    uint16_t interval_ms[HTTP_WS_TOPIC_COUNT];      ///< Minimum interval per topic
+    uint32_t sent_seq[HTTP_WS_TOPIC_COUNT];         ///< Last event sent per topic
+    int64_t last_sent_us[HTTP_WS_TOPIC_COUNT];      ///< Time of the last send per topic
+} http_ws_client_t;
+
+// Latest frame per topic, written by publishers in any task
+static http_ws_topic_t g_topics[HTTP_WS_TOPIC_COUNT];
+static portMUX_TYPE http_ws_lock = portMUX_INITIALIZER_UNLOCKED;
+
+// Subscriber table, only touched from the httpd task
+static http_ws_client_t g_clients[HTTP_WS_MAX_CLIENTS];
+static volatile int g_client_count = 0;
+
+// Server the clients belong to
+static httpd_handle_t g_server = NULL;
+
+// Set while a flush is queued, so a burst of events queues only one
+static volatile bool g_flush_queued = false;
+
+// Health period timer and the timer for deferred (rate limited / backpressured) sends
+static esp_timer_handle_t http_ws_health_timer = NULL;
+static esp_timer_handle_t http_ws_defer_timer = NULL;
+
+/**
+ * @brief Stores a 16 bit value little-endian.
+ */
+static void http_ws_put_u16(uint8_t *p, uint16_t value)
+{
+    p[0] = value & 0xFF;
+    p[1] = value >> 8;
+}
+
+/**
+ * @brief Stores a 32 bit value little-endian.
+ */
+static void http_ws_put_u32(uint8_t *p, uint32_t value)
+{
+    p[0] = value & 0xFF;
+    p[1] = (value >> 8) & 0xFF;
+    p[2] = (value >> 16) & 0xFF;
+    p[3] = value >> 24;
+}
+
+/**
+ * @brief Checks whether the socket can accept more data right now.
+ * @param sockfd socket descriptor.
+ * @return true if a send would not block.
+ */
+static bool http_ws_writable(int sockfd)
+{
+    fd_set write_fds;
+    struct timeval timeout = { 0 };
+
+    FD_ZERO(&write_fds);
+    FD_SET(sockfd, &write_fds);
+
+    return select(sockfd + 1, NULL, &write_fds, NULL, &timeout) > 0;
+}
+
+/**
+ * @brief Returns the table entry of a socket.
+ * @param sockfd socket descriptor, -1 returns a free slot.
+ * @return client entry or NULL.
+ */
+static http_ws_client_t *http_ws_get_client(int sockfd)
+{
+    for (int i = 0; i < HTTP_WS_MAX_CLIENTS; i++)
+    {
+        if (g_clients[i].sockfd == sockfd)
+        {
+            return &g_clients[i];
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @brief Work item executed on the httpd task: sends pending topic frames to all subscribers.
+ * @param arg unused.
+ */
+static void http_ws_flush(void *arg)
+{
+    http_ws_topic_t topics[HTTP_WS_TOPIC_COUNT];
+    int64_t now = esp_timer_get_time();
+    int64_t next_due = INT64_MAX;
+
+    g_flush_queued = false;
+
+    portENTER_CRITICAL(&http_ws_lock);
+    memcpy(topics, g_topics, sizeof(topics));
+    portEXIT_CRITICAL(&http_ws_lock);
+
+    for (int i = 0; i < HTTP_WS_MAX_CLIENTS; i++)
+    {
+        http_ws_client_t *client = &g_clients[i];
+        bool checked_writable = false;
+
+        if (client->sockfd < 0)
+        {
+            continue;
+        }
+
+        for (int topic = 0; topic < HTTP_WS_TOPIC_COUNT; topic++)
+        {
+            if (!(client->mask & BIT(topic)) || topics[topic].seq == 0 || client->sent_seq[topic] == topics[topic].seq)
+            {
+                continue;
+            }
+
+            int64_t due = client->last_sent_us[topic] + client->interval_ms[topic] * 1000LL;
+            if (now < due)
+            {
+                next_due = MIN(next_due, due);
+                continue;
+            }
+
+            // Backpressure: keep the topic pending, the client gets the newest frame once it drains
+            if (!checked_writable)
+            {
+                if (!http_ws_writable(client->sockfd))
+                {
+                    next_due = MIN(next_due, now + HTTP_WS_BACKPRESSURE_RETRY_US);
+                    break;
+                }
+                checked_writable = true;
+            }
+
+            httpd_ws_frame_t frame = {
+                .final = true,
+                .type = HTTPD_WS_TYPE_BINARY,
+                .payload = topics[topic].frame,
+                .len = topics[topic].len,
+            };
+            if (httpd_ws_send_frame_async(g_server, client->sockfd, &frame) != ESP_OK)
+            {
+                ESP_LOGI(TAG, "http_ws_flush: send failed, closing socket %d", client->sockfd);
+                httpd_sess_trigger_close(g_server, client->sockfd);
+                client->sockfd = -1;
+                g_client_count--;
+                break;
+            }
+            client->sent_seq[topic] = topics[topic].seq;
+            client->last_sent_us[topic] = now;
+        }
+    }
+
+    if (next_due != INT64_MAX)
+    {
+        esp_timer_stop(http_ws_defer_timer);
+        esp_timer_start_once(http_ws_defer_timer, MAX(next_due - now, 1000));
+    }
+}
+
+/**
+ * @brief Queues a flush onto the httpd task.
+ */
+static void http_ws_queue_flush(void)
+{
+    if (g_client_count == 0 || g_server == NULL || g_flush_queued)
+    {
+        return;
+    }
+    g_flush_queued = true;
+    if (httpd_queue_work(g_server, http_ws_flush, NULL) != ESP_OK)
+    {
+        g_flush_queued = false;
+    }
+}
+
+/**
+ * @brief Encodes an event as the latest frame of its topic and schedules the broadcast.
+ * @param topic HTTP_WS_TOPIC_*.
+ * @param payload topic payload.
+ * @param len payload length.
+ */
+static void http_ws_publish(int topic, const uint8_t *payload, size_t len)
+{
+    portENTER_CRITICAL(&http_ws_lock);
+    http_ws_topic_t *entry = &g_topics[topic];
+    entry->seq++;
+    entry->frame[0] = topic;
+    entry->frame[1] = HTTP_WS_FRAME_VERSION;
+    http_ws_put_u16(&entry->frame[2], 0);
+    http_ws_put_u32(&entry->frame[4], entry->seq);
+    memcpy(&entry->frame[HTTP_WS_HEADER_SIZE], payload, len);
+    entry->len = HTTP_WS_HEADER_SIZE + len;
+    portEXIT_CRITICAL(&http_ws_lock);
+
+    http_ws_queue_flush();
+}
+
+/**
+ * @brief Sample listener, encodes the sample topic.
+ * @param sample published sample.
+ */
+static void http_ws_sample_listener(const sensor_sample_t *sample)
+{
+    uint8_t payload[8];
+
+    http_ws_put_u32(&payload[0], (uint32_t)sample->timestamp);
+    http_ws_put_u16(&payload[4], (uint16_t)(int16_t)sample->temperature);
+    payload[6] = (uint8_t)sample->humidity;
+    payload[7] = 0;
+
+    http_ws_publish(HTTP_WS_TOPIC_SAMPLE, payload, sizeof(payload));
+}
+
+/**
+ * @brief Health timer callback, encodes the health topic.
+ * @param arg unused.
+ */
+static void http_ws_health_callback(void *arg)
+{
+    uint8_t payload[16];
+
+    // Nobody listens, skip the encode
+    if (g_client_count == 0)
+    {
+        return;
+    }
+
+    http_ws_put_u32(&payload[0], (uint32_t)(esp_timer_get_time() / 1000000));
+    http_ws_put_u32(&payload[4], esp_get_free_heap_size());
+    http_ws_put_u32(&payload[8], esp_get_minimum_free_heap_size());
+    http_ws_put_u32(&payload[12], sensor_data_get_error_count());
+
+    http_ws_publish(HTTP_WS_TOPIC_HEALTH, payload, sizeof(payload));
+}
+
+/**
+ * @brief Deferred send timer callback.
+ * @param arg unused.
+ */
+static void http_ws_defer_callback(void *arg)
+{
+    http_ws_queue_flush();
+}
+
+void http_ws_init(void)
+{
+    if (http_ws_health_timer != NULL)
+    {
+        return;
+    }
+
+    for (int i = 0; i < HTTP_WS_MAX_CLIENTS; i++)
+    {
+        g_clients[i].sockfd = -1;
+    }
+
+    const esp_timer_create_args_t health_args = {
+        .callback = &http_ws_health_callback,
+        .arg = NULL,
+        .dispatch_method = ESP_TIMER_TASK,
+        .name = "ws_health",
+    };
+    ESP_ERROR_CHECK(esp_timer_create(&health_args, &http_ws_health_timer));
+    ESP_ERROR_CHECK(esp_timer_start_periodic(http_ws_health_timer, HTTP_WS_HEALTH_PERIOD_MS * 1000ULL));
+
+    const esp_timer_create_args_t defer_args = {
+        .callback = &http_ws_defer_callback,
+        .arg = NULL,
+        .dispatch_method = ESP_TIMER_TASK,
+        .name = "ws_defer",
+    };
+    ESP_ERROR_CHECK(esp_timer_create(&defer_args, &http_ws_defer_timer));
+
+    sensor_data_add_listener(http_ws_sample_listener);
+}
+
+void http_ws_publish_ota(int status, uint32_t committed, uint32_t image_size)
+{
+    uint8_t payload[12];
+
+    payload[0] = (uint8_t)(int8_t)status;
+    payload[1] = payload[2] = payload[3] = 0;
+    http_ws_put_u32(&payload[4], committed);
+    http_ws_put_u32(&payload[8], image_size);
+
+    http_ws_publish(HTTP_WS_TOPIC_OTA, payload, sizeof(payload));
+}
+
+esp_err_t http_ws_handler(httpd_req_t *req)
+{
+    int sockfd = httpd_req_to_sockfd(req);
+    http_ws_client_t *client;
+
+    // The handshake has been answered by httpd, register the new client
+    if (req->method == HTTP_GET)
+    {
+        client = http_ws_get_client(-1);
+        if (client == NULL)
+        {
+            ESP_LOGI(TAG, "http_ws_handler: client table full, rejecting socket %d", sockfd);
+            return ESP_FAIL;
+        }
+        memset(client, 0, sizeof(*client));
+        client->sockfd = sockfd;
+        g_client_count++;
+        g_server = req->handle;
+
+        ESP_LOGI(TAG, "http_ws_handler: client connected on socket %d (%d open)", sockfd, g_client_count);
+        return ESP_OK;
+    }
+
+    uint8_t cmd[4];
+    httpd_ws_frame_t frame = { 0 };
+
+    // Read the frame length first, commands are a few bytes at most
+    esp_err_t err = httpd_ws_recv_frame(req, &frame, 0);
+    if (err != ESP_OK)
+    {
+        return err;
+    }
+    if (frame.type != HTTPD_WS_TYPE_BINARY || frame.len < 2 || frame.len > sizeof(cmd))
+    {
+        ESP_LOGI(TAG, "http_ws_handler: invalid command frame (type %d, %d bytes)", frame.type, frame.len);
+        return ESP_ERR_INVALID_ARG;
+    }
+    frame.payload = cmd;
+    err = httpd_ws_recv_frame(req, &frame, sizeof(cmd));
+    if (err != ESP_OK)
+    {
+        return err;
+    }
+
+    client = http_ws_get_client(sockfd);
+    if (client == NULL)
+    {
+        return ESP_FAIL;
+    }
+
+    uint8_t mask = cmd[1] & (BIT(HTTP_WS_TOPIC_COUNT) - 1);
+    switch (cmd[0])
+    {
+    case HTTP_WS_CMD_SUBSCRIBE:
+        {
+            uint16_t interval_ms = (frame.len >= 4) ? (cmd[2] | (cmd[3] << 8)) : 0;
+            for (int topic = 0; topic < HTTP_WS_TOPIC_COUNT; topic++)
+            {
+                if (mask & BIT(topic))
+                {
+                    // Newly subscribed topics deliver their latest event right away
+                    client->interval_ms[topic] = interval_ms;
+                    client->sent_seq[topic] = 0;
+                    client->last_sent_us[topic] = 0;
+                }
+            }
+            client->mask |= mask;
+            http_ws_flush(NULL);
+        }
+        break;
+
+    case HTTP_WS_CMD_UNSUBSCRIBE:
+        client->mask &= ~mask;
+        break;
+
+    default:
+        ESP_LOGI(TAG, "http_ws_handler: unknown command 0x%02x", cmd[0]);
+        break;
+    }
+
+    return ESP_OK;
+}
+
+void http_ws_sock_close(int sockfd)
+{
+    http_ws_client_t *client = http_ws_get_client(sockfd);
+    if (client != NULL)
+    {
+        client->sockfd = -1;
+        g_client_count--;
+    }
+}
@@ -0,0 +1,82 @@
+/**
+ * @file http_ws.h
+ * @brief WebSocket Telemetry Channel Header for ESP32 Weather Station
+ * @details This header file defines the /ws endpoint and its binary frame
+ *          format. Clients subscribe to topics (samples, health, OTA events)
+ *          and choose a minimum interval per topic. Every event is serialized
+ *          once by the broadcaster and the same frame is sent to all
+ *          subscribers, so adding a client costs one send, not one encode.
+ *
+ *          Server to client frames (binary, little-endian):
+ *          | offset | size | field                                   |
+ *          |--------|------|-----------------------------------------|
+ *          | 0      | 1    | topic (HTTP_WS_TOPIC_*)                 |
+ *          | 1      | 1    | frame version (HTTP_WS_FRAME_VERSION)   |
+ *          | 2      | 2    | reserved, 0                             |
+ *          | 4      | 4    | event sequence number of the topic      |
+ *          | 8      | n    | topic payload, see below                |
+ *
+ *          Sample payload (8 bytes): u32 time, i16 temperature (C), u8 humidity (%), u8 reserved
+ *          Health payload (16 bytes): u32 uptime (s), u32 free heap, u32 minimum free heap, u32 sensor errors
+ *          OTA payload (12 bytes): i8 status (OTA_UPDATE_*), u8 reserved[3], u32 committed bytes, u32 image size
+ *
+ *          Client to server frames (binary):
+ *          SUBSCRIBE:   [0x01, topic mask, u16 minimum interval in ms]
+ *          UNSUBSCRIBE: [0x02, topic mask]
+ *
+ * @author christophermena
+ * @date July 30, 2025
+ * @version 1.0
+ * @note Last Updated: October 16, 2026
+ */
+
+#ifndef MAIN_HTTP_WS_H_
+#define MAIN_HTTP_WS_H_
+
+#include <stdint.h>
+#include "esp_http_server.h"
+
+// WebSocket Channel Configuration
+#define HTTP_WS_MAX_CLIENTS             5           ///< Matches WIFI_AP_MAX_CONNECTIONS
+#define HTTP_WS_HEALTH_PERIOD_MS        10000       ///< Period of the health topic
+#define HTTP_WS_FRAME_VERSION           1           ///< Version byte of every server frame
+
+// Topics (bit positions in the subscription mask)
+#define HTTP_WS_TOPIC_SAMPLE            0           ///< New sensor sample
+#define HTTP_WS_TOPIC_HEALTH            1           ///< Periodic device health
+#define HTTP_WS_TOPIC_OTA               2           ///< OTA state change
+#define HTTP_WS_TOPIC_COUNT             3
+
+// Client commands
+#define HTTP_WS_CMD_SUBSCRIBE           0x01
+#define HTTP_WS_CMD_UNSUBSCRIBE         0x02
+
+/**
+ * @brief Register the sample listener and start the health timer
+ * @note Call once before the HTTP server starts accepting /ws connections
+ */
+void http_ws_init(void);
+
+/**
+ * @brief /ws handler: accepts the handshake and processes client commands
+ * @param req HTTP request (handshake) or received WebSocket frame
+ * @return ESP_OK, otherwise an error to close the connection
+ */
+esp_err_t http_ws_handler(httpd_req_t *req);
+
+/**
+ * @brief Remove a socket from the subscriber table
+ * @param sockfd Closed socket
+ * @note Called from the httpd close_fn
+ */
+void http_ws_sock_close(int sockfd);
+
+/**
+ * @brief Broadcast an OTA state change to the OTA topic
+ * @param status OTA_UPDATE_PENDING, OTA_UPDATE_SUCCESSFUL or OTA_UPDATE_FAILED
+ * @param committed Bytes of the image written so far
+ * @param image_size Total image size, 0 if unknown
+ */
+void http_ws_publish_ota(int status, uint32_t committed, uint32_t image_size);
+
+#endif /* MAIN_HTTP_WS_H_ */
@@ -0,0 +1,373 @@
+/**
+ * @file i2c_bus.c
+ * @brief Shared I2C Master Bus Implementation for ESP32 Weather Station
+ * @details This file creates the I2C master bus on first use, attaches
+ *          devices to it and runs the arbiter task that owns it. The bus
+ *          keeps its internal pull-ups enabled so a module without its own
+ *          resistors still works at 100kHz. Transactions are copied into
+ *          per-device FreeRTOS queues together with a sequence number; the
+ *          arbiter peeks at the head of every queue, takes the one of the
+ *          highest priority (the lowest sequence number among equals) and
+ *          sends it with the blocking i2c_master calls, so the driver itself
+ *          never holds more than the transaction on the bus. The device table
+ *          is static and guarded by a mutex against attach and detach; the
+ *          counters by a critical section.
+ *
+ * @author christophermena
+ * @date July 30, 2025
+ * @version 1.0
+ * @note Last Updated: October 16, 2026
+ */
+
+#include <string.h>
+
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/queue.h"
+#include "freertos/semphr.h"
+#include "freertos/task.h"
+
+#include "i2c_bus.h"
+#include "tasks_common.h"
+
+// Tag used for ESP serial console messages
+static const char TAG[] = "i2c_bus";
+
+/**
+ * @brief Queued transaction
+ */
+typedef struct i2c_bus_trans
+{
+    const uint8_t *write_buffer;        ///< Bytes to write, NULL for none
+    size_t write_size;                  ///< Number of bytes to write
+    uint8_t *read_buffer;               ///< Receives the bytes read, NULL for none
+    size_t read_size;                   ///< Number of bytes to read
+    i2c_bus_done_cb_t done;             ///< Completion callback, NULL for none
+    void *arg;                          ///< Argument of the callback
+    uint32_t seq;                       ///< Submission order across all devices
+    int64_t queued_us;                  ///< Time it was queued
+} i2c_bus_trans_t;
+
+/**
+ * @brief Attached device
+ */
+struct i2c_bus_dev
+{
+    i2c_master_dev_handle_t handle;     ///< i2c_master device, NULL for a free table entry
+    QueueHandle_t queue;                ///< Transactions waiting for the bus
+    SemaphoreHandle_t sync_done;        ///< Given when an i2c_bus_transfer() transaction is done
+    esp_err_t sync_result;              ///< Its result
+    i2c_bus_stats_t stats;              ///< Counters
+};
+
+// Bus handle, created by i2c_bus_init()
+static i2c_master_bus_handle_t i2c_bus_handle = NULL;
+
+// Arbiter task, notified for every queued transaction
+static TaskHandle_t task_i2c_bus = NULL;
+
+// Device table; the mutex keeps attach and detach out of the arbiter's queue scan
+static struct i2c_bus_dev i2c_bus_devices[I2C_BUS_MAX_DEVICES];
+static SemaphoreHandle_t i2c_bus_devices_mutex = NULL;
+
+// Sequence number of the next transaction, and the bus time of all devices
+static uint32_t i2c_bus_seq = 0;
+static uint64_t i2c_bus_busy_us = 0;
+
+// Protects the sequence number and the counters
+static portMUX_TYPE i2c_bus_lock = portMUX_INITIALIZER_UNLOCKED;
+
+/**
+ * @brief Takes the next transaction off the queues: highest priority first, then submission order.
+ * @param trans receives the transaction.
+ * @return its device, NULL if every queue is empty.
+ */
+static struct i2c_bus_dev *i2c_bus_next(i2c_bus_trans_t *trans)
+{
+    struct i2c_bus_dev *next = NULL;
+    i2c_bus_trans_t head;
+
+    xSemaphoreTake(i2c_bus_devices_mutex, portMAX_DELAY);
+    for (int i = 0; i < I2C_BUS_MAX_DEVICES; i++)
+    {
+        struct i2c_bus_dev *dev = &i2c_bus_devices[i];
+        if (dev->handle == NULL || xQueuePeek(dev->queue, &head, 0) != pdTRUE)
+        {
+            continue;
+        }
+        if (next == NULL || dev->stats.priority > next->stats.priority
+            || (dev->stats.priority == next->stats.priority && (int32_t)(head.seq - trans->seq) < 0))
+        {
+            next = dev;
+            *trans = head;
+        }
+    }
+    if (next != NULL)
+    {
+        xQueueReceive(next->queue, trans, 0);           // Only this task receives, the head is unchanged
+    }
+    xSemaphoreGive(i2c_bus_devices_mutex);
+    return next;
+}
+
+/**
+ * @brief Sends one transaction, counts it and reports its completion.
+ * @param dev device addressed.
+ * @param trans transaction.
+ */
+static void i2c_bus_run(struct i2c_bus_dev *dev, const i2c_bus_trans_t *trans)
+{
+    esp_err_t err = ESP_OK;
+    int64_t start_us = esp_timer_get_time();
+
+    if (trans->write_size > 0 && trans->read_size > 0)
+    {
+        err = i2c_master_transmit_receive(dev->handle, trans->write_buffer, trans->write_size,
+                                          trans->read_buffer, trans->read_size, I2C_BUS_TIMEOUT_MS);
+    }
+    else if (trans->write_size > 0)
+    {
+        err = i2c_master_transmit(dev->handle, trans->write_buffer, trans->write_size, I2C_BUS_TIMEOUT_MS);
+    }
+    else if (trans->read_size > 0)
+    {
+        err = i2c_master_receive(dev->handle, trans->read_buffer, trans->read_size, I2C_BUS_TIMEOUT_MS);
+    }
+
+    // A marker (nothing to send) only reports that everything before it is done
+    if (trans->write_size > 0 || trans->read_size > 0)
+    {
+        int64_t end_us = esp_timer_get_time();
+        uint32_t wait_us = (uint32_t)(start_us - trans->queued_us);
+
+        portENTER_CRITICAL(&i2c_bus_lock);
+        dev->stats.transactions++;
+        dev->stats.errors += err != ESP_OK;
+        dev->stats.bytes += trans->write_size + trans->read_size;
+        dev->stats.busy_us += end_us - start_us;
+        dev->stats.wait_us += wait_us;
+        dev->stats.wait_max_us = wait_us > dev->stats.wait_max_us ? wait_us : dev->stats.wait_max_us;
+        i2c_bus_busy_us += end_us - start_us;
+        portEXIT_CRITICAL(&i2c_bus_lock);
+    }
+
+    if (trans->done != NULL)
+    {
+        trans->done(dev, err, trans->arg);
+    }
+}
+
+/**
+ * @brief Arbiter task: sends queued transactions until every queue is empty, then waits for the next.
+ * @param pvParameters parameter which can be passed to the task.
+ */
+static void i2c_bus_task(void *pvParameters)
+{
+    i2c_bus_trans_t trans;
+
+    for (;;)
+    {
+        // Picked anew after every transaction, so a sensor read waits for one display write at most
+        struct i2c_bus_dev *dev;
+        while ((dev = i2c_bus_next(&trans)) != NULL)
+        {
+            i2c_bus_run(dev, &trans);
+        }
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+    }
+}
+
+/**
+ * @brief Completion of an i2c_bus_transfer() transaction: wakes the waiting task.
+ * @param dev device addressed.
+ * @param result transaction result.
+ * @param arg unused.
+ */
+static void i2c_bus_sync_done(i2c_bus_dev_handle_t dev, esp_err_t result, void *arg)
+{
+    dev->sync_result = result;
+    xSemaphoreGive(dev->sync_done);
+}
+
+esp_err_t i2c_bus_init(void)
+{
+    if (i2c_bus_handle != NULL)
+    {
+        return ESP_OK;
+    }
+
+    i2c_master_bus_config_t bus_config =
+    {
+        .i2c_port = I2C_BUS_PORT,
+        .sda_io_num = I2C_BUS_SDA_PIN,
+        .scl_io_num = I2C_BUS_SCL_PIN,
+        .clk_source = I2C_CLK_SRC_DEFAULT,
+        .glitch_ignore_cnt = I2C_BUS_GLITCH_IGNORE_CNT,
+        .flags.enable_internal_pullup = true,
+    };
+
+    i2c_bus_devices_mutex = xSemaphoreCreateMutex();
+    if (i2c_bus_devices_mutex == NULL)
+    {
+        return ESP_ERR_NO_MEM;
+    }
+
+    esp_err_t err = i2c_new_master_bus(&bus_config, &i2c_bus_handle);
+    if (err != ESP_OK)
+    {
+        ESP_LOGE(TAG, "i2c_bus_init: i2c_new_master_bus failed: %s", esp_err_to_name(err));
+        vSemaphoreDelete(i2c_bus_devices_mutex);
+        i2c_bus_devices_mutex = NULL;
+        i2c_bus_handle = NULL;
+        return err;
+    }
+
+    ESP_LOGI(TAG, "i2c_bus_init: port %d, SDA %d, SCL %d", I2C_BUS_PORT, I2C_BUS_SDA_PIN, I2C_BUS_SCL_PIN);
+    xTaskCreatePinnedToCore(&i2c_bus_task, "i2c_bus_task", I2C_BUS_TASK_STACK_SIZE, NULL, I2C_BUS_TASK_PRIORITY, &task_i2c_bus, I2C_BUS_TASK_CORE_ID);
+    return ESP_OK;
+}
+
+i2c_master_bus_handle_t i2c_bus_get_handle(void)
+{
+    return i2c_bus_handle;
+}
+
+esp_err_t i2c_bus_add_device(uint16_t address, uint32_t scl_speed_hz, i2c_bus_priority_e priority, i2c_bus_dev_handle_t *dev)
+{
+    esp_err_t err = i2c_bus_init();
+    if (err != ESP_OK)
+    {
+        return err;
+    }
+
+    xSemaphoreTake(i2c_bus_devices_mutex, portMAX_DELAY);
+    struct i2c_bus_dev *entry = NULL;
+    for (int i = 0; i < I2C_BUS_MAX_DEVICES && entry == NULL; i++)
+    {
+        if (i2c_bus_devices[i].handle == NULL)
+        {
+            entry = &i2c_bus_devices[i];
+        }
+    }
+    if (entry == NULL)
+    {
+        xSemaphoreGive(i2c_bus_devices_mutex);
+        ESP_LOGE(TAG, "i2c_bus_add_device: 0x%02X: all %d devices in use", address, I2C_BUS_MAX_DEVICES);
+        return ESP_ERR_NO_MEM;
+    }
+
+    // Queue and semaphore are kept when a device is detached, the next one reuses them
+    if (entry->queue == NULL)
+    {
+        entry->queue = xQueueCreate(I2C_BUS_QUEUE_DEPTH, sizeof(i2c_bus_trans_t));
+        entry->sync_done = xSemaphoreCreateBinary();
+        if (entry->queue == NULL || entry->sync_done == NULL)
+        {
+            xSemaphoreGive(i2c_bus_devices_mutex);
+            return ESP_ERR_NO_MEM;
+        }
+    }
+
+    i2c_device_config_t dev_config =
+    {
+        .dev_addr_length = I2C_ADDR_BIT_LEN_7,
+        .device_address = address,
+        .scl_speed_hz = scl_speed_hz,
+    };
+
+    err = i2c_master_bus_add_device(i2c_bus_handle, &dev_config, &entry->handle);
+    if (err != ESP_OK)
+    {
+        ESP_LOGE(TAG, "i2c_bus_add_device: 0x%02X failed: %s", address, esp_err_to_name(err));
+        entry->handle = NULL;
+    }
+    else
+    {
+        portENTER_CRITICAL(&i2c_bus_lock);
+        memset(&entry->stats, 0, sizeof(entry->stats));
+        entry->stats.address = address;
+        entry->stats.priority = priority;
+        portEXIT_CRITICAL(&i2c_bus_lock);
+        *dev = entry;
+    }
+    xSemaphoreGive(i2c_bus_devices_mutex);
+    return err;
+}
+
+esp_err_t i2c_bus_rm_device(i2c_bus_dev_handle_t dev)
+{
+    i2c_bus_wait_done(dev);                             // Nothing of it may be left in the queue
+
+    xSemaphoreTake(i2c_bus_devices_mutex, portMAX_DELAY);
+    esp_err_t err = i2c_master_bus_rm_device(dev->handle);
+    dev->handle = NULL;
+    xSemaphoreGive(i2c_bus_devices_mutex);
+    return err;
+}
+
+esp_err_t i2c_bus_submit(i2c_bus_dev_handle_t dev, const uint8_t *write_buffer, size_t write_size,
+                         uint8_t *read_buffer, size_t read_size, i2c_bus_done_cb_t done, void *arg)
+{
+    i2c_bus_trans_t trans =
+    {
+        .write_buffer = write_buffer,
+        .write_size = write_buffer != NULL ? write_size : 0,
+        .read_buffer = read_buffer,
+        .read_size = read_buffer != NULL ? read_size : 0,
+        .done = done,
+        .arg = arg,
+        .queued_us = esp_timer_get_time(),
+    };
+
+    portENTER_CRITICAL(&i2c_bus_lock);
+    trans.seq = i2c_bus_seq++;
+    portEXIT_CRITICAL(&i2c_bus_lock);
+
+    if (xQueueSend(dev->queue, &trans, pdMS_TO_TICKS(I2C_BUS_TIMEOUT_MS)) != pdTRUE)
+    {
+        ESP_LOGW(TAG, "i2c_bus_submit: 0x%02X queue full", dev->stats.address);
+        return ESP_ERR_TIMEOUT;
+    }
+    xTaskNotifyGive(task_i2c_bus);
+    return ESP_OK;
+}
+
+esp_err_t i2c_bus_transfer(i2c_bus_dev_handle_t dev, const uint8_t *write_buffer, size_t write_size,
+                           uint8_t *read_buffer, size_t read_size)
+{
+    esp_err_t err = i2c_bus_submit(dev, write_buffer, write_size, read_buffer, read_size, i2c_bus_sync_done, NULL);
+    if (err != ESP_OK)
+    {
+        return err;
+    }
+
+    // Every transaction ahead of it ends within its own timeout, so this wait ends too
+    xSemaphoreTake(dev->sync_done, portMAX_DELAY);
+    return dev->sync_result;
+}
+
+esp_err_t i2c_bus_wait_done(i2c_bus_dev_handle_t dev)
+{
+    return i2c_bus_transfer(dev, NULL, 0, NULL, 0);
+}
+
+bool i2c_bus_get_stats(int index, i2c_bus_stats_t *stats)
+{
+    if (index < 0 || index >= I2C_BUS_MAX_DEVICES || i2c_bus_devices[index].handle == NULL)
+    {
+        return false;
+    }
+    portENTER_CRITICAL(&i2c_bus_lock);
+    *stats = i2c_bus_devices[index].stats;
+    portEXIT_CRITICAL(&i2c_bus_lock);
+    return true;
+}
+
+uint64_t i2c_bus_get_busy_us(void)
+{
+    portENTER_CRITICAL(&i2c_bus_lock);
+    uint64_t busy_us = i2c_bus_busy_us;
+    portEXIT_CRITICAL(&i2c_bus_lock);
+    return busy_us;
+}
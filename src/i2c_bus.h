@@ -0,0 +1,126 @@
+/**
+ * @file i2c_bus.h
+ * @brief Shared I2C Master Bus Header for ESP32 Weather Station
+ * @details This header file defines the I2C master bus shared by the LCD and
+ *          any I2C sensors added later. The bus is created once with the
+ *          i2c_master driver and owned by an arbiter task: devices do not
+ *          transfer on the bus themselves but queue transactions in a queue
+ *          of their own, I2C_BUS_QUEUE_DEPTH entries deep. Whenever the bus
+ *          is free the arbiter starts the oldest transaction of the highest
+ *          priority that has one waiting, so a sensor read goes ahead of the
+ *          display writes still queued and waits at most for the one on the
+ *          bus. Devices of the same priority are served in submission order.
+ *          Every device keeps counters of its transactions, bytes, bus time
+ *          and queueing delay for the /metrics endpoint (i2c_bus_stats.h).
+ *
+ * @author christophermena
+ * @date July 30, 2025
+ * @version 1.0
+ * @note Last Updated: October 16, 2026
+ */
+
+#ifndef MAIN_I2C_BUS_H_
+#define MAIN_I2C_BUS_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "driver/i2c_master.h"
+#include "esp_err.h"
+
+#include "i2c_bus_stats.h"
+
+// I2C Bus Configuration
+#define I2C_BUS_PORT                    0           ///< I2C controller (I2C_NUM_0)
+#define I2C_BUS_SDA_PIN                 27          ///< SDA GPIO
+#define I2C_BUS_SCL_PIN                 26          ///< SCL GPIO
+#define I2C_BUS_GLITCH_IGNORE_CNT       7           ///< Glitch filter, in APB clock cycles
+#define I2C_BUS_QUEUE_DEPTH             4           ///< Transactions pending per device
+#define I2C_BUS_TIMEOUT_MS              100         ///< Timeout of one transaction, and of queueing it
+
+/**
+ * @brief Device attached to the bus
+ */
+typedef struct i2c_bus_dev *i2c_bus_dev_handle_t;
+
+/**
+ * @brief Completion of a queued transaction, called from the arbiter task
+ * @param dev Device the transaction was addressed to
+ * @param result ESP_OK, or the i2c_master error (NACK, timeout)
+ * @param arg Argument given to i2c_bus_submit()
+ */
+typedef void (*i2c_bus_done_cb_t)(i2c_bus_dev_handle_t dev, esp_err_t result, void *arg);
+
+/**
+ * @brief Create the bus and start the arbiter task (does nothing if it exists)
+ * @return ESP_OK on success, or the i2c_new_master_bus() error
+ */
+esp_err_t i2c_bus_init(void);
+
+/**
+ * @brief Get the bus handle, e.g. to probe for a sensor (not arbitrated, use before the device is attached)
+ * @return Bus handle, NULL before i2c_bus_init()
+ */
+i2c_master_bus_handle_t i2c_bus_get_handle(void);
+
+/**
+ * @brief Attach a 7-bit address device to the bus, creating the bus if needed
+ * @param address 7-bit I2C address
+ * @param scl_speed_hz SCL frequency used for this device
+ * @param priority Transaction priority
+ * @param dev Receives the device handle
+ * @return ESP_OK on success, ESP_ERR_NO_MEM if I2C_BUS_MAX_DEVICES are attached
+ */
+esp_err_t i2c_bus_add_device(uint16_t address, uint32_t scl_speed_hz, i2c_bus_priority_e priority, i2c_bus_dev_handle_t *dev);
+
+/**
+ * @brief Detach a device once its queued transactions are done
+ * @param dev Device handle
+ * @return ESP_OK on success
+ */
+esp_err_t i2c_bus_rm_device(i2c_bus_dev_handle_t dev);
+
+/**
+ * @brief Queue a transaction: a write, a read, or a write and a read with a repeated START
+ *
+ * Returns once queued. The buffers must stay valid until done is called.
+ * A transaction with nothing to write or read is not sent; its completion
+ * marks the point where everything queued before it is done.
+ *
+ * @param dev Device handle
+ * @param write_buffer Bytes to write, NULL for a read only
+ * @param write_size Number of bytes to write
+ * @param read_buffer Receives the bytes read, NULL for a write only
+ * @param read_size Number of bytes to read
+ * @param done Completion callback, NULL for none
+ * @param arg Argument of the callback
+ * @return ESP_OK once queued, ESP_ERR_TIMEOUT if the device's queue stayed full
+ */
+esp_err_t i2c_bus_submit(i2c_bus_dev_handle_t dev, const uint8_t *write_buffer, size_t write_size,
+                         uint8_t *read_buffer, size_t read_size, i2c_bus_done_cb_t done, void *arg);
+
+/**
+ * @brief Queue a transaction and wait until it is done
+ * @note A device's blocking calls are made by one task at a time
+ * @param dev Device handle
+ * @param write_buffer Bytes to write, NULL for a read only
+ * @param write_size Number of bytes to write
+ * @param read_buffer Receives the bytes read, NULL for a write only
+ * @param read_size Number of bytes to read
+ * @return ESP_OK on success, or the i2c_bus_submit() or i2c_master error
+ */
+esp_err_t i2c_bus_transfer(i2c_bus_dev_handle_t dev, const uint8_t *write_buffer, size_t write_size,
+                           uint8_t *read_buffer, size_t read_size);
+
+/**
+ * @brief Wait until the transactions queued to a device so far are done
+ *
+ * With submission order kept within a priority, the transactions queued
+ * before to other devices of the same priority are done as well.
+ *
+ * @param dev Device handle
+ * @return ESP_OK on success, ESP_ERR_TIMEOUT if the device's queue stayed full
+ */
+esp_err_t i2c_bus_wait_done(i2c_bus_dev_handle_t dev);
+
+#endif /* MAIN_I2C_BUS_H_ */
@@ -0,0 +1,62 @@
+/**
+ * @file i2c_bus_stats.h
+ * @brief Shared I2C Bus Counters Header for ESP32 Weather Station
+ * @details This header file defines the per-device counters of the shared
+ *          I2C bus and the functions that read them. It does not depend on
+ *          the i2c_master driver, so the /metrics endpoint can be built
+ *          where the driver does not exist (the host build of the HTTP
+ *          layer). i2c_bus.h includes it.
+ *
+ * @author christophermena
+ * @date July 30, 2025
+ * @version 1.0
+ * @note Last Updated: October 16, 2026
+ */
+
+#ifndef MAIN_I2C_BUS_STATS_H_
+#define MAIN_I2C_BUS_STATS_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define I2C_BUS_MAX_DEVICES             4           ///< Devices attached at the same time
+
+/**
+ * @brief Transaction priority of a device, higher values go first
+ */
+typedef enum i2c_bus_priority
+{
+    I2C_BUS_PRIORITY_DISPLAY = 0,   ///< Screen updates, any delay only postpones a frame
+    I2C_BUS_PRIORITY_SENSOR,        ///< Time-critical reads, served before queued display writes
+} i2c_bus_priority_e;
+
+/**
+ * @brief Counters of one device since it was attached
+ */
+typedef struct i2c_bus_stats
+{
+    uint16_t address;               ///< 7-bit I2C address
+    i2c_bus_priority_e priority;    ///< Transaction priority
+    uint32_t transactions;          ///< Transactions sent (START to STOP)
+    uint32_t errors;                ///< Transactions that failed
+    uint64_t bytes;                 ///< Bytes written and read, address bytes not included
+    uint64_t busy_us;               ///< Time the device's transactions held the bus
+    uint64_t wait_us;               ///< Time its transactions spent queued, summed
+    uint32_t wait_max_us;           ///< Longest time a transaction spent queued
+} i2c_bus_stats_t;
+
+/**
+ * @brief Read the counters of one attached device
+ * @param index Device index, 0 to I2C_BUS_MAX_DEVICES - 1
+ * @param stats Receives the counters
+ * @return false if no device is attached at this index
+ */
+bool i2c_bus_get_stats(int index, i2c_bus_stats_t *stats);
+
+/**
+ * @brief Read the time the bus was busy, all devices together
+ * @return Microseconds since the bus was created
+ */
+uint64_t i2c_bus_get_busy_us(void);
+
+#endif /* MAIN_I2C_BUS_STATS_H_ */
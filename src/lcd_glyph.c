@@ -0,0 +1,123 @@
+/**
+ * @file lcd_glyph.c
+ * @brief LCD Custom Glyph Manager Implementation for ESP32 Weather Station
+ * @details This file holds the glyph bitmaps and keeps each panel's CGRAM
+ *          slot table (in its lcd_t). Each slot records its glyph and the
+ *          frame that last used it, so a lookup either hits, takes a free
+ *          slot, or evicts the least recently used glyph that the current
+ *          frame has not drawn.
+ *          Rewriting a slot changes every cell showing it at once, which is
+ *          why glyphs of the current frame are never evicted: cells still
+ *          showing an evicted glyph belong to the previous frame and are
+ *          overwritten by the next lcd_flush(). Glyphs print as
+ *          LCD_CGRAM_CHAR_BASE + slot, so they can be embedded in C strings.
+ *
+ * @author christophermena
+ * @date July 30, 2025
+ * @version 1.0
+ * @note Last Updated: October 16, 2026
+ */
+
+#include <stdbool.h>
+
+#include "LiquidCrystal_I2C.h"
+#include "lcd_glyph.h"
+
+// ROM characters of the A00 character set
+#define LCD_GLYPH_ROM_DEGREE        ((char)0xDF)
+#define LCD_GLYPH_ROM_FULL_BLOCK    ((char)0xFF)
+
+/**
+ * @brief Glyph bitmap with its ROM fallback
+ */
+typedef struct lcd_glyph
+{
+    uint8_t rows[8];            ///< 5x8 pixels, bit 4 is the leftmost column
+    char fallback;              ///< Character used when no slot is available
+} lcd_glyph_t;
+
+static const lcd_glyph_t lcd_glyphs[LCD_GLYPH_COUNT] =
+{
+    [LCD_GLYPH_DEGREE]      = { { 0x06, 0x09, 0x09, 0x06, 0x00, 0x00, 0x00, 0x00 }, LCD_GLYPH_ROM_DEGREE },
+    [LCD_GLYPH_WIFI_0]      = { { 0x00, 0x00, 0x11, 0x0A, 0x04, 0x0A, 0x11, 0x00 }, 'x' },
+    [LCD_GLYPH_WIFI_1]      = { { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x10, 0x10 }, '1' },
+    [LCD_GLYPH_WIFI_2]      = { { 0x00, 0x00, 0x00, 0x00, 0x04, 0x04, 0x14, 0x14 }, '2' },
+    [LCD_GLYPH_WIFI_3]      = { { 0x00, 0x00, 0x01, 0x01, 0x05, 0x05, 0x15, 0x15 }, '3' },
+    [LCD_GLYPH_WIFI_4]      = { { 0x01, 0x01, 0x05, 0x05, 0x15, 0x15, 0x15, 0x15 }, '4' },
+    [LCD_GLYPH_TREND_UP]    = { { 0x04, 0x0E, 0x15, 0x04, 0x04, 0x04, 0x04, 0x00 }, '^' },
+    [LCD_GLYPH_TREND_FLAT]  = { { 0x00, 0x04, 0x02, 0x1F, 0x02, 0x04, 0x00, 0x00 }, '-' },
+    [LCD_GLYPH_TREND_DOWN]  = { { 0x04, 0x04, 0x04, 0x04, 0x15, 0x0E, 0x04, 0x00 }, 'v' },
+    [LCD_GLYPH_BAR_1]       = { { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x1F }, '_' },
+    [LCD_GLYPH_BAR_2]       = { { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x1F, 0x1F }, '_' },
+    [LCD_GLYPH_BAR_3]       = { { 0x00, 0x00, 0x00, 0x00, 0x00, 0x1F, 0x1F, 0x1F }, '_' },
+    [LCD_GLYPH_BAR_4]       = { { 0x00, 0x00, 0x00, 0x00, 0x1F, 0x1F, 0x1F, 0x1F }, '-' },
+    [LCD_GLYPH_BAR_5]       = { { 0x00, 0x00, 0x00, 0x1F, 0x1F, 0x1F, 0x1F, 0x1F }, '-' },
+    [LCD_GLYPH_BAR_6]       = { { 0x00, 0x00, 0x1F, 0x1F, 0x1F, 0x1F, 0x1F, 0x1F }, LCD_GLYPH_ROM_FULL_BLOCK },
+    [LCD_GLYPH_BAR_7]       = { { 0x00, 0x1F, 0x1F, 0x1F, 0x1F, 0x1F, 0x1F, 0x1F }, LCD_GLYPH_ROM_FULL_BLOCK },
+};
+
+// CGRAM uploads since boot
+static uint32_t lcd_glyph_uploads = 0;
+
+void lcd_glyph_begin_frame(lcd_t *lcd)
+{
+    lcd->glyph_frame++;
+}
+
+char lcd_glyph_get(lcd_t *lcd, lcd_glyph_id_e id)
+{
+    if ((int)id < 0 || id >= LCD_GLYPH_COUNT)
+    {
+        return '?';
+    }
+
+    int victim = -1;
+    for (int i = 0; i < LCD_CGRAM_SLOTS; i++)
+    {
+        if (lcd->cgram_glyph[i] == (int)id)
+        {
+            lcd->cgram_frame[i] = lcd->glyph_frame;
+            return (char)(LCD_CGRAM_CHAR_BASE + i);
+        }
+
+        // Prefer an empty slot, then the one used longest ago, never one drawn in this frame
+        if (lcd->cgram_frame[i] == lcd->glyph_frame)
+        {
+            continue;
+        }
+        if (victim < 0 || (lcd->cgram_glyph[victim] >= 0
+                           && (lcd->cgram_glyph[i] < 0 || lcd->cgram_frame[i] < lcd->cgram_frame[victim])))
+        {
+            victim = i;
+        }
+    }
+
+    if (victim < 0)
+    {
+        return lcd_glyphs[id].fallback;
+    }
+
+    lcd->cgram_glyph[victim] = (int8_t)id;
+    lcd->cgram_frame[victim] = lcd->glyph_frame;
+    lcd_create_char(lcd, (uint8_t)victim, lcd_glyphs[id].rows);
+    lcd_glyph_uploads++;
+    return (char)(LCD_CGRAM_CHAR_BASE + victim);
+}
+
+char lcd_glyph_bar(lcd_t *lcd, int level)
+{
+    if (level <= 0)
+    {
+        return ' ';
+    }
+    if (level >= LCD_GLYPH_BAR_LEVELS)
+    {
+        return LCD_GLYPH_ROM_FULL_BLOCK;                // Full height needs no CGRAM slot
+    }
+    return lcd_glyph_get(lcd, LCD_GLYPH_BAR_1 + level - 1);
+}
+
+uint32_t lcd_glyph_get_uploads(void)
+{
+    return lcd_glyph_uploads;
+}
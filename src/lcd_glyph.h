@@ -0,0 +1,82 @@
+/**
+ * @file lcd_glyph.h
+ * @brief LCD Custom Glyph Manager Header for ESP32 Weather Station
+ * @details This header file defines the custom glyphs of the weather station
+ *          display (degree sign, WiFi strength, trend arrows, sparkline bars)
+ *          and the manager that maps them onto the HD44780's 8 CGRAM slots.
+ *          A glyph is uploaded the first time a frame uses it and stays in its
+ *          slot for later frames; when all slots are taken, the glyph used
+ *          least recently and not needed by the frame being drawn is evicted.
+ *          A frame needing more than 8 different glyphs gets a ROM fallback
+ *          character for the rest instead of corrupting visible cells. Each
+ *          panel has its own CGRAM, so the slot table lives in its lcd_t.
+ *
+ * @author christophermena
+ * @date July 30, 2025
+ * @version 1.0
+ * @note Last Updated: October 16, 2026
+ */
+
+#ifndef MAIN_LCD_GLYPH_H_
+#define MAIN_LCD_GLYPH_H_
+
+#include <stdint.h>
+#include "LiquidCrystal_I2C.h"
+
+// Glyph Manager Configuration
+#define LCD_GLYPH_BAR_LEVELS            8           ///< Sparkline heights, 8 is the ROM full block
+
+/**
+ * @brief Custom glyphs
+ */
+typedef enum lcd_glyph_id
+{
+    LCD_GLYPH_DEGREE = 0,       ///< Degree sign
+    LCD_GLYPH_WIFI_0,           ///< WiFi disconnected
+    LCD_GLYPH_WIFI_1,           ///< WiFi signal, one bar
+    LCD_GLYPH_WIFI_2,           ///< WiFi signal, two bars
+    LCD_GLYPH_WIFI_3,           ///< WiFi signal, three bars
+    LCD_GLYPH_WIFI_4,           ///< WiFi signal, four bars
+    LCD_GLYPH_TREND_UP,         ///< Rising arrow
+    LCD_GLYPH_TREND_FLAT,       ///< Steady arrow
+    LCD_GLYPH_TREND_DOWN,       ///< Falling arrow
+    LCD_GLYPH_BAR_1,            ///< Sparkline bar, 1 of 8 rows
+    LCD_GLYPH_BAR_2,            ///< Sparkline bar, 2 of 8 rows
+    LCD_GLYPH_BAR_3,            ///< Sparkline bar, 3 of 8 rows
+    LCD_GLYPH_BAR_4,            ///< Sparkline bar, 4 of 8 rows
+    LCD_GLYPH_BAR_5,            ///< Sparkline bar, 5 of 8 rows
+    LCD_GLYPH_BAR_6,            ///< Sparkline bar, 6 of 8 rows
+    LCD_GLYPH_BAR_7,            ///< Sparkline bar, 7 of 8 rows
+    LCD_GLYPH_COUNT,
+} lcd_glyph_id_e;
+
+/**
+ * @brief Start a frame: glyphs of the panel's previous frame become evictable
+ * @param lcd Panel about to be drawn
+ * @note Call before drawing, from the task that owns the LCD
+ */
+void lcd_glyph_begin_frame(lcd_t *lcd);
+
+/**
+ * @brief Get the character that shows a glyph, uploading it to the panel's CGRAM if needed
+ * @param lcd Panel being drawn
+ * @param id Glyph
+ * @return Character to print, or the glyph's ROM fallback if every slot is used by this frame
+ */
+char lcd_glyph_get(lcd_t *lcd, lcd_glyph_id_e id);
+
+/**
+ * @brief Get the character of a sparkline bar
+ * @param lcd Panel being drawn
+ * @param level Height, 0 (blank) to LCD_GLYPH_BAR_LEVELS (full block)
+ * @return Character to print
+ */
+char lcd_glyph_bar(lcd_t *lcd, int level);
+
+/**
+ * @brief Get the number of CGRAM uploads since boot, all panels together
+ * @return Glyphs written to CGRAM
+ */
+uint32_t lcd_glyph_get_uploads(void);
+
+#endif /* MAIN_LCD_GLYPH_H_ */
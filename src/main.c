@@ -11,7 +11,7 @@
  * @author christophermena
  * @date July 30, 2025
  * @version 1.0
- * @note Last Updated: August 3, 2025 at 2:00 PM
+ * @note Last Updated: October 16, 2026
  */
 
 #include "nvs_flash.h"
@@ -19,8 +19,14 @@
 #include "DHT11.h"
 #include "esp_log.h"
 #include "rgb_led.h"
-#include "LiquidCrystal_I2C.h"
+#include "display_app.h"
+#include "app_settings.h"
+#include "ota_update.h"
+#include "sensor_data.h"
+#include "sensor_history.h"
+#include "time_sync.h"
 #include <stdbool.h>
+#include <time.h>
 
 void app_main(void)
 {
@@ -33,23 +39,21 @@ void app_main(void)
     }
     ESP_ERROR_CHECK(ret);
 
+    // Restore any interrupted chunked OTA transfer (needs NVS)
+    ota_update_init();
+
+    // Map the sample history partition
+    sensor_history_init();
+
+    // Load user settings (temperature unit)
+    app_settings_init();
+
     // Start WiFi application (Access Point + Station mode capability)
     wifi_app_start();
 
-    // Initialize I2C LCD display (16x2 at address 0x27)
-    if (liquid_crystal_i2c_init(0x27, 16, 2) == ESP_OK) 
-    {
-        lcd_clear();
-        lcd_set_cursor(0, 0);
-        lcd_print("Weather Station");
-        lcd_set_cursor(0, 1);
-        lcd_print("Initializing...");
-        ESP_LOGI("MAIN", "LCD initialized successfully");
-    } 
-    else 
-    {
-        ESP_LOGE("MAIN", "Failed to initialize LCD");
-    }
+    // Start the display service (20x4 LCD at 0x27 and 16x2 LCD at 0x26, initialized by its own task)
+    display_app_show_text("Weather Station", "Initializing...");
+    display_app_start();
 
     // Initialize DHT11 temperature and humidity sensor on GPIO 4
     dht11_t sensor;
@@ -61,15 +65,8 @@ void app_main(void)
     // Initial delay to allow system components to stabilize
     vTaskDelay(pdMS_TO_TICKS(2000));
 
-    // Temperature unit toggle (true = Fahrenheit, false = Celsius)
-    bool temp_fahrenheit = true;
-    
-    // Clear LCD and show ready message
-    lcd_clear();
-    lcd_set_cursor(0, 0);
-    lcd_print("Weather Station");
-    lcd_set_cursor(0, 1);
-    lcd_print("Ready!");
+    // Show ready message (only the second line changes on the panel)
+    display_app_show_text("Weather Station", "Ready!");
     vTaskDelay(pdMS_TO_TICKS(2000));
 
     // Main sensor reading loop
@@ -77,25 +74,28 @@ void app_main(void)
     {
         if (dht11_read(&sensor) == ESP_OK)
         {
+            // Temperature unit (true = Fahrenheit, false = Celsius), changeable from the web interface
+            bool temp_fahrenheit = app_settings_get_fahrenheit();
+
             // Get sensor readings
             int temperature = dht11_get_temperature(&sensor, temp_fahrenheit);
             int humidity = dht11_get_humidity(&sensor);
+            int temperature_c = dht11_get_temperature(&sensor, false);
+
+            // Publish the reading (always in Celsius) to the HTTP streaming clients, and to the
+            // history once SNTP has set the clock (times since boot would overlap across reboots)
+            sensor_data_publish(temperature_c, humidity);
+            if (time_sync_is_valid())
+            {
+                sensor_history_append((uint32_t)time(NULL), temperature_c, humidity);
+            }
             
             // Format temperature unit string
             char temp_unit[8];
             sprintf(temp_unit, temp_fahrenheit ? "F" : "C");
             
-            // Display on LCD
-            lcd_clear();
-            lcd_set_cursor(0, 0);
-            lcd_print("Temp: ");
-            lcd_print_int(temperature);
-            lcd_print(temp_unit);
-            
-            lcd_set_cursor(0, 1);
-            lcd_print("Humidity: ");
-            lcd_print_int(humidity);
-            lcd_print("%");
+            // Hand the reading to the display task (returns at once)
+            display_app_show_sample(temperature_c, humidity);
             
             // Log successful sensor reading
             ESP_LOGI("DHT11", "Temperature: %d%s, Humidity: %d%%",
@@ -104,15 +104,12 @@ void app_main(void)
         else
         {
             // Display error on LCD
-            lcd_clear();
-            lcd_set_cursor(0, 0);
-            lcd_print("Sensor Error!");
-            lcd_set_cursor(0, 1);
-            lcd_print("Check DHT11");
+            display_app_show_error();
             
             // Log sensor read failure and indicate error via LED
             ESP_LOGI("DHT11", "Failed to read from sensor");
             rgb_led_error();
+            sensor_data_publish_error();
         }
 
         // Wait for next reading cycle (DHT11 requires minimum 2 second intervals)
@@ -0,0 +1,361 @@
+/**
+ * @file ota_fetch.c
+ * @brief Pull-Mode OTA Client Implementation for ESP32 Weather Station
+ * @details This file implements the device-side OTA client. The download task
+ *          streams the firmware image with esp_http_client into a pair of
+ *          chunk buffers; a writer task running on the other core hands each
+ *          full buffer to the resumable OTA writer (CRC check, flash write,
+ *          NVS checkpoint) while the next one is being downloaded. A dropped
+ *          connection is resumed with an HTTP Range request from the last
+ *          committed offset.
+ *
+ * @author christophermena
+ * @date July 30, 2025
+ * @version 1.0
+ * @note Last Updated: October 16, 2026
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "esp_crt_bundle.h"
+#include "esp_http_client.h"
+#include "esp_timer.h"
+#include "esp_log.h"
+#include "esp_rom_crc.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/queue.h"
+#include "freertos/task.h"
+#include "sys/param.h"
+
+#include "http_server.h"
+#include "ota_fetch.h"
+#include "ota_update.h"
+#include "tasks_common.h"
+
+// Tag used for ESP serial console messages
+static const char TAG[] = "ota_fetch";
+
+// Number of chunk buffers in the download -> flash pipeline
+#define OTA_FETCH_BUFFER_COUNT      2
+
+/**
+ * @brief Chunk buffer passed between the download and writer tasks
+ */
+typedef struct ota_fetch_chunk
+{
+    uint8_t *data;          ///< Buffer of OTA_UPDATE_CHUNK_MAX_SIZE bytes, NULL stops the writer
+    uint32_t offset;        ///< Offset of the chunk inside the image
+    size_t len;             ///< Number of valid bytes in the buffer
+} ota_fetch_chunk_t;
+
+// Download parameters
+static char ota_fetch_url[OTA_FETCH_URL_MAX_LENGTH];
+static uint32_t ota_fetch_image_crc;
+
+// Set when the session turned out to belong to another image of the same CRC, the next attempt starts over
+static bool ota_fetch_no_resume = false;
+
+// Task handles (download task doubles as the "running" flag)
+static TaskHandle_t task_ota_fetch = NULL;
+static TaskHandle_t task_ota_writer = NULL;
+
+// Queues of empty and filled chunk buffers
+static QueueHandle_t ota_fetch_free_queue = NULL;
+static QueueHandle_t ota_fetch_full_queue = NULL;
+
+// First error reported by the writer task, the download stops once it is set
+static volatile esp_err_t ota_fetch_writer_err = ESP_OK;
+
+/**
+ * @brief Second pipeline stage: commits filled buffers through the resumable OTA writer.
+ * @param pvParameters parameter which can be passed to the task.
+ */
+static void ota_fetch_writer_task(void *pvParameters)
+{
+    ota_fetch_chunk_t chunk;
+
+    for (;;)
+    {
+        xQueueReceive(ota_fetch_full_queue, &chunk, portMAX_DELAY);
+        if (chunk.data == NULL)
+        {
+            break;
+        }
+
+        if (ota_fetch_writer_err == ESP_OK)
+        {
+            esp_err_t err = ota_update_write_chunk(chunk.offset, chunk.data, chunk.len, esp_rom_crc32_le(0, chunk.data, chunk.len));
+            if (err != ESP_OK)
+            {
+                ESP_LOGE(TAG, "ota_fetch_writer_task: chunk at %lu rejected: %s", chunk.offset, esp_err_to_name(err));
+                ota_fetch_writer_err = err;
+            }
+        }
+        xQueueSend(ota_fetch_free_queue, &chunk, portMAX_DELAY);
+    }
+
+    xTaskNotifyGive(task_ota_fetch);
+    vTaskDelete(NULL);
+}
+
+/**
+ * @brief Waits until the writer task has returned every buffer, i.e. everything downloaded is committed.
+ */
+static void ota_fetch_drain(void)
+{
+    ota_fetch_chunk_t chunks[OTA_FETCH_BUFFER_COUNT];
+
+    for (int i = 0; i < OTA_FETCH_BUFFER_COUNT; i++)
+    {
+        xQueueReceive(ota_fetch_free_queue, &chunks[i], portMAX_DELAY);
+    }
+    for (int i = 0; i < OTA_FETCH_BUFFER_COUNT; i++)
+    {
+        xQueueSend(ota_fetch_free_queue, &chunks[i], portMAX_DELAY);
+    }
+}
+
+/**
+ * @brief Performs one download attempt starting at the committed offset of the session.
+ * @return ESP_OK when the whole image was handed to the writer, otherwise the error of this attempt.
+ */
+static esp_err_t ota_fetch_download(void)
+{
+    ota_update_state_t state;
+    ota_fetch_chunk_t chunk;
+    char range[32];
+    esp_err_t err = ESP_OK;
+
+    ota_update_get_state(&state);
+    bool resume = !ota_fetch_no_resume && state.active && state.image_crc == ota_fetch_image_crc && state.committed > 0;
+    uint32_t offset = resume ? state.committed : 0;
+
+    esp_http_client_config_t config = {
+        .url = ota_fetch_url,
+        .timeout_ms = OTA_FETCH_TIMEOUT_MS,
+        .keep_alive_enable = true,
+        .crt_bundle_attach = esp_crt_bundle_attach,
+    };
+    esp_http_client_handle_t client = esp_http_client_init(&config);
+    if (client == NULL)
+    {
+        return ESP_ERR_NO_MEM;
+    }
+    if (resume)
+    {
+        snprintf(range, sizeof(range), "bytes=%lu-", offset);
+        esp_http_client_set_header(client, "Range", range);
+    }
+
+    err = esp_http_client_open(client, 0);
+    if (err != ESP_OK)
+    {
+        ESP_LOGI(TAG, "ota_fetch_download: cannot connect: %s", esp_err_to_name(err));
+        esp_http_client_cleanup(client);
+        return err;
+    }
+
+    int64_t content_length = esp_http_client_fetch_headers(client);
+    int status = esp_http_client_get_status_code(client);
+    uint32_t skip = 0;
+
+    if (status == 206 && resume)
+    {
+        // The session is only ours if the image has its size too: the partial body is the rest of it
+        if (content_length <= 0 || offset + (uint64_t)content_length != state.image_size)
+        {
+            ESP_LOGI(TAG, "ota_fetch_download: session belongs to an image of another size, starting over");
+            ota_fetch_no_resume = true;
+            err = ESP_FAIL;
+            goto out;
+        }
+        ESP_LOGI(TAG, "ota_fetch_download: resuming at offset %lu", offset);
+    }
+    else if (status == 200)
+    {
+        if (content_length <= 0)
+        {
+            ESP_LOGE(TAG, "ota_fetch_download: server did not send a content length");
+            err = ESP_ERR_INVALID_SIZE;
+            goto out;
+        }
+        err = ota_update_begin((uint32_t)content_length, ota_fetch_image_crc);
+        if (err != ESP_OK)
+        {
+            goto out;
+        }
+    }
+    else
+    {
+        ESP_LOGE(TAG, "ota_fetch_download: unexpected HTTP status %d", status);
+        err = ESP_ERR_INVALID_RESPONSE;
+        goto out;
+    }
+
+    ota_update_get_state(&state);
+    offset = state.committed;
+    if (status == 200)
+    {
+        // Full body from byte 0 (no Range support or new image), discard what is already committed
+        skip = offset;
+    }
+
+    while (offset < state.image_size && ota_fetch_writer_err == ESP_OK)
+    {
+        xQueueReceive(ota_fetch_free_queue, &chunk, portMAX_DELAY);
+        chunk.offset = offset;
+        chunk.len = 0;
+
+        // Fill the buffer completely (or up to the end of the image) before handing it over
+        size_t want = MIN(OTA_UPDATE_CHUNK_MAX_SIZE, state.image_size - offset);
+        while (chunk.len < want)
+        {
+            int read_len = esp_http_client_read(client, (char *)chunk.data + chunk.len, want - chunk.len);
+            if (read_len <= 0)
+            {
+                break;
+            }
+            if (skip > 0)
+            {
+                // Drop bytes the device already has, keep the remainder at the start of the buffer
+                uint32_t drop = MIN(skip, (uint32_t)read_len);
+                memmove(chunk.data + chunk.len, chunk.data + chunk.len + drop, read_len - drop);
+                skip -= drop;
+                read_len -= drop;
+            }
+            chunk.len += read_len;
+        }
+
+        if (chunk.len < want)
+        {
+            xQueueSend(ota_fetch_free_queue, &chunk, portMAX_DELAY);
+            ESP_LOGI(TAG, "ota_fetch_download: connection lost at offset %lu", offset + (uint32_t)chunk.len);
+            err = ESP_FAIL;
+            break;
+        }
+
+        xQueueSend(ota_fetch_full_queue, &chunk, portMAX_DELAY);
+        offset += chunk.len;
+    }
+
+out:
+    esp_http_client_close(client);
+    esp_http_client_cleanup(client);
+    return err;
+}
+
+/**
+ * @brief Download task: runs attempts until the image is installed or the retries are exhausted.
+ * @param pvParameters parameter which can be passed to the task.
+ */
+static void ota_fetch_task(void *pvParameters)
+{
+    ota_fetch_chunk_t chunk = { 0 };
+    ota_update_state_t state;
+    bool installed = false;
+
+    ota_fetch_writer_err = ESP_OK;
+    for (int i = 0; i < OTA_FETCH_BUFFER_COUNT; i++)
+    {
+        chunk.data = malloc(OTA_UPDATE_CHUNK_MAX_SIZE);
+        if (chunk.data != NULL)
+        {
+            xQueueSend(ota_fetch_free_queue, &chunk, 0);
+        }
+    }
+    if (uxQueueMessagesWaiting(ota_fetch_free_queue) != OTA_FETCH_BUFFER_COUNT)
+    {
+        ESP_LOGE(TAG, "ota_fetch_task: out of memory for download buffers");
+        ota_fetch_writer_err = ESP_ERR_NO_MEM;
+    }
+    else
+    {
+        xTaskCreatePinnedToCore(&ota_fetch_writer_task, "ota_writer", OTA_WRITER_TASK_STACK_SIZE, NULL, OTA_WRITER_TASK_PRIORITY, &task_ota_writer, OTA_WRITER_TASK_CORE_ID);
+    }
+
+    for (int attempt = 0; attempt < OTA_FETCH_MAX_RETRIES && ota_fetch_writer_err == ESP_OK; attempt++)
+    {
+        esp_err_t err = ota_fetch_download();
+
+        // Let the writer commit everything downloaded so far before looking at the session
+        ota_fetch_drain();
+        ota_update_get_state(&state);
+
+        if (err == ESP_OK && ota_fetch_writer_err == ESP_OK && !state.active && state.committed == state.image_size)
+        {
+            installed = true;
+            break;
+        }
+        if (err == ESP_ERR_INVALID_RESPONSE || err == ESP_ERR_INVALID_SIZE)
+        {
+            break;
+        }
+        vTaskDelay(pdMS_TO_TICKS(OTA_FETCH_RETRY_DELAY_MS));
+    }
+
+    // Stop the writer and release the buffers
+    if (task_ota_writer != NULL)
+    {
+        chunk.data = NULL;
+        xQueueSend(ota_fetch_full_queue, &chunk, portMAX_DELAY);
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        task_ota_writer = NULL;
+    }
+    while (xQueueReceive(ota_fetch_free_queue, &chunk, 0))
+    {
+        free(chunk.data);
+    }
+
+    ESP_LOGI(TAG, "ota_fetch_task: download %s", installed ? "installed" : "failed");
+    http_server_monitor_send_message(installed ? HTTP_MSG_OTA_UPDATE_SUCCESSFUL : HTTP_MSG_OTA_UPDATE_FAILED);
+
+    task_ota_fetch = NULL;
+    vTaskDelete(NULL);
+}
+
+esp_err_t ota_fetch_start(const char *url, uint32_t image_crc)
+{
+    ota_update_state_t state;
+
+    if (task_ota_fetch != NULL)
+    {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    // A session for another image belongs to a pushed upload: leave it alone while chunks arrive,
+    // replace it once abandoned (it survives reboots, so it would otherwise block every fetch)
+    ota_update_get_state(&state);
+    if (state.active && state.image_crc != image_crc)
+    {
+        if (state.last_write_us != 0 && esp_timer_get_time() - state.last_write_us < OTA_FETCH_PUSH_IDLE_MS * 1000LL)
+        {
+            ESP_LOGI(TAG, "ota_fetch_start: chunked upload of another image in progress");
+            return ESP_ERR_INVALID_STATE;
+        }
+        ESP_LOGI(TAG, "ota_fetch_start: superseding abandoned upload at %lu of %lu bytes", state.committed, state.image_size);
+    }
+    if (strlen(url) >= sizeof(ota_fetch_url))
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    if (ota_fetch_free_queue == NULL)
+    {
+        ota_fetch_free_queue = xQueueCreate(OTA_FETCH_BUFFER_COUNT, sizeof(ota_fetch_chunk_t));
+        ota_fetch_full_queue = xQueueCreate(OTA_FETCH_BUFFER_COUNT + 1, sizeof(ota_fetch_chunk_t));
+    }
+
+    strcpy(ota_fetch_url, url);
+    ota_fetch_image_crc = image_crc;
+    ota_fetch_no_resume = false;
+
+    ESP_LOGI(TAG, "ota_fetch_start: downloading %s", ota_fetch_url);
+    xTaskCreatePinnedToCore(&ota_fetch_task, "ota_fetch", OTA_FETCH_TASK_STACK_SIZE, NULL, OTA_FETCH_TASK_PRIORITY, &task_ota_fetch, OTA_FETCH_TASK_CORE_ID);
+
+    return ESP_OK;
+}
+
+bool ota_fetch_is_running(void)
+{
+    return task_ota_fetch != NULL;
+}
@@ -0,0 +1,55 @@
+/**
+ * @file ota_fetch.h
+ * @brief Pull-Mode OTA Client Header for ESP32 Weather Station
+ * @details This header file defines the interface for downloading a firmware
+ *          image from an HTTP(S) server and installing it through the resumable
+ *          OTA writer. This lets a whole fleet of stations update in parallel
+ *          from one file server instead of uploading to each station through
+ *          its SoftAP page.
+ *
+ * @author christophermena
+ * @date July 30, 2025
+ * @version 1.0
+ * @note Last Updated: October 16, 2026
+ */
+
+#ifndef MAIN_OTA_FETCH_H_
+#define MAIN_OTA_FETCH_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "esp_err.h"
+
+// OTA Fetch Configuration
+#define OTA_FETCH_URL_MAX_LENGTH        256             ///< Longest accepted firmware URL
+#define OTA_FETCH_MAX_RETRIES           10              ///< Reconnect attempts before the download is given up
+#define OTA_FETCH_RETRY_DELAY_MS        3000            ///< Delay between reconnect attempts
+#define OTA_FETCH_TIMEOUT_MS            10000           ///< HTTP client network timeout
+#define OTA_FETCH_PUSH_IDLE_MS          30000           ///< Idle time after which a pushed upload of another image is superseded
+
+/**
+ * @brief Start downloading and installing a firmware image
+ *
+ * Spawns the download task, which streams the image into the next OTA
+ * partition while a writer task flashes the previous chunk. Connection
+ * losses are retried with an HTTP Range request from the last committed
+ * offset. The HTTP server monitor is notified of the final result.
+ * A chunked upload of another image that received nothing for
+ * OTA_FETCH_PUSH_IDLE_MS is considered abandoned and replaced. HTTPS servers
+ * are verified against the ESP-IDF certificate bundle.
+ *
+ * @param url HTTP or HTTPS URL of the firmware .bin file
+ * @param image_crc CRC-32 of the complete image, used to verify the download
+ * @return ESP_OK if the download was started, ESP_ERR_INVALID_STATE if one is
+ *         already running or a chunked upload of another image is still
+ *         receiving chunks, ESP_ERR_INVALID_ARG if the URL is too long
+ */
+esp_err_t ota_fetch_start(const char *url, uint32_t image_crc);
+
+/**
+ * @brief Check whether a download is in progress
+ * @return true while the download task is running
+ */
+bool ota_fetch_is_running(void);
+
+#endif /* MAIN_OTA_FETCH_H_ */
@@ -0,0 +1,291 @@
+/**
+ * @file ota_update.c
+ * @brief Resumable OTA Firmware Writer Implementation for ESP32 Weather Station
+ * @details This file implements the chunked, resumable firmware writer used by
+ *          the HTTP server. Chunks are CRC-checked before they touch flash,
+ *          written directly into the next OTA partition, and the committed
+ *          offset is stored in NVS after every chunk. Once the final chunk is
+ *          committed the whole image is read back, its CRC-32 compared against
+ *          the one announced by the client, and the partition is validated and
+ *          selected as the next boot partition.
+ *
+ * @author christophermena
+ * @date July 30, 2025
+ * @version 1.0
+ * @note Last Updated: October 16, 2026
+ */
+
+#include <string.h>
+#include "esp_log.h"
+#include "esp_ota_ops.h"
+#include "esp_partition.h"
+#include "esp_rom_crc.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "nvs.h"
+#include "sys/param.h"
+
+#include "ota_update.h"
+
+// Tag used for ESP serial console messages
+static const char TAG[] = "ota_update";
+
+// Flash sector size, every sector must be erased before it is written
+#define OTA_UPDATE_SECTOR_SIZE      4096
+
+// NVS keys of the persisted session
+#define OTA_UPDATE_KEY_SIZE         "size"
+#define OTA_UPDATE_KEY_CRC          "crc"
+#define OTA_UPDATE_KEY_ADDR         "addr"
+#define OTA_UPDATE_KEY_OFFSET       "offset"
+
+// Current session, protected by ota_update_mutex
+static ota_update_state_t g_ota_state;
+
+// Partition the current session writes to
+static const esp_partition_t *g_ota_partition = NULL;
+
+// Mutex serializing sessions between the HTTP server and other writers
+static SemaphoreHandle_t ota_update_mutex = NULL;
+
+// Scratch buffer used to read the image back during finalization
+static uint8_t ota_update_verify_buff[OTA_UPDATE_SECTOR_SIZE];
+
+/**
+ * @brief Persists the session identity and committed offset to NVS.
+ * @return ESP_OK on success, otherwise the NVS error.
+ */
+static esp_err_t ota_update_save_state(void)
+{
+    nvs_handle_t handle;
+    esp_err_t err = nvs_open(OTA_UPDATE_NVS_NAMESPACE, NVS_READWRITE, &handle);
+    if (err != ESP_OK)
+    {
+        return err;
+    }
+
+    nvs_set_u32(handle, OTA_UPDATE_KEY_SIZE, g_ota_state.image_size);
+    nvs_set_u32(handle, OTA_UPDATE_KEY_CRC, g_ota_state.image_crc);
+    nvs_set_u32(handle, OTA_UPDATE_KEY_ADDR, g_ota_partition->address);
+    nvs_set_u32(handle, OTA_UPDATE_KEY_OFFSET, g_ota_state.committed);
+    err = nvs_commit(handle);
+    nvs_close(handle);
+
+    return err;
+}
+
+/**
+ * @brief Removes the persisted session from NVS.
+ */
+static void ota_update_clear_state(void)
+{
+    nvs_handle_t handle;
+    if (nvs_open(OTA_UPDATE_NVS_NAMESPACE, NVS_READWRITE, &handle) == ESP_OK)
+    {
+        nvs_erase_all(handle);
+        nvs_commit(handle);
+        nvs_close(handle);
+    }
+}
+
+/**
+ * @brief Loads a persisted session from NVS if it still targets the next update partition.
+ */
+static void ota_update_load_state(void)
+{
+    nvs_handle_t handle;
+    uint32_t addr = 0;
+
+    if (nvs_open(OTA_UPDATE_NVS_NAMESPACE, NVS_READONLY, &handle) != ESP_OK)
+    {
+        return;
+    }
+
+    bool found = nvs_get_u32(handle, OTA_UPDATE_KEY_SIZE, &g_ota_state.image_size) == ESP_OK
+              && nvs_get_u32(handle, OTA_UPDATE_KEY_CRC, &g_ota_state.image_crc) == ESP_OK
+              && nvs_get_u32(handle, OTA_UPDATE_KEY_ADDR, &addr) == ESP_OK
+              && nvs_get_u32(handle, OTA_UPDATE_KEY_OFFSET, &g_ota_state.committed) == ESP_OK;
+    nvs_close(handle);
+
+    g_ota_partition = esp_ota_get_next_update_partition(NULL);
+    if (!found || g_ota_partition == NULL || g_ota_partition->address != addr || g_ota_state.committed > g_ota_state.image_size)
+    {
+        memset(&g_ota_state, 0, sizeof(g_ota_state));
+        return;
+    }
+
+    // The sector holding the committed offset may have been half written when power was lost,
+    // so fall back to its start and erase it before continuing
+    g_ota_state.committed -= g_ota_state.committed % OTA_UPDATE_SECTOR_SIZE;
+    if (esp_partition_erase_range(g_ota_partition, g_ota_state.committed, OTA_UPDATE_SECTOR_SIZE) != ESP_OK)
+    {
+        memset(&g_ota_state, 0, sizeof(g_ota_state));
+        return;
+    }
+    g_ota_state.active = true;
+
+    ESP_LOGI(TAG, "ota_update_load_state: resuming image of %lu bytes at offset %lu", g_ota_state.image_size, g_ota_state.committed);
+}
+
+/**
+ * @brief Reads the written image back, checks its CRC-32 and selects it as boot partition.
+ * @return ESP_OK if the image is valid and will be booted next, ESP_ERR_OTA_VALIDATE_FAILED otherwise.
+ */
+static esp_err_t ota_update_finalize(void)
+{
+    uint32_t crc = 0;
+
+    for (uint32_t offset = 0; offset < g_ota_state.image_size; offset += sizeof(ota_update_verify_buff))
+    {
+        size_t len = MIN(sizeof(ota_update_verify_buff), g_ota_state.image_size - offset);
+        if (esp_partition_read(g_ota_partition, offset, ota_update_verify_buff, len) != ESP_OK)
+        {
+            return ESP_ERR_OTA_VALIDATE_FAILED;
+        }
+        crc = esp_rom_crc32_le(crc, ota_update_verify_buff, len);
+    }
+
+    if (crc != g_ota_state.image_crc)
+    {
+        ESP_LOGE(TAG, "ota_update_finalize: image CRC 0x%08lx does not match expected 0x%08lx", crc, g_ota_state.image_crc);
+        return ESP_ERR_OTA_VALIDATE_FAILED;
+    }
+
+    // esp_ota_set_boot_partition() verifies the image structure and checksum before switching
+    esp_err_t err = esp_ota_set_boot_partition(g_ota_partition);
+    if (err != ESP_OK)
+    {
+        ESP_LOGE(TAG, "ota_update_finalize: esp_ota_set_boot_partition failed: %s", esp_err_to_name(err));
+        return ESP_ERR_OTA_VALIDATE_FAILED;
+    }
+
+    ESP_LOGI(TAG, "ota_update_finalize: next boot partition subtype %d at offset 0x%lx", g_ota_partition->subtype, g_ota_partition->address);
+    return ESP_OK;
+}
+
+void ota_update_init(void)
+{
+    if (ota_update_mutex == NULL)
+    {
+        ota_update_mutex = xSemaphoreCreateMutex();
+        ota_update_load_state();
+    }
+}
+
+esp_err_t ota_update_begin(uint32_t image_size, uint32_t image_crc)
+{
+    esp_err_t err = ESP_OK;
+
+    xSemaphoreTake(ota_update_mutex, portMAX_DELAY);
+
+    if (g_ota_state.active && g_ota_state.image_size == image_size && g_ota_state.image_crc == image_crc)
+    {
+        // Same image as the interrupted transfer, keep the committed offset
+        g_ota_state.last_write_us = esp_timer_get_time();
+        xSemaphoreGive(ota_update_mutex);
+        return ESP_OK;
+    }
+
+    g_ota_partition = esp_ota_get_next_update_partition(NULL);
+    if (g_ota_partition == NULL)
+    {
+        err = ESP_ERR_NOT_FOUND;
+    }
+    else if (image_size == 0 || image_size > g_ota_partition->size)
+    {
+        err = ESP_ERR_INVALID_SIZE;
+    }
+    else
+    {
+        g_ota_state.active = true;
+        g_ota_state.image_size = image_size;
+        g_ota_state.image_crc = image_crc;
+        g_ota_state.committed = 0;
+        g_ota_state.last_write_us = esp_timer_get_time();
+        err = ota_update_save_state();
+
+        ESP_LOGI(TAG, "ota_update_begin: new image of %lu bytes for partition at offset 0x%lx", image_size, g_ota_partition->address);
+    }
+
+    xSemaphoreGive(ota_update_mutex);
+    return err;
+}
+
+esp_err_t ota_update_write_chunk(uint32_t offset, const uint8_t *data, size_t len, uint32_t chunk_crc)
+{
+    esp_err_t err;
+
+    xSemaphoreTake(ota_update_mutex, portMAX_DELAY);
+
+    if (!g_ota_state.active || offset != g_ota_state.committed)
+    {
+        err = ESP_ERR_INVALID_STATE;
+        goto out;
+    }
+    if (len == 0 || len > OTA_UPDATE_CHUNK_MAX_SIZE || len > g_ota_state.image_size - offset)
+    {
+        err = ESP_ERR_INVALID_SIZE;
+        goto out;
+    }
+    if (esp_rom_crc32_le(0, data, len) != chunk_crc)
+    {
+        err = ESP_ERR_INVALID_CRC;
+        goto out;
+    }
+
+    // Erase every sector the chunk reaches into that has not been erased by a previous chunk
+    uint32_t erased_end = (offset + OTA_UPDATE_SECTOR_SIZE - 1) / OTA_UPDATE_SECTOR_SIZE * OTA_UPDATE_SECTOR_SIZE;
+    uint32_t needed_end = (offset + len + OTA_UPDATE_SECTOR_SIZE - 1) / OTA_UPDATE_SECTOR_SIZE * OTA_UPDATE_SECTOR_SIZE;
+    if (needed_end > erased_end)
+    {
+        err = esp_partition_erase_range(g_ota_partition, erased_end, needed_end - erased_end);
+        if (err != ESP_OK)
+        {
+            goto out;
+        }
+    }
+
+    err = esp_partition_write(g_ota_partition, offset, data, len);
+    if (err != ESP_OK)
+    {
+        // The chunk may be partially written, rewind to the sector start so the retry lands on erased flash
+        g_ota_state.committed -= g_ota_state.committed % OTA_UPDATE_SECTOR_SIZE;
+        esp_partition_erase_range(g_ota_partition, g_ota_state.committed, OTA_UPDATE_SECTOR_SIZE);
+        ota_update_save_state();
+        goto out;
+    }
+
+    g_ota_state.committed += len;
+    g_ota_state.last_write_us = esp_timer_get_time();
+
+    if (g_ota_state.committed < g_ota_state.image_size)
+    {
+        err = ota_update_save_state();
+        goto out;
+    }
+
+    // Last chunk, the transfer is complete either way
+    err = ota_update_finalize();
+    g_ota_state.active = false;
+    ota_update_clear_state();
+
+out:
+    xSemaphoreGive(ota_update_mutex);
+    return err;
+}
+
+void ota_update_get_state(ota_update_state_t *state)
+{
+    xSemaphoreTake(ota_update_mutex, portMAX_DELAY);
+    *state = g_ota_state;
+    xSemaphoreGive(ota_update_mutex);
+}
+
+void ota_update_abort(void)
+{
+    xSemaphoreTake(ota_update_mutex, portMAX_DELAY);
+    memset(&g_ota_state, 0, sizeof(g_ota_state));
+    ota_update_clear_state();
+    xSemaphoreGive(ota_update_mutex);
+}
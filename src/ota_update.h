@@ -0,0 +1,100 @@
+/**
+ * @file ota_update.h
+ * @brief Resumable OTA Firmware Writer Header for ESP32 Weather Station
+ * @details This header file defines the interface for the resumable over-the-air
+ *          firmware writer. Firmware images are transferred as a sequence of
+ *          chunks, each protected by its own CRC-32. Every accepted chunk is
+ *          written straight to the next OTA partition and the committed offset
+ *          is persisted in NVS, so an interrupted transfer (dropped WiFi link
+ *          or even a reboot) resumes from the last good chunk instead of
+ *          starting over.
+ *
+ * @author christophermena
+ * @date July 30, 2025
+ * @version 1.0
+ * @note Last Updated: October 16, 2026
+ */
+
+#ifndef MAIN_OTA_UPDATE_H_
+#define MAIN_OTA_UPDATE_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "esp_err.h"
+
+// OTA Chunk Transfer Configuration
+#define OTA_UPDATE_CHUNK_MAX_SIZE       4096            ///< Largest chunk accepted in one request (one flash sector)
+#define OTA_UPDATE_NVS_NAMESPACE        "ota_update"    ///< NVS namespace holding the resumable session
+
+/**
+ * @brief Snapshot of the resumable OTA session
+ *
+ * An image is identified by its total size and the CRC-32 of the whole file.
+ * A transfer for a different size/CRC pair discards any previous session.
+ */
+typedef struct ota_update_state
+{
+    bool active;                ///< True while a session is open (image not yet finalized)
+    uint32_t image_size;        ///< Total size of the firmware image in bytes
+    uint32_t image_crc;         ///< CRC-32 of the complete firmware image
+    uint32_t committed;         ///< Number of bytes verified and written to flash
+    int64_t last_write_us;      ///< esp_timer time the session was last begun or written, 0 if restored from NVS
+} ota_update_state_t;
+
+/**
+ * @brief Initialize the OTA writer
+ *
+ * Creates the session mutex and restores an interrupted session from NVS.
+ * If the device rebooted mid-sector, the session is rewound to the start of
+ * that sector so the retransmitted data lands on erased flash.
+ *
+ * @note Must be called after nvs_flash_init()
+ */
+void ota_update_init(void);
+
+/**
+ * @brief Open a new session or resume the matching one
+ *
+ * If an unfinished session for the same image (size and CRC) exists, either
+ * in RAM or persisted in NVS, it is resumed. Otherwise a new session is
+ * started at offset 0 on the next OTA partition.
+ *
+ * @param image_size Total size of the firmware image in bytes
+ * @param image_crc CRC-32 (IEEE 802.3, as computed by zlib) of the whole image
+ * @return ESP_OK on success, ESP_ERR_INVALID_SIZE if the image does not fit
+ *         the update partition, ESP_ERR_NOT_FOUND if no update partition exists
+ */
+esp_err_t ota_update_begin(uint32_t image_size, uint32_t image_crc);
+
+/**
+ * @brief Verify and commit one chunk of the image
+ *
+ * The chunk must start exactly at the committed offset and its CRC-32 must
+ * match. Only then is it written to flash and the new committed offset made
+ * persistent. When the last chunk is committed the image is finalized.
+ *
+ * @param offset Byte offset of the chunk inside the image
+ * @param data Chunk payload
+ * @param len Chunk length, at most OTA_UPDATE_CHUNK_MAX_SIZE
+ * @param chunk_crc CRC-32 of the chunk payload
+ * @return ESP_OK if the chunk was committed,
+ *         ESP_ERR_INVALID_STATE if the offset does not match the committed offset,
+ *         ESP_ERR_INVALID_CRC if the chunk CRC does not match,
+ *         ESP_ERR_INVALID_SIZE if the chunk runs past the end of the image,
+ *         or the flash/OTA error that occurred
+ */
+esp_err_t ota_update_write_chunk(uint32_t offset, const uint8_t *data, size_t len, uint32_t chunk_crc);
+
+/**
+ * @brief Get the current session state
+ * @param state Destination for the state snapshot
+ */
+void ota_update_get_state(ota_update_state_t *state);
+
+/**
+ * @brief Discard the current session and its persisted progress
+ */
+void ota_update_abort(void);
+
+#endif /* MAIN_OTA_UPDATE_H_ */
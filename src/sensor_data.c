@@ -0,0 +1,92 @@
+/**
+ * @file sensor_data.c
+ * @brief Sensor Sample Publisher Implementation for ESP32 Weather Station
+ * @details This file implements the latest-sample store and the listener
+ *          fan-out used to distribute sensor readings to the rest of the
+ *          application. The sample is protected by a spinlock so readers in
+ *          other tasks always see a consistent copy.
+ *
+ * @author christophermena
+ * @date July 30, 2025
+ * @version 1.0
+ * @note Last Updated: October 16, 2026
+ */
+
+#include <stdio.h>
+#include <time.h>
+#include "freertos/FreeRTOS.h"
+
+#include "sensor_data.h"
+
+// Latest sample and read statistics
+static sensor_sample_t g_latest_sample;
+static uint32_t g_error_count = 0;
+
+// Registered listeners
+static sensor_data_listener_t g_listeners[SENSOR_DATA_MAX_LISTENERS];
+static int g_listener_count = 0;
+
+// Spinlock guarding the latest sample and the listener table
+static portMUX_TYPE sensor_data_lock = portMUX_INITIALIZER_UNLOCKED;
+
+void sensor_data_publish(int temperature, int humidity)
+{
+    sensor_sample_t sample;
+
+    portENTER_CRITICAL(&sensor_data_lock);
+    g_latest_sample.seq++;
+    g_latest_sample.timestamp = time(NULL);
+    g_latest_sample.temperature = temperature;
+    g_latest_sample.humidity = humidity;
+    sample = g_latest_sample;
+    int listener_count = g_listener_count;
+    portEXIT_CRITICAL(&sensor_data_lock);
+
+    // Listeners are only ever appended, so the first listener_count entries are stable
+    for (int i = 0; i < listener_count; i++)
+    {
+        g_listeners[i](&sample);
+    }
+}
+
+void sensor_data_publish_error(void)
+{
+    portENTER_CRITICAL(&sensor_data_lock);
+    g_error_count++;
+    portEXIT_CRITICAL(&sensor_data_lock);
+}
+
+bool sensor_data_get_latest(sensor_sample_t *sample)
+{
+    portENTER_CRITICAL(&sensor_data_lock);
+    *sample = g_latest_sample;
+    portEXIT_CRITICAL(&sensor_data_lock);
+
+    return sample->seq != 0;
+}
+
+uint32_t sensor_data_get_error_count(void)
+{
+    return g_error_count;
+}
+
+int sensor_data_format_json(const sensor_sample_t *sample, char *buff, size_t buff_size)
+{
+    return snprintf(buff, buff_size, "{\"seq\":%lu,\"time\":%lld,\"temperature_c\":%d,\"humidity\":%d}",
+                    sample->seq, sample->timestamp, sample->temperature, sample->humidity);
+}
+
+esp_err_t sensor_data_add_listener(sensor_data_listener_t listener)
+{
+    esp_err_t err = ESP_ERR_NO_MEM;
+
+    portENTER_CRITICAL(&sensor_data_lock);
+    if (g_listener_count < SENSOR_DATA_MAX_LISTENERS)
+    {
+        g_listeners[g_listener_count++] = listener;
+        err = ESP_OK;
+    }
+    portEXIT_CRITICAL(&sensor_data_lock);
+
+    return err;
+}
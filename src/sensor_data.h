@@ -0,0 +1,96 @@
+/**
+ * @file sensor_data.h
+ * @brief Sensor Sample Publisher Header for ESP32 Weather Station
+ * @details This header file defines the shared store for environmental
+ *          samples. The sensor loop publishes each reading here; consumers
+ *          such as the HTTP streaming endpoints read the latest sample or
+ *          register a listener that is called whenever a new sample is
+ *          produced. Every sample carries a sequence number so clients can
+ *          tell whether they have already seen it.
+ *
+ * @author christophermena
+ * @date July 30, 2025
+ * @version 1.0
+ * @note Last Updated: October 16, 2026
+ */
+
+#ifndef MAIN_SENSOR_DATA_H_
+#define MAIN_SENSOR_DATA_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "esp_err.h"
+
+// Sensor Data Configuration
+#define SENSOR_DATA_MAX_LISTENERS       6           ///< Maximum number of registered sample listeners
+
+/**
+ * @brief One environmental sample
+ */
+typedef struct sensor_sample
+{
+    uint32_t seq;           ///< Sequence number, starts at 1 and increments with every sample
+    int64_t timestamp;      ///< Wall clock time of the sample (seconds, time since boot until the clock is set)
+    int temperature;        ///< Temperature in degrees Celsius
+    int humidity;           ///< Relative humidity in percent
+} sensor_sample_t;
+
+/**
+ * @brief Listener called for every published sample
+ *
+ * Runs in the context of the publishing task, so it must not block.
+ * Typical listeners only copy the sample or schedule work elsewhere.
+ */
+typedef void (*sensor_data_listener_t)(const sensor_sample_t *sample);
+
+/**
+ * @brief Publish a new sample
+ *
+ * Stores the sample as the latest one, assigns the next sequence number and
+ * calls every registered listener.
+ *
+ * @param temperature Temperature in degrees Celsius
+ * @param humidity Relative humidity in percent
+ */
+void sensor_data_publish(int temperature, int humidity);
+
+/**
+ * @brief Record a failed sensor read
+ */
+void sensor_data_publish_error(void);
+
+/**
+ * @brief Get the latest sample
+ * @param sample Destination for the sample
+ * @return true if at least one sample has been published, false otherwise
+ */
+bool sensor_data_get_latest(sensor_sample_t *sample);
+
+/**
+ * @brief Get the number of failed sensor reads since boot
+ * @return Number of failed reads
+ */
+uint32_t sensor_data_get_error_count(void);
+
+/**
+ * @brief Format a sample as a JSON object
+ *
+ * Produces {"seq":N,"time":T,"temperature_c":C,"humidity":H}, the representation
+ * shared by all HTTP endpoints that return samples.
+ *
+ * @param sample Sample to format
+ * @param buff Destination buffer
+ * @param buff_size Size of the destination buffer
+ * @return Number of characters written (excluding the terminator), as snprintf()
+ */
+int sensor_data_format_json(const sensor_sample_t *sample, char *buff, size_t buff_size);
+
+/**
+ * @brief Register a listener for new samples
+ * @param listener Function called for each published sample
+ * @return ESP_OK on success, ESP_ERR_NO_MEM if all listener slots are in use
+ */
+esp_err_t sensor_data_add_listener(sensor_data_listener_t listener);
+
+#endif /* MAIN_SENSOR_DATA_H_ */
@@ -0,0 +1,343 @@
+/**
+ * @file sensor_history.c
+ * @brief Sensor History Store Implementation for ESP32 Weather Station
+ * @details This file implements the flash ring of sample records. The whole
+ *          partition is memory-mapped once at start-up; the writer appends
+ *          records with esp_partition_write() (which keeps the mapped cache
+ *          coherent) and the iterator decodes records directly from the
+ *          mapping, so exports stream from flash without any RAM buffer.
+ *
+ * @author christophermena
+ * @date July 30, 2025
+ * @version 1.0
+ * @note Last Updated: October 16, 2026
+ */
+
+#include <math.h>
+#include <string.h>
+#include "esp_log.h"
+#include "esp_partition.h"
+#include "sys/param.h"
+
+#include "sensor_history.h"
+
+// Tag used for ESP serial console messages
+static const char TAG[] = "sensor_history";
+
+#define SENSOR_HISTORY_MAGIC            0x31545348  ///< "HST1"
+#define SENSOR_HISTORY_ERASED_DELTA     0xFFFF      ///< Delta of an erased record
+
+/**
+ * @brief Sector header as stored in flash
+ */
+typedef struct sensor_history_sector
+{
+    uint32_t magic;         ///< SENSOR_HISTORY_MAGIC
+    uint32_t seq;           ///< Increments with every started sector
+    uint32_t base_time;     ///< Time the first record's delta is relative to
+    uint32_t reserved;      ///< 0xFFFFFFFF
+} sensor_history_sector_t;
+
+// History partition and its read-only mapping
+static const esp_partition_t *g_history_partition = NULL;
+static const uint8_t *g_history_map = NULL;
+static esp_partition_mmap_handle_t g_history_map_handle;
+static uint16_t g_sector_count = 0;
+
+// Write position (owned by the sensor task)
+static bool g_head_valid = false;
+static uint16_t g_head_sector = 0;
+static uint32_t g_head_seq = 0;
+static uint16_t g_head_record = 0;
+static uint32_t g_last_time = 0;
+
+/**
+ * @brief Returns the mapped header of a sector.
+ */
+static const sensor_history_sector_t *sensor_history_sector(uint16_t sector)
+{
+    return (const sensor_history_sector_t *)(g_history_map + (size_t)sector * SENSOR_HISTORY_SECTOR_SIZE);
+}
+
+/**
+ * @brief Returns the mapped bytes of a record.
+ */
+static const uint8_t *sensor_history_record(uint16_t sector, uint16_t record)
+{
+    return g_history_map + (size_t)sector * SENSOR_HISTORY_SECTOR_SIZE + SENSOR_HISTORY_HEADER_SIZE + record * SENSOR_HISTORY_RECORD_SIZE;
+}
+
+/**
+ * @brief Reads the time delta of a mapped record.
+ */
+static uint16_t sensor_history_delta(const uint8_t *record)
+{
+    return record[0] | (record[1] << 8);
+}
+
+/**
+ * @brief Erases the sector after the head and starts it with a new header.
+ * @param base_time time of the first record of the sector.
+ * @return ESP_OK on success, otherwise the flash error.
+ */
+static esp_err_t sensor_history_start_sector(uint32_t base_time)
+{
+    uint16_t sector = g_head_valid ? (g_head_sector + 1) % g_sector_count : 0;
+    size_t offset = (size_t)sector * SENSOR_HISTORY_SECTOR_SIZE;
+    sensor_history_sector_t header = {
+        .magic = SENSOR_HISTORY_MAGIC,
+        .seq = g_head_seq + 1,
+        .base_time = base_time,
+        .reserved = 0xFFFFFFFF,
+    };
+
+    esp_err_t err = esp_partition_erase_range(g_history_partition, offset, SENSOR_HISTORY_SECTOR_SIZE);
+    if (err == ESP_OK)
+    {
+        err = esp_partition_write(g_history_partition, offset, &header, sizeof(header));
+    }
+    if (err != ESP_OK)
+    {
+        ESP_LOGE(TAG, "sensor_history_start_sector: sector %d: %s", sector, esp_err_to_name(err));
+        return err;
+    }
+
+    g_head_valid = true;
+    g_head_sector = sector;
+    g_head_seq = header.seq;
+    g_head_record = 0;
+    g_last_time = base_time;
+    return ESP_OK;
+}
+
+esp_err_t sensor_history_init(void)
+{
+    if (g_history_map != NULL)
+    {
+        return ESP_OK;
+    }
+
+    g_history_partition = esp_partition_find_first(ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_ANY, SENSOR_HISTORY_PARTITION_LABEL);
+    if (g_history_partition == NULL)
+    {
+        ESP_LOGE(TAG, "sensor_history_init: no '%s' partition, history disabled", SENSOR_HISTORY_PARTITION_LABEL);
+        return ESP_ERR_NOT_FOUND;
+    }
+
+    const void *map;
+    esp_err_t err = esp_partition_mmap(g_history_partition, 0, g_history_partition->size, ESP_PARTITION_MMAP_DATA, &map, &g_history_map_handle);
+    if (err != ESP_OK)
+    {
+        ESP_LOGE(TAG, "sensor_history_init: mmap failed: %s", esp_err_to_name(err));
+        return err;
+    }
+    g_history_map = map;
+    g_sector_count = g_history_partition->size / SENSOR_HISTORY_SECTOR_SIZE;
+
+    // The head is the valid sector with the highest sequence number
+    for (uint16_t sector = 0; sector < g_sector_count; sector++)
+    {
+        const sensor_history_sector_t *header = sensor_history_sector(sector);
+        if (header->magic == SENSOR_HISTORY_MAGIC && (!g_head_valid || header->seq > g_head_seq))
+        {
+            g_head_valid = true;
+            g_head_sector = sector;
+            g_head_seq = header->seq;
+        }
+    }
+
+    // Replay the head sector to find the next free record and the last time
+    if (g_head_valid)
+    {
+        g_last_time = sensor_history_sector(g_head_sector)->base_time;
+        while (g_head_record < SENSOR_HISTORY_RECORDS_PER_SECTOR)
+        {
+            uint16_t delta = sensor_history_delta(sensor_history_record(g_head_sector, g_head_record));
+            if (delta == SENSOR_HISTORY_ERASED_DELTA)
+            {
+                break;
+            }
+            g_last_time += delta;
+            g_head_record++;
+        }
+    }
+
+    ESP_LOGI(TAG, "sensor_history_init: %d sectors (%d records), head sector %d record %d",
+             g_sector_count, g_sector_count * SENSOR_HISTORY_RECORDS_PER_SECTOR, g_head_sector, g_head_record);
+    return ESP_OK;
+}
+
+esp_err_t sensor_history_append(uint32_t time, int temperature, int humidity)
+{
+    esp_err_t err;
+
+    if (g_history_map == NULL)
+    {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    // Deltas only go forward and fit 16 bits, anything else starts a new sector
+    if (!g_head_valid || g_head_record >= SENSOR_HISTORY_RECORDS_PER_SECTOR ||
+        time < g_last_time || time - g_last_time > SENSOR_HISTORY_MAX_DELTA)
+    {
+        err = sensor_history_start_sector(time);
+        if (err != ESP_OK)
+        {
+            return err;
+        }
+    }
+
+    uint16_t delta = time - g_last_time;
+    uint8_t record[SENSOR_HISTORY_RECORD_SIZE] = {
+        delta & 0xFF,
+        delta >> 8,
+        (uint8_t)(int8_t)MAX(-128, MIN(127, temperature)),
+        (uint8_t)MAX(0, MIN(100, humidity)),
+    };
+    size_t offset = (size_t)g_head_sector * SENSOR_HISTORY_SECTOR_SIZE + SENSOR_HISTORY_HEADER_SIZE + g_head_record * SENSOR_HISTORY_RECORD_SIZE;
+
+    err = esp_partition_write(g_history_partition, offset, record, sizeof(record));
+    if (err != ESP_OK)
+    {
+        ESP_LOGE(TAG, "sensor_history_append: write failed: %s", esp_err_to_name(err));
+        return err;
+    }
+    g_head_record++;
+    g_last_time = time;
+    return ESP_OK;
+}
+
+esp_err_t sensor_history_iter_begin(sensor_history_iter_t *iter, uint32_t from, uint32_t to, uint32_t res)
+{
+    memset(iter, 0, sizeof(*iter));
+    if (g_history_map == NULL)
+    {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    iter->from = from;
+    iter->to = to;
+    iter->res = res;
+    if (g_head_valid)
+    {
+        // Oldest sector first: the one after the head
+        iter->sector = (g_head_sector + 1) % g_sector_count;
+        iter->sectors_left = g_sector_count;
+    }
+    return ESP_OK;
+}
+
+/**
+ * @brief Moves the iterator to the start of the next sector.
+ */
+static void sensor_history_iter_next_sector(sensor_history_iter_t *iter)
+{
+    iter->sector = (iter->sector + 1) % g_sector_count;
+    iter->sectors_left--;
+    iter->record = 0;
+}
+
+/**
+ * @brief Decodes the next raw record within [from, to).
+ * @param iter iterator.
+ * @param record destination for the record.
+ * @return true if a record was returned.
+ */
+static bool sensor_history_iter_next_raw(sensor_history_iter_t *iter, sensor_history_record_t *record)
+{
+    while (iter->sectors_left > 0)
+    {
+        const sensor_history_sector_t *header = sensor_history_sector(iter->sector);
+
+        if (iter->record == 0)
+        {
+            // Skip erased sectors and sectors that start after the range
+            if (header->magic != SENSOR_HISTORY_MAGIC || header->base_time >= iter->to)
+            {
+                sensor_history_iter_next_sector(iter);
+                continue;
+            }
+            iter->sector_seq = header->seq;
+            iter->time = header->base_time;
+        }
+        else if (header->seq != iter->sector_seq)
+        {
+            // The writer wrapped around and reused this sector while we were reading it
+            sensor_history_iter_next_sector(iter);
+            continue;
+        }
+
+        if (iter->record >= SENSOR_HISTORY_RECORDS_PER_SECTOR)
+        {
+            sensor_history_iter_next_sector(iter);
+            continue;
+        }
+
+        const uint8_t *encoded = sensor_history_record(iter->sector, iter->record);
+        uint16_t delta = sensor_history_delta(encoded);
+        if (delta == SENSOR_HISTORY_ERASED_DELTA)
+        {
+            sensor_history_iter_next_sector(iter);
+            continue;
+        }
+        iter->record++;
+        iter->time += delta;
+
+        if (iter->time < iter->from)
+        {
+            continue;
+        }
+        if (iter->time >= iter->to)
+        {
+            // Times only increase within a sector
+            sensor_history_iter_next_sector(iter);
+            continue;
+        }
+
+        record->time = iter->time;
+        record->temperature = (int8_t)encoded[2];
+        record->humidity = encoded[3];
+        return true;
+    }
+    return false;
+}
+
+bool sensor_history_iter_next(sensor_history_iter_t *iter, sensor_history_record_t *record)
+{
+    sensor_history_record_t raw;
+
+    if (iter->res <= 1)
+    {
+        return sensor_history_iter_next_raw(iter, record);
+    }
+
+    if (!iter->lookahead_valid && !sensor_history_iter_next_raw(iter, &iter->lookahead))
+    {
+        return false;
+    }
+    iter->lookahead_valid = false;
+
+    // Average all records that fall into the bucket of the first one
+    uint32_t bucket = iter->lookahead.time - iter->lookahead.time % iter->res;
+    int32_t temperature_sum = iter->lookahead.temperature;
+    int32_t humidity_sum = iter->lookahead.humidity;
+    int count = 1;
+
+    while (sensor_history_iter_next_raw(iter, &raw))
+    {
+        if (raw.time - raw.time % iter->res != bucket)
+        {
+            iter->lookahead = raw;
+            iter->lookahead_valid = true;
+            break;
+        }
+        temperature_sum += raw.temperature;
+        humidity_sum += raw.humidity;
+        count++;
+    }
+
+    record->time = bucket;
+    record->temperature = (int)lroundf((float)temperature_sum / count);
+    record->humidity = (int)lroundf((float)humidity_sum / count);
+    return true;
+}
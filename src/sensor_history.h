@@ -0,0 +1,103 @@
+/**
+ * @file sensor_history.h
+ * @brief Sensor History Store Header for ESP32 Weather Station
+ * @details This header file defines the persistent sample history. Samples
+ *          are appended as 4 byte records to a ring of flash sectors in the
+ *          "history" data partition and read back through an iterator that
+ *          decodes them straight from the memory-mapped partition, optionally
+ *          averaged to a coarser resolution. Readers never copy the store.
+ *
+ *          Sector layout: 16 byte header (magic, sequence number, base time)
+ *          followed by 1020 records of {u16 seconds since the previous record,
+ *          i8 temperature (C), u8 humidity (%)}. An erased record (0xFFFF)
+ *          ends the sector. A new sector is started when the current one is
+ *          full or the clock jumps (backwards, or by more than ~18 h).
+ *
+ * @author christophermena
+ * @date July 30, 2025
+ * @version 1.0
+ * @note Last Updated: October 16, 2026
+ */
+
+#ifndef MAIN_SENSOR_HISTORY_H_
+#define MAIN_SENSOR_HISTORY_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "esp_err.h"
+
+// History Store Configuration
+#define SENSOR_HISTORY_PARTITION_LABEL  "history"   ///< Data partition holding the ring
+#define SENSOR_HISTORY_SECTOR_SIZE      4096        ///< Flash erase unit
+#define SENSOR_HISTORY_HEADER_SIZE      16          ///< Sector header size
+#define SENSOR_HISTORY_RECORD_SIZE      4           ///< Encoded record size
+#define SENSOR_HISTORY_RECORDS_PER_SECTOR   ((SENSOR_HISTORY_SECTOR_SIZE - SENSOR_HISTORY_HEADER_SIZE) / SENSOR_HISTORY_RECORD_SIZE)
+#define SENSOR_HISTORY_MAX_DELTA        0xFFFE      ///< Largest gap (s) between two records of a sector
+
+/**
+ * @brief One decoded history record
+ */
+typedef struct sensor_history_record
+{
+    uint32_t time;          ///< Time of the sample (seconds, see sensor_sample_t)
+    int temperature;        ///< Temperature in degrees Celsius
+    int humidity;           ///< Relative humidity in percent
+} sensor_history_record_t;
+
+/**
+ * @brief History iterator, see sensor_history_iter_begin()
+ */
+typedef struct sensor_history_iter
+{
+    uint32_t from;                      ///< First time included
+    uint32_t to;                        ///< First time excluded
+    uint32_t res;                       ///< Resolution in seconds, 0 or 1 for raw records
+    uint16_t sector;                    ///< Current sector index
+    uint16_t sectors_left;              ///< Sectors not yet finished, including the current one
+    uint32_t sector_seq;                ///< Sequence number of the current sector
+    uint16_t record;                    ///< Next record index in the current sector
+    uint32_t time;                      ///< Time of the previously decoded record
+    bool lookahead_valid;               ///< A decoded raw record is waiting in lookahead
+    sensor_history_record_t lookahead;  ///< First raw record of the next bucket
+} sensor_history_iter_t;
+
+/**
+ * @brief Map the history partition and find the write position
+ * @return ESP_OK on success, ESP_ERR_NOT_FOUND if the partition table has no history partition
+ */
+esp_err_t sensor_history_init(void);
+
+/**
+ * @brief Append a sample to the history
+ * @param time Time of the sample in seconds
+ * @param temperature Temperature in degrees Celsius
+ * @param humidity Relative humidity in percent
+ * @return ESP_OK on success, otherwise the flash error
+ * @note Single writer: only call from the sensor task
+ */
+esp_err_t sensor_history_append(uint32_t time, int temperature, int humidity);
+
+/**
+ * @brief Start iterating the history, oldest record first
+ *
+ * With res > 1 the iterator returns one record per res-second bucket that
+ * contains samples: its time is the start of the bucket and its values are
+ * the rounded averages of the samples in the bucket.
+ *
+ * @param iter Iterator to initialize
+ * @param from First time included
+ * @param to First time excluded
+ * @param res Resolution in seconds, 0 for raw records
+ * @return ESP_OK, or ESP_ERR_INVALID_STATE if the store is not available
+ */
+esp_err_t sensor_history_iter_begin(sensor_history_iter_t *iter, uint32_t from, uint32_t to, uint32_t res);
+
+/**
+ * @brief Decode the next record
+ * @param iter Iterator
+ * @param record Destination for the record
+ * @return true if a record was returned, false at the end of the range
+ */
+bool sensor_history_iter_next(sensor_history_iter_t *iter, sensor_history_record_t *record);
+
+#endif /* MAIN_SENSOR_HISTORY_H_ */
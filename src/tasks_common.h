@@ -11,7 +11,7 @@
  * @author christophermena
  * @date July 30, 2025
  * @version 1.0
- * @note Last Updated: August 1, 2025 at 10:30 AM
+ * @note Last Updated: October 16, 2026
  */
 
 #ifndef MAIN_TASKS_COMMON_H_
@@ -49,9 +49,29 @@
 #define HTTP_SERVER_MONITOR_PRIORITY        3           ///< Task priority (normal - status monitoring)
 #define HTTP_SERVER_MONITOR_CORE_ID         0           ///< CPU core assignment (Core 0 - networking related)
 
+// OTA Fetch Task Configuration (pull-mode firmware download)
+#define OTA_FETCH_TASK_STACK_SIZE           8192        ///< Stack size in bytes for OTA download task (HTTP client, TLS)
+#define OTA_FETCH_TASK_PRIORITY             3           ///< Task priority (normal - background download)
+#define OTA_FETCH_TASK_CORE_ID              0           ///< CPU core assignment (Core 0 - networking)
+
+// OTA Flash Writer Task Configuration (second stage of the download pipeline)
+#define OTA_WRITER_TASK_STACK_SIZE          3072        ///< Stack size in bytes for OTA flash writer task
+#define OTA_WRITER_TASK_PRIORITY            3           ///< Task priority (normal - keeps pace with the download)
+#define OTA_WRITER_TASK_CORE_ID             1           ///< CPU core assignment (Core 1 - overlaps with networking on core 0)
+
 // DHT11 Sensor Task Configuration
 #define DHT_SENSOR_TASK_STACK_SIZE          4096        ///< Stack size in bytes for DHT11 sensor task
 #define DHT_SENSOR_TASK_PRIORITY            2           ///< Task priority (low-normal - periodic sensor reading)
 #define DHT_SENSOR_TASK_CORE_ID             0           ///< CPU core assignment (Core 0 - application task)
 
+// Display Service Task Configuration (owns the I2C LCD)
+#define DISPLAY_APP_TASK_STACK_SIZE         3072        ///< Stack size in bytes for display task
+#define DISPLAY_APP_TASK_PRIORITY           1           ///< Task priority (background - never delays sampling)
+#define DISPLAY_APP_TASK_CORE_ID            1           ///< CPU core assignment (Core 1 - application tasks)
+
+// I2C Bus Arbiter Task Configuration (owns the shared I2C bus)
+#define I2C_BUS_TASK_STACK_SIZE             3072        ///< Stack size in bytes for I2C bus arbiter task
+#define I2C_BUS_TASK_PRIORITY               5           ///< Task priority (high - starts the next transaction as soon as the bus is free, blocks while it runs)
+#define I2C_BUS_TASK_CORE_ID                1           ///< CPU core assignment (Core 1 - with the display and sensor users)
+
 #endif /* MAIN_TASKS_COMMON_H_ */
\ No newline at end of file
@@ -0,0 +1,60 @@
+/**
+ * @file time_sync.c
+ * @brief Wall Clock Synchronization Implementation for ESP32 Weather Station
+ * @details This file starts the esp_netif SNTP client, which keeps the clock
+ *          in step with the server for as long as the station stays up.
+ *
+ * @author christophermena
+ * @date July 30, 2025
+ * @version 1.0
+ * @note Last Updated: October 16, 2026
+ */
+
+#include <stdlib.h>
+#include <time.h>
+#include "esp_log.h"
+#include "esp_netif_sntp.h"
+
+#include "time_sync.h"
+
+// Tag used for ESP serial console messages
+static const char TAG[] = "time_sync";
+
+// Set once the client has been started (only the WiFi task starts it)
+static bool g_started = false;
+
+/**
+ * @brief SNTP callback, called whenever the clock has been set.
+ * @param tv time received from the server.
+ */
+static void time_sync_notification(struct timeval *tv)
+{
+    ESP_LOGI(TAG, "time_sync_notification: clock set to %lld", (long long)tv->tv_sec);
+}
+
+void time_sync_start(void)
+{
+    if (g_started)
+    {
+        return;
+    }
+
+    setenv("TZ", TIME_SYNC_TIMEZONE, 1);
+    tzset();
+
+    esp_sntp_config_t config = ESP_NETIF_SNTP_DEFAULT_CONFIG(TIME_SYNC_SERVER);
+    config.sync_cb = time_sync_notification;
+    esp_err_t err = esp_netif_sntp_init(&config);
+    if (err != ESP_OK)
+    {
+        ESP_LOGE(TAG, "time_sync_start: esp_netif_sntp_init failed: %s", esp_err_to_name(err));
+        return;
+    }
+    g_started = true;
+    ESP_LOGI(TAG, "time_sync_start: SNTP server %s", TIME_SYNC_SERVER);
+}
+
+bool time_sync_is_valid(void)
+{
+    return time(NULL) >= TIME_SYNC_MIN_VALID_TIME;
+}
@@ -0,0 +1,42 @@
+/**
+ * @file time_sync.h
+ * @brief Wall Clock Synchronization Header for ESP32 Weather Station
+ * @details This header file defines the SNTP client that sets the system
+ *          clock once the station has an IP address. The clock starts near
+ *          zero at every power-up, so anything that stores or groups samples
+ *          by time (the history, the display's daily range) checks
+ *          time_sync_is_valid() first.
+ *
+ * @author christophermena
+ * @date July 30, 2025
+ * @version 1.0
+ * @note Last Updated: October 16, 2026
+ */
+
+#ifndef MAIN_TIME_SYNC_H_
+#define MAIN_TIME_SYNC_H_
+
+#include <stdbool.h>
+
+// Time Sync Configuration
+#define TIME_SYNC_SERVER                "pool.ntp.org"  ///< SNTP server
+#define TIME_SYNC_TIMEZONE              "UTC0"          ///< POSIX TZ string used by localtime()
+#define TIME_SYNC_MIN_VALID_TIME        1735689600      ///< 2025-01-01 00:00 UTC, earlier clocks were never set
+
+/**
+ * @brief Start the SNTP client (does nothing if it is running)
+ * @note Call once the station interface has an IP address
+ */
+void time_sync_start(void);
+
+/**
+ * @brief Check whether the system clock holds the wall time
+ *
+ * True once SNTP has set the clock, and after a software reset that kept
+ * the RTC running since the last sync.
+ *
+ * @return true if time() can be used as a calendar time
+ */
+bool time_sync_is_valid(void);
+
+#endif /* MAIN_TIME_SYNC_H_ */
@@ -3,12 +3,17 @@
  */
 var seconds 	= null;
 var otaTimerVar =  null;
+var otaChunkSize = 4096;
+var crcTable 	= null;
+var sensorStream = null;
 
 /**
  * Initialize functions here.
  */
 $(document).ready(function(){
 	getUpdateStatus();
+	startSensorStream();
+	getSettings();
 });   
 
 /**
@@ -24,26 +29,22 @@ function getFileInfo()
 
 /**
  * Handles the firmware update.
+ * The image is sent in CRC protected chunks to /OTAchunk. If the link drops,
+ * the upload asks /OTAresume for the last committed offset and continues from there.
  */
 function updateFirmware() 
 {
-    // Form Data
-    var formData = new FormData();
     var fileSelect = document.getElementById("selected_file");
     
     if (fileSelect.files && fileSelect.files.length == 1) 
 	{
         var file = fileSelect.files[0];
-        formData.set("file", file, file.name);
         document.getElementById("ota_update_status").innerHTML = "Uploading " + file.name + ", Firmware Update in Progress...";
 
-        // Http Request
-        var request = new XMLHttpRequest();
-
-        request.upload.addEventListener("progress", updateProgress);
-        request.open('POST', "/OTAupdate");
-        request.responseType = "blob";
-        request.send(formData);
+        file.arrayBuffer().then(function(buffer) {
+            var image = new Uint8Array(buffer);
+            otaUpload(image, crc32(image), 0);
+        });
     } 
 	else 
 	{
@@ -52,18 +53,97 @@ function updateFirmware()
 }
 
 /**
- * Progress on transfers from the server to the client (downloads).
+ * Sends the image chunk by chunk starting at offset, resuming after errors.
  */
-function updateProgress(oEvent) 
+function otaUpload(image, imageCrc, offset)
 {
-    if (oEvent.lengthComputable) 
+    if (offset >= image.length)
 	{
         getUpdateStatus();
-    } 
-	else 
+        return;
+    }
+
+    var chunk = image.subarray(offset, Math.min(offset + otaChunkSize, image.length));
+    var request = new XMLHttpRequest();
+
+    request.open('POST', "/OTAchunk");
+    request.setRequestHeader("X-OTA-Image-Size", image.length);
+    request.setRequestHeader("X-OTA-Image-CRC", imageCrc);
+    request.setRequestHeader("X-OTA-Offset", offset);
+    request.setRequestHeader("X-OTA-Chunk-CRC", crc32(chunk));
+    request.onload = function() {
+        // Session replies are JSON; a rejected request (bad headers, image too large, download running) is plain text
+        var contentType = request.getResponseHeader("Content-Type") || "";
+        if (request.status != 200 && contentType.indexOf("application/json") != 0)
+		{
+            document.getElementById("ota_update_status").textContent = "Firmware Update Failed: " + request.status + " " + request.responseText;
+            return;
+        }
+
+        var session = JSON.parse(request.responseText);
+
+        if (request.status == 500)
+		{
+            getUpdateStatus();
+            return;
+        }
+        // 200 advances, 409/422 tell us where the device wants to continue
+        document.getElementById("ota_update_status").innerHTML = "Firmware Update in Progress... " + Math.floor(session.offset * 100 / image.length) + "%";
+        otaUpload(image, imageCrc, session.offset);
+    };
+    request.onerror = request.ontimeout = function() {
+        document.getElementById("ota_update_status").innerHTML = "Connection lost, resuming...";
+        setTimeout(function() { otaResume(image, imageCrc); }, 2000);
+    };
+    request.timeout = 20000;
+    request.send(chunk);
+}
+
+/**
+ * Asks the device for the committed offset and continues the upload from there.
+ */
+function otaResume(image, imageCrc)
+{
+    var request = new XMLHttpRequest();
+
+    request.open('GET', "/OTAresume");
+    request.onload = function() {
+        var session = JSON.parse(request.responseText);
+        var sameImage = session.active && session.size == image.length && session.crc == imageCrc;
+        otaUpload(image, imageCrc, sameImage ? session.offset : 0);
+    };
+    request.onerror = request.ontimeout = function() {
+        setTimeout(function() { otaResume(image, imageCrc); }, 2000);
+    };
+    request.timeout = 10000;
+    request.send();
+}
+
+/**
+ * CRC-32 (IEEE 802.3) of a byte array, matches the device side check.
+ */
+function crc32(bytes)
+{
+    if (crcTable == null)
+	{
+        crcTable = new Uint32Array(256);
+        for (var n = 0; n < 256; n++)
+		{
+            var c = n;
+            for (var k = 0; k < 8; k++)
+			{
+                c = (c & 1) ? (0xEDB88320 ^ (c >>> 1)) : (c >>> 1);
+            }
+            crcTable[n] = c;
+        }
+    }
+
+    var crc = 0xFFFFFFFF;
+    for (var i = 0; i < bytes.length; i++)
 	{
-        window.alert('total size is unknown')
+        crc = crcTable[(crc ^ bytes[i]) & 0xFF] ^ (crc >>> 8);
     }
+    return (crc ^ 0xFFFFFFFF) >>> 0;
 }
 
 /**
@@ -73,12 +153,15 @@ function getUpdateStatus()
 {
     var xhr = new XMLHttpRequest();
     var requestURL = "/OTAstatus";
-    xhr.open('POST', requestURL, false);
-    xhr.send('ota_update_status');
+    xhr.open('POST', requestURL);
+    xhr.onload = function() {
+        if (xhr.status != 200)
+		{
+            return;
+        }
 
-    if (xhr.readyState == 4 && xhr.status == 200) 
-	{		
-        var response = JSON.parse(xhr.responseText);        document.getElementById("latest_firmware").innerHTML = response.compiled_date + " - " + response.compiled_time
+        var response = JSON.parse(xhr.responseText);
+        document.getElementById("latest_firmware").innerHTML = response.compiled_date + " - " + response.compiled_time
 
 		// If flashing was complete it will return a 1, else -1
 		// A return of 0 is just for information on the Latest Firmware request
@@ -93,7 +176,52 @@ function getUpdateStatus()
 		{
             document.getElementById("ota_update_status").innerHTML = "!!! Upload Error !!!";
         }
+    };
+    xhr.send('ota_update_status');
+}
+
+/**
+ * Loads the device settings into the settings controls.
+ */
+function getSettings()
+{
+    $.getJSON("/api/settings", function(settings) {
+        document.getElementById("temperature_unit").value = settings.unit;
+    });
+}
+
+/**
+ * Saves the temperature unit used by the LCD and the CSV export.
+ */
+function setTemperatureUnit(unit)
+{
+    $.post("/api/settings", "unit=" + unit);
+}
+
+/**
+ * Opens the /api/stream event stream and shows each sample as it arrives.
+ * EventSource reconnects on its own using the retry delay sent by the device.
+ */
+function startSensorStream()
+{
+    if (!window.EventSource)
+	{
+        document.getElementById("stream_status").innerHTML = "Live readings not supported by this browser";
+        return;
     }
+
+    sensorStream = new EventSource("/api/stream");
+    sensorStream.addEventListener("sample", function(event) {
+        var sample = JSON.parse(event.data);
+        var fahrenheit = Math.round(sample.temperature_c * 9 / 5 + 32);
+
+        document.getElementById("temperature_reading").innerHTML = sample.temperature_c + "&deg;C / " + fahrenheit + "&deg;F";
+        document.getElementById("humidity_reading").innerHTML = sample.humidity + "%";
+        document.getElementById("stream_status").innerHTML = "Sample #" + sample.seq + " at " + new Date().toLocaleTimeString();
+    });
+    sensorStream.onerror = function() {
+        document.getElementById("stream_status").innerHTML = "Connection lost, reconnecting...";
+    };
 }
 
 /**
@@ -0,0 +1,218 @@
+/**
+ * @file webui_store.c
+ * @brief Web UI Asset Store Implementation for ESP32 Weather Station
+ * @details This file implements the web UI asset store. The partition is
+ *          mapped once and the image validated (header, index bounds and
+ *          CRC-32); lookups scan the small index and return pointers into the
+ *          mapping. An update unmaps the partition, erases the used sectors,
+ *          writes the image as it is received and maps and validates it again.
+ *          Lookups and updates both run on the httpd task, so no request can
+ *          see a half-written image.
+ *
+ * @author christophermena
+ * @date July 30, 2025
+ * @version 1.0
+ * @note Last Updated: October 16, 2026
+ */
+
+#include <string.h>
+#include "esp_log.h"
+#include "esp_partition.h"
+#include "esp_rom_crc.h"
+
+#include "webui_store.h"
+
+// Tag used for ESP serial console messages
+static const char TAG[] = "webui_store";
+
+// Flash erase unit
+#define WEBUI_STORE_SECTOR_SIZE         4096
+
+// Partition and its read-only mapping
+static const esp_partition_t *g_webui_partition = NULL;
+static const uint8_t *g_webui_map = NULL;
+static esp_partition_mmap_handle_t g_webui_map_handle;
+
+// Validated image, NULL if none is installed
+static const webui_store_header_t *g_webui_image = NULL;
+
+// Update in progress
+static bool g_update_active = false;
+static uint32_t g_update_size = 0;
+static uint32_t g_update_offset = 0;
+
+/**
+ * @brief Checks that a fixed-size string field is NUL terminated.
+ */
+static bool webui_store_field_valid(const char *field, size_t size)
+{
+    return memchr(field, '\0', size) != NULL;
+}
+
+/**
+ * @brief Maps the partition and validates the image in it.
+ * @return ESP_OK if a valid image is installed.
+ */
+static esp_err_t webui_store_map(void)
+{
+    const void *map;
+
+    g_webui_image = NULL;
+    esp_err_t err = esp_partition_mmap(g_webui_partition, 0, g_webui_partition->size, ESP_PARTITION_MMAP_DATA, &map, &g_webui_map_handle);
+    if (err != ESP_OK)
+    {
+        ESP_LOGE(TAG, "webui_store_map: mmap failed: %s", esp_err_to_name(err));
+        return err;
+    }
+    g_webui_map = map;
+
+    const webui_store_header_t *header = (const webui_store_header_t *)g_webui_map;
+    if (header->magic != WEBUI_STORE_MAGIC || header->size < sizeof(*header) || header->size > g_webui_partition->size ||
+        header->count > (header->size - sizeof(*header)) / sizeof(webui_store_entry_t))
+    {
+        ESP_LOGW(TAG, "webui_store_map: no web UI image installed");
+        return ESP_ERR_INVALID_VERSION;
+    }
+
+    uint32_t crc = esp_rom_crc32_le(0, g_webui_map + sizeof(*header), header->size - sizeof(*header));
+    if (crc != header->crc)
+    {
+        ESP_LOGE(TAG, "webui_store_map: image CRC 0x%08lx, expected 0x%08lx", crc, header->crc);
+        return ESP_ERR_INVALID_CRC;
+    }
+
+    const webui_store_entry_t *entries = (const webui_store_entry_t *)(header + 1);
+    for (uint32_t i = 0; i < header->count; i++)
+    {
+        if (!webui_store_field_valid(entries[i].path, sizeof(entries[i].path)) ||
+            !webui_store_field_valid(entries[i].content_type, sizeof(entries[i].content_type)) ||
+            entries[i].offset > header->size || entries[i].size > header->size - entries[i].offset)
+        {
+            ESP_LOGE(TAG, "webui_store_map: entry %lu is invalid", i);
+            return ESP_ERR_INVALID_VERSION;
+        }
+    }
+
+    g_webui_image = header;
+    ESP_LOGI(TAG, "webui_store_map: %lu assets, %lu bytes, crc 0x%08lx", header->count, header->size, header->crc);
+    return ESP_OK;
+}
+
+esp_err_t webui_store_init(void)
+{
+    if (g_webui_partition != NULL)
+    {
+        return g_webui_image != NULL ? ESP_OK : ESP_ERR_INVALID_VERSION;
+    }
+
+    g_webui_partition = esp_partition_find_first(ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_ANY, WEBUI_STORE_PARTITION_LABEL);
+    if (g_webui_partition == NULL)
+    {
+        ESP_LOGE(TAG, "webui_store_init: no '%s' partition", WEBUI_STORE_PARTITION_LABEL);
+        return ESP_ERR_NOT_FOUND;
+    }
+    return webui_store_map();
+}
+
+bool webui_store_find(const char *path, webui_asset_t *asset)
+{
+    if (g_webui_image == NULL)
+    {
+        return false;
+    }
+    if (strcmp(path, "/") == 0)
+    {
+        path = "/index.html";
+    }
+
+    const webui_store_entry_t *entries = (const webui_store_entry_t *)(g_webui_image + 1);
+    for (uint32_t i = 0; i < g_webui_image->count; i++)
+    {
+        if (strcmp(entries[i].path, path) == 0)
+        {
+            asset->data = g_webui_map + entries[i].offset;
+            asset->size = entries[i].size;
+            asset->content_type = entries[i].content_type;
+            asset->gzip = (entries[i].flags & WEBUI_STORE_FLAG_GZIP) != 0;
+            return true;
+        }
+    }
+    return false;
+}
+
+uint32_t webui_store_get_crc(void)
+{
+    return g_webui_image != NULL ? g_webui_image->crc : 0;
+}
+
+esp_err_t webui_store_update_begin(const webui_store_header_t *header)
+{
+    if (g_webui_partition == NULL)
+    {
+        return ESP_ERR_NOT_FOUND;
+    }
+    if (header->magic != WEBUI_STORE_MAGIC || header->size < sizeof(*header))
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (header->size > g_webui_partition->size)
+    {
+        return ESP_ERR_INVALID_SIZE;
+    }
+
+    // Nothing may point into the old image any more
+    g_webui_image = NULL;
+    if (g_webui_map != NULL)
+    {
+        esp_partition_munmap(g_webui_map_handle);
+        g_webui_map = NULL;
+    }
+
+    size_t erase_size = (header->size + WEBUI_STORE_SECTOR_SIZE - 1) & ~(WEBUI_STORE_SECTOR_SIZE - 1);
+    esp_err_t err = esp_partition_erase_range(g_webui_partition, 0, erase_size);
+    if (err != ESP_OK)
+    {
+        ESP_LOGE(TAG, "webui_store_update_begin: erase failed: %s", esp_err_to_name(err));
+        return err;
+    }
+
+    g_update_active = true;
+    g_update_size = header->size;
+    g_update_offset = 0;
+    ESP_LOGI(TAG, "webui_store_update_begin: receiving %lu bytes", g_update_size);
+    return ESP_OK;
+}
+
+esp_err_t webui_store_update_write(const void *data, size_t len)
+{
+    if (!g_update_active)
+    {
+        return ESP_ERR_INVALID_STATE;
+    }
+    if (len > g_update_size - g_update_offset)
+    {
+        return ESP_ERR_INVALID_SIZE;
+    }
+
+    esp_err_t err = esp_partition_write(g_webui_partition, g_update_offset, data, len);
+    if (err == ESP_OK)
+    {
+        g_update_offset += len;
+    }
+    return err;
+}
+
+esp_err_t webui_store_update_end(void)
+{
+    if (!g_update_active)
+    {
+        return ESP_ERR_INVALID_STATE;
+    }
+    g_update_active = false;
+
+    if (g_update_offset != g_update_size)
+    {
+        ESP_LOGE(TAG, "webui_store_update_end: image incomplete (%lu of %lu bytes)", g_update_offset, g_update_size);
+    }
+    return webui_store_map();
+}
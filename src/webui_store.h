@@ -0,0 +1,114 @@
+/**
+ * @file webui_store.h
+ * @brief Web UI Asset Store Header for ESP32 Weather Station
+ * @details This header file defines the read-only store of web interface
+ *          assets kept in the "webui" data partition. The partition holds a
+ *          packed image built by tools/webui_pack.py: a header, a fixed-size
+ *          index of entries and the asset bodies. The partition is memory-
+ *          mapped, so assets are served straight from flash, and the image can
+ *          be replaced with a single upload without a firmware update.
+ *
+ *          Image layout (little endian): webui_store_header_t, then `count`
+ *          webui_store_entry_t, then the bodies. The CRC-32 covers everything
+ *          after the header.
+ *
+ * @author christophermena
+ * @date July 30, 2025
+ * @version 1.0
+ * @note Last Updated: October 16, 2026
+ */
+
+#ifndef MAIN_WEBUI_STORE_H_
+#define MAIN_WEBUI_STORE_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "esp_err.h"
+
+// Web UI Store Configuration
+#define WEBUI_STORE_PARTITION_LABEL     "webui"     ///< Data partition holding the image
+#define WEBUI_STORE_MAGIC               0x31495557  ///< "WUI1"
+#define WEBUI_STORE_PATH_MAX            32          ///< Path field size (NUL terminated)
+#define WEBUI_STORE_TYPE_MAX            20          ///< Content type field size (NUL terminated)
+#define WEBUI_STORE_FLAG_GZIP           0x01        ///< Body is gzip encoded
+
+/**
+ * @brief Image header as stored in flash
+ */
+typedef struct webui_store_header
+{
+    uint32_t magic;         ///< WEBUI_STORE_MAGIC
+    uint32_t count;         ///< Number of index entries
+    uint32_t size;          ///< Image size in bytes, header included
+    uint32_t crc;           ///< CRC-32 of the image after the header
+} webui_store_header_t;
+
+/**
+ * @brief Index entry as stored in flash
+ */
+typedef struct webui_store_entry
+{
+    char path[WEBUI_STORE_PATH_MAX];            ///< Request path, e.g. "/index.html"
+    char content_type[WEBUI_STORE_TYPE_MAX];    ///< Content-Type of the body
+    uint8_t flags;                              ///< WEBUI_STORE_FLAG_*
+    uint8_t reserved[3];                        ///< 0
+    uint32_t offset;                            ///< Body offset from the start of the image
+    uint32_t size;                              ///< Body size
+} webui_store_entry_t;
+
+/**
+ * @brief An asset, pointing into the mapped partition
+ */
+typedef struct webui_asset
+{
+    const uint8_t *data;        ///< Body
+    size_t size;                ///< Body size
+    const char *content_type;   ///< Content-Type of the body
+    bool gzip;                  ///< Body must be sent with Content-Encoding: gzip
+} webui_asset_t;
+
+/**
+ * @brief Map the partition and validate the image
+ * @return ESP_OK, ESP_ERR_NOT_FOUND without a partition,
+ *         ESP_ERR_INVALID_CRC / ESP_ERR_INVALID_VERSION if no valid image is installed
+ */
+esp_err_t webui_store_init(void);
+
+/**
+ * @brief Look up an asset
+ * @param path Request path without query string ("/" is looked up as "/index.html")
+ * @param asset Receives the asset, valid until the next image update
+ * @return true if the asset exists
+ * @note Call from the httpd task only (updates run there too)
+ */
+bool webui_store_find(const char *path, webui_asset_t *asset);
+
+/**
+ * @brief Get the CRC-32 of the installed image (used as ETag)
+ * @return CRC, 0 if no valid image is installed
+ */
+uint32_t webui_store_get_crc(void);
+
+/**
+ * @brief Start replacing the image: unmaps and erases the partition
+ * @param header Header of the new image (validated against the partition size)
+ * @return ESP_OK, ESP_ERR_INVALID_ARG for a bad header, ESP_ERR_INVALID_SIZE if it does not fit, otherwise the flash error
+ */
+esp_err_t webui_store_update_begin(const webui_store_header_t *header);
+
+/**
+ * @brief Write the next part of the image (header included)
+ * @param data Image bytes
+ * @param len Number of bytes
+ * @return ESP_OK, ESP_ERR_INVALID_STATE without update_begin(), ESP_ERR_INVALID_SIZE past the image size
+ */
+esp_err_t webui_store_update_write(const void *data, size_t len);
+
+/**
+ * @brief Finish the update: maps the partition again and validates the new image
+ * @return Result of the validation, see webui_store_init()
+ */
+esp_err_t webui_store_update_end(void);
+
+#endif /* MAIN_WEBUI_STORE_H_ */
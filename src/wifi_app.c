@@ -11,7 +11,7 @@
  * @author christophermena
  * @date July 30, 2025
  * @version 1.0
- * @note Last Updated: August 1, 2025 at 10:30 AM
+ * @note Last Updated: October 16, 2026
  */
 
 #include "freertos/FreeRTOS.h"
@@ -25,6 +25,7 @@
 
 #include "rgb_led.h"
 #include "tasks_common.h"
+#include "time_sync.h"
 #include "wifi_app.h"
 #include "http_server.h"
 
@@ -87,6 +88,7 @@ static void wifi_app_event_handler(void *arg, esp_event_base_t event_base, int32
 		{
 			case IP_EVENT_STA_GOT_IP:
 				ESP_LOGI(TAG, "IP_EVENT_STA_GOT_IP");
+				wifi_app_send_message(WIFI_APP_MSG_STA_CONNECTED_GOT_IP);
 				break;
 		}
 	}
@@ -205,6 +207,7 @@ static void wifi_app_task(void *pvParameters)
 				case WIFI_APP_MSG_STA_CONNECTED_GOT_IP:
 					ESP_LOGI(TAG, "WIFI_APP_MSG_STA_CONNECTED_GOT_IP");
 					rgb_led_wifi_connected();
+					time_sync_start();
 
 					break;
 
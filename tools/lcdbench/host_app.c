@@ -0,0 +1,107 @@
+/**
+ * @file host_app.c
+ * @brief Station Services for the Page Benchmark
+ * @details Implements the WiFi, network interface, settings, sensor, clock
+ *          and DHT11 functions display_app.c links against, answering with the
+ *          values set through host_app.h.
+ *
+ * @author christophermena
+ * @date July 30, 2025
+ * @version 1.0
+ * @note Last Updated: October 16, 2026
+ */
+
+#include <string.h>
+
+#include "esp_netif.h"
+#include "esp_wifi.h"
+
+#include "DHT11.h"
+#include "app_settings.h"
+#include "host_app.h"
+#include "sensor_data.h"
+#include "time_sync.h"
+#include "wifi_app.h"
+
+// Interface handles of wifi_app.c, the station's is only set while connected
+static int g_netif;
+esp_netif_t *esp_netif_sta = NULL;
+esp_netif_t *esp_netif_ap = (esp_netif_t *)&g_netif;
+
+// Answers
+static uint32_t g_station_ip;
+static int8_t g_station_rssi;
+static int g_ap_clients;
+static bool g_fahrenheit = true;
+static uint32_t g_errors;
+static bool g_clock_valid;
+
+void host_app_set_station(uint32_t ip, int8_t rssi)
+{
+    g_station_ip = ip;
+    g_station_rssi = rssi;
+    esp_netif_sta = ip != 0 ? (esp_netif_t *)&g_netif : NULL;
+}
+
+void host_app_set_ap_clients(int count)
+{
+    g_ap_clients = count;
+}
+
+void host_app_set_fahrenheit(bool fahrenheit)
+{
+    g_fahrenheit = fahrenheit;
+}
+
+void host_app_set_errors(uint32_t count)
+{
+    g_errors = count;
+}
+
+void host_app_set_clock_valid(bool valid)
+{
+    g_clock_valid = valid;
+}
+
+esp_err_t esp_netif_get_ip_info(esp_netif_t *esp_netif, esp_netif_ip_info_t *ip_info)
+{
+    memset(ip_info, 0, sizeof(*ip_info));
+    ip_info->ip.addr = esp_netif == esp_netif_sta ? g_station_ip : 0;
+    return ESP_OK;
+}
+
+esp_err_t esp_wifi_sta_get_ap_info(wifi_ap_record_t *ap_info)
+{
+    if (g_station_ip == 0)
+    {
+        return ESP_FAIL;                            // Not associated
+    }
+    ap_info->rssi = g_station_rssi;
+    return ESP_OK;
+}
+
+esp_err_t esp_wifi_ap_get_sta_list(wifi_sta_list_t *sta)
+{
+    sta->num = g_ap_clients;
+    return ESP_OK;
+}
+
+bool app_settings_get_fahrenheit(void)
+{
+    return g_fahrenheit;
+}
+
+bool time_sync_is_valid(void)
+{
+    return g_clock_valid;
+}
+
+uint32_t sensor_data_get_error_count(void)
+{
+    return g_errors;
+}
+
+float dht11_celsius_to_fahrenheit(int celsius)
+{
+    return celsius * 9.0f / 5.0f + 32.0f;
+}
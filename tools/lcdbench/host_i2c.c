@@ -0,0 +1,224 @@
+/**
+ * @file host_i2c.c
+ * @brief Recording I2C Bus for the LCD Benchmark
+ * @details Implements the i2c_master bus/device API, the delays and the
+ *          error names the LCD driver links against. Every transfer is
+ *          counted as one transaction and blocks the calling task (the bus
+ *          arbiter) on the scheduler of host_task.c until its last bit time
+ *          has passed; the task delays block as well, busy-wait delays only
+ *          move the clock on. The expander states are handed to the HD44780
+ *          model of host_lcd.c at the time they would reach the pins, and
+ *          reads are answered by it. A device at an address no PCF8574
+ *          answers to stands for a sensor: its writes are only counted and
+ *          its reads return 0xFF. Writes can be made to fail: the address
+ *          byte is not acknowledged and nothing reaches the pins.
+ *
+ * @author christophermena
+ * @date July 30, 2025
+ * @version 1.0
+ * @note Last Updated: October 16, 2026
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "driver/i2c_master.h"
+#include "esp_rom_sys.h"
+#include "freertos/task.h"
+
+#include "LiquidCrystal_I2C.h"
+#include "host_i2c.h"
+#include "host_lcd.h"
+#include "host_task.h"
+
+// One bit time on the bus
+#define HOST_I2C_BIT_NS             (1000000000ULL / HOST_I2C_FREQ_HZ)
+
+/**
+ * @brief Device attached to the bus
+ */
+struct i2c_master_dev_t
+{
+    uint16_t address;                       ///< 7-bit address
+    bool expander;                          ///< A PCF8574 backpack, false for a sensor
+    uint8_t output;                         ///< Last PCF8574 output state
+};
+
+// The one bus, its handle only needs to be unique
+static int g_bus;
+
+// Counters since the last reset
+static host_i2c_stats_t g_stats;
+
+// Bus time plus delays since start
+static uint64_t g_now_ns;
+
+// Writes still to be refused, and the address they are refused at
+static uint16_t g_fail_address;
+static uint32_t g_fail_writes;
+
+void host_i2c_reset(void)
+{
+    memset(&g_stats, 0, sizeof(g_stats));
+}
+
+void host_i2c_fail_writes(uint16_t address, uint32_t count)
+{
+    g_fail_address = address;
+    g_fail_writes = count;
+}
+
+void host_i2c_set_readback(bool enable)
+{
+    host_lcd_set_rw_wired(enable);
+}
+
+host_i2c_stats_t host_i2c_get_stats(void)
+{
+    return g_stats;
+}
+
+uint64_t host_i2c_get_time_us(void)
+{
+    return g_now_ns / 1000;
+}
+
+void host_i2c_idle(uint64_t us)
+{
+    g_now_ns += us * 1000;
+}
+
+const char *esp_err_to_name(esp_err_t code)
+{
+    switch (code)
+    {
+    case ESP_OK:
+        return "ESP_OK";
+    case ESP_ERR_TIMEOUT:
+        return "ESP_ERR_TIMEOUT";
+    case ESP_ERR_INVALID_STATE:
+        return "ESP_ERR_INVALID_STATE";
+    default:
+        return "ESP_FAIL";
+    }
+}
+
+void esp_rom_delay_us(uint32_t us)
+{
+    g_stats.delay_us += us;
+    g_now_ns += (uint64_t)us * 1000;
+}
+
+void vTaskDelay(TickType_t ticks)
+{
+    g_stats.delay_us += (uint64_t)ticks * portTICK_PERIOD_MS * 1000;
+    host_task_sleep((uint64_t)ticks * portTICK_PERIOD_MS * 1000);
+}
+
+esp_err_t i2c_new_master_bus(const i2c_master_bus_config_t *bus_config, i2c_master_bus_handle_t *ret_bus_handle)
+{
+    *ret_bus_handle = (i2c_master_bus_handle_t)&g_bus;
+    return ESP_OK;
+}
+
+esp_err_t i2c_master_bus_add_device(i2c_master_bus_handle_t bus_handle, const i2c_device_config_t *dev_config, i2c_master_dev_handle_t *ret_handle)
+{
+    i2c_master_dev_handle_t dev = calloc(1, sizeof(struct i2c_master_dev_t));
+    dev->address = dev_config->device_address;
+    dev->expander = (dev->address & 0x78) == 0x20 || (dev->address & 0x78) == 0x38;  // PCF8574 or PCF8574A
+    if (dev->expander)
+    {
+        host_lcd_power_on(dev->address, g_now_ns);
+    }
+    *ret_handle = dev;
+    return ESP_OK;
+}
+
+esp_err_t i2c_master_bus_rm_device(i2c_master_dev_handle_t handle)
+{
+    free(handle);
+    return ESP_OK;
+}
+
+/**
+ * @brief Records one transaction: a write, a read, or a write and a read after a repeated START.
+ * @param i2c_dev device addressed.
+ * @param write_buffer expander states written.
+ * @param write_size number of states written, 0 for a plain read.
+ * @param read_buffer receives the expander inputs.
+ * @param read_size number of bytes read, 0 for a plain write.
+ * @return ESP_OK, or ESP_ERR_INVALID_STATE for a write refused by host_i2c_fail_writes().
+ */
+static esp_err_t host_i2c_transfer(i2c_master_dev_handle_t i2c_dev, const uint8_t *write_buffer, size_t write_size, uint8_t *read_buffer, size_t read_size)
+{
+    // START and the address byte, then each state reaches the pins after its acknowledge
+    uint64_t t = g_now_ns + HOST_I2C_BIT_NS * 10;
+
+    if (write_size > 0 && i2c_dev->address == g_fail_address && g_fail_writes > 0)
+    {
+        // Address not acknowledged (NACK): the master sends STOP, the expander keeps its outputs
+        g_fail_writes--;
+        g_stats.transactions++;
+        g_stats.bytes++;
+        g_stats.bus_us += (uint64_t)(9 + HOST_I2C_START_STOP_BITS) * 1000000 / HOST_I2C_FREQ_HZ;
+        host_task_busy_until((t + HOST_I2C_BIT_NS + 999) / 1000);
+        return ESP_ERR_INVALID_STATE;
+    }
+    for (size_t n = 0; n < write_size && i2c_dev->expander; n++)
+    {
+        if ((i2c_dev->output & LCD_ENABLE_PIN) && !(write_buffer[n] & (LCD_ENABLE_PIN | LCD_RW_PIN)))
+        {
+            g_stats.strobes++;                      // The LCD latches a nibble on the falling edge of EN (reads latch nothing)
+        }
+        i2c_dev->output = write_buffer[n];
+        host_lcd_write(i2c_dev->address, write_buffer[n], t + HOST_I2C_BIT_NS * 9 * (n + 1));
+    }
+    t += HOST_I2C_BIT_NS * 9 * write_size;
+
+    // Address byte plus data, each 8 bits and the acknowledge bit; a read after a write adds a repeated START and its address byte
+    uint32_t bytes = 1 + write_size;
+    uint32_t bits = HOST_I2C_START_STOP_BITS;
+    if (read_size > 0)
+    {
+        g_stats.reads++;
+        bytes += read_size;
+        if (write_size > 0)
+        {
+            bytes++;
+            bits++;
+            t += HOST_I2C_BIT_NS * 10;              // Repeated START and the address byte
+        }
+        for (size_t n = 0; n < read_size; n++)
+        {
+            read_buffer[n] = i2c_dev->expander ? host_lcd_read(i2c_dev->address, i2c_dev->output, t) : 0xFF;
+            t += HOST_I2C_BIT_NS * 9;
+        }
+    }
+    g_stats.transactions++;
+    g_stats.bytes += bytes;
+    g_stats.bus_us += (uint64_t)(bytes * 9 + bits) * 1000000 / HOST_I2C_FREQ_HZ;
+
+    // The arbiter is blocked until STOP, other tasks run meanwhile
+    host_task_busy_until((t + HOST_I2C_BIT_NS + 999) / 1000);
+    return ESP_OK;
+}
+
+esp_err_t i2c_master_transmit(i2c_master_dev_handle_t i2c_dev, const uint8_t *write_buffer, size_t write_size, int xfer_timeout_ms)
+{
+    return host_i2c_transfer(i2c_dev, write_buffer, write_size, NULL, 0);
+}
+
+esp_err_t i2c_master_receive(i2c_master_dev_handle_t i2c_dev, uint8_t *read_buffer, size_t read_size, int xfer_timeout_ms)
+{
+    return host_i2c_transfer(i2c_dev, NULL, 0, read_buffer, read_size);
+}
+
+esp_err_t i2c_master_transmit_receive(i2c_master_dev_handle_t i2c_dev, const uint8_t *write_buffer, size_t write_size, uint8_t *read_buffer, size_t read_size, int xfer_timeout_ms)
+{
+    return host_i2c_transfer(i2c_dev, write_buffer, write_size, read_buffer, read_size);
+}
+
+esp_err_t i2c_master_probe(i2c_master_bus_handle_t bus_handle, uint16_t address, int xfer_timeout_ms)
+{
+    return ESP_OK;                                  // Every address answers
+}
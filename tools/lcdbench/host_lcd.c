@@ -0,0 +1,480 @@
+/**
+ * @file host_lcd.c
+ * @brief HD44780 Emulator for the LCD Benchmark
+ * @details Implements the controller model behind each backpack address.
+ *          Panels are kept in a small table indexed by the address bits
+ *          A0-A2 and power up on first use; host_i2c.c feeds them every
+ *          expander state with the bus time it appears on the pins. The
+ *          controller takes RS, R/W and D4-D7 as they were while EN was high
+ *          and acts on the falling edge: in 8-bit mode (after power-on) each
+ *          strobe is an instruction with D0-D3 low, in 4-bit mode the first
+ *          strobe holds the upper nibble and the second completes the byte.
+ *
+ * @author christophermena
+ * @date July 30, 2025
+ * @version 1.0
+ * @note Last Updated: October 16, 2026
+ */
+
+#include <string.h>
+
+#include "LiquidCrystal_I2C.h"
+#include "host_lcd.h"
+
+// DDRAM geometry: two lines of 40 characters at 0x00 and 0x40, or one line of 80
+#define HOST_LCD_LINE_LENGTH        40
+#define HOST_LCD_LINE2_ADDRESS      0x40
+#define HOST_LCD_ROW2_POSITION      20          // Rows 2 and 3 of a 20x4 module continue lines 1 and 2
+
+/**
+ * @brief Controller of one panel
+ */
+typedef struct host_lcd
+{
+    bool powered;                               ///< Powered up (first write or host_lcd_power_on)
+    uint8_t pins;                               ///< Expander state as the controller sees it (R/W low if not wired)
+    bool eight_bit;                             ///< Interface data length, 8 bits until a function set clears DL
+    bool two_line;                              ///< Two-line display (function set N)
+    uint8_t init_sets;                          ///< 8-bit function sets since power-on, for their execution times
+    bool nibble_pending;                        ///< Upper nibble latched, the lower one completes the byte
+    uint8_t nibble_high;                        ///< Upper nibble (data pin position)
+    uint8_t nibble_mode;                        ///< RS and R/W of the upper nibble
+    uint8_t read_byte;                          ///< Byte being read, taken at its first strobe
+    uint8_t drive;                              ///< Data pins driven while EN is high in a read (D4-D7 position)
+    bool driving;                               ///< The controller drives the data pins
+    uint8_t ddram[HOST_LCD_DDRAM_SIZE];         ///< Display data RAM, indexed by address
+    uint8_t cgram[HOST_LCD_CGRAM_SIZE];         ///< Character generator RAM, 8 rows per character
+    uint8_t ac;                                 ///< Address counter
+    bool ac_cgram;                              ///< The address counter points into CGRAM
+    bool increment;                             ///< Entry mode I/D
+    bool shift_on_write;                        ///< Entry mode S (display shifts with each write)
+    uint8_t shift;                              ///< Line position shown in the first column
+    bool display_on;                            ///< Display on/off control D
+    uint64_t busy_until_ns;                     ///< End of the instruction being executed
+    host_lcd_stats_t stats;                     ///< Counters since power-on
+} host_lcd_t;
+
+// Panels, indexed by the address bits A0-A2
+static host_lcd_t g_panels[HOST_LCD_PANELS];
+
+// R/W reaches the controllers
+static bool g_rw_wired = true;
+
+/**
+ * @brief Text form of a CGRAM pattern
+ */
+typedef struct host_lcd_glyph_text
+{
+    uint8_t pattern[8];                         ///< 8 rows of 5 pixels
+    char text;                                  ///< Character printed for it
+} host_lcd_glyph_text_t;
+
+// Patterns with a text form
+static host_lcd_glyph_text_t g_glyph_texts[HOST_LCD_GLYPH_TEXTS];
+static int g_glyph_text_count;
+
+/**
+ * @brief Gets the panel behind an address, powering it up on first use.
+ * @param address 7-bit I2C address.
+ * @param now_ns bus clock.
+ * @return panel.
+ */
+static host_lcd_t *host_lcd_get(uint16_t address, uint64_t now_ns)
+{
+    host_lcd_t *lcd = &g_panels[address & (HOST_LCD_PANELS - 1)];
+    if (!lcd->powered)
+    {
+        // Internal reset: display cleared, 8-bit, one line, display off, increment without shift
+        memset(lcd, 0, sizeof(*lcd));
+        memset(lcd->ddram, ' ', sizeof(lcd->ddram));
+        lcd->powered = true;
+        lcd->eight_bit = true;
+        lcd->increment = true;
+        lcd->busy_until_ns = now_ns + (uint64_t)HOST_LCD_POWER_ON_US * 1000;
+    }
+    return lcd;
+}
+
+/**
+ * @brief Moves a DDRAM address by one position, wrapping as the controller does.
+ * @param lcd panel.
+ * @param address DDRAM address.
+ * @param up true to increment.
+ * @return next address.
+ */
+static uint8_t host_lcd_ddram_step(const host_lcd_t *lcd, uint8_t address, bool up)
+{
+    if (!lcd->two_line)
+    {
+        int pos = (address + (up ? 1 : -1) + 2 * HOST_LCD_LINE_LENGTH) % (2 * HOST_LCD_LINE_LENGTH);
+        return (uint8_t)pos;
+    }
+
+    // 0x27 is followed by 0x40 and 0x67 by 0x00
+    uint8_t line = address & HOST_LCD_LINE2_ADDRESS;
+    int pos = (address & ~HOST_LCD_LINE2_ADDRESS) + (up ? 1 : -1);
+    if (pos >= HOST_LCD_LINE_LENGTH)
+    {
+        return line ^ HOST_LCD_LINE2_ADDRESS;
+    }
+    if (pos < 0)
+    {
+        return (line ^ HOST_LCD_LINE2_ADDRESS) | (HOST_LCD_LINE_LENGTH - 1);
+    }
+    return line | (uint8_t)pos;
+}
+
+/**
+ * @brief Moves the address counter after a data access.
+ * @param lcd panel.
+ */
+static void host_lcd_step(host_lcd_t *lcd)
+{
+    if (lcd->ac_cgram)
+    {
+        lcd->ac = (lcd->ac + (lcd->increment ? 1 : -1)) & (HOST_LCD_CGRAM_SIZE - 1);
+    }
+    else
+    {
+        lcd->ac = host_lcd_ddram_step(lcd, lcd->ac, lcd->increment);
+    }
+}
+
+/**
+ * @brief Shifts the display by one position.
+ * @param lcd panel.
+ * @param left true to move the contents left (later line positions come into view).
+ */
+static void host_lcd_shift(host_lcd_t *lcd, bool left)
+{
+    uint8_t length = lcd->two_line ? HOST_LCD_LINE_LENGTH : 2 * HOST_LCD_LINE_LENGTH;
+    lcd->shift = (lcd->shift + (left ? 1 : length - 1)) % length;
+}
+
+/**
+ * @brief Executes an instruction (RS low, R/W low).
+ * @param lcd panel.
+ * @param value instruction byte.
+ * @return execution time in microseconds.
+ */
+static uint32_t host_lcd_instruction(host_lcd_t *lcd, uint8_t value)
+{
+    lcd->stats.instructions++;
+
+    if (value & LCD_SET_DDRAM_ADDRESS)
+    {
+        lcd->ac = value & (HOST_LCD_DDRAM_SIZE - 1);
+        lcd->ac_cgram = false;
+    }
+    else if (value & LCD_SET_CGRAM_ADDRESS)
+    {
+        lcd->ac = value & (HOST_LCD_CGRAM_SIZE - 1);
+        lcd->ac_cgram = true;
+    }
+    else if (value & LCD_FUNCTION_SET)
+    {
+        lcd->eight_bit = (value & LCD_8_BIT_MODE) != 0;
+        lcd->two_line = (value & LCD_2_LINE_MODE) != 0;
+        lcd->nibble_pending = false;
+        if (lcd->eight_bit && lcd->init_sets < 2)
+        {
+            // Initialization by instruction: the first function sets take longer
+            return lcd->init_sets++ == 0 ? HOST_LCD_INIT_FIRST_US : HOST_LCD_INIT_SECOND_US;
+        }
+    }
+    else if (value & LCD_CURSOR_ON_DISPLAY_SHIFT)
+    {
+        if (value & LCD_DISPLAY_MOVE)
+        {
+            host_lcd_shift(lcd, !(value & LCD_MOVE_RIGHT));
+        }
+        else if (!lcd->ac_cgram)
+        {
+            lcd->ac = host_lcd_ddram_step(lcd, lcd->ac, (value & LCD_MOVE_RIGHT) != 0);
+        }
+    }
+    else if (value & LCD_DISPLAY_ON_OFF)
+    {
+        lcd->display_on = (value & LCD_DISPLAY_ON) != 0;
+    }
+    else if (value & LCD_ENTRY_MODE)
+    {
+        lcd->increment = (value & LCD_ENTRY_LEFT) != 0;
+        lcd->shift_on_write = (value & LCD_ENTRY_SHIFT_INCREMENT) != 0;
+    }
+    else if (value & LCD_RETURN_HOME)
+    {
+        lcd->ac = 0;
+        lcd->ac_cgram = false;
+        lcd->shift = 0;
+        return HOST_LCD_CLEAR_US;
+    }
+    else if (value & LCD_CLEAR_DISPLAY)
+    {
+        memset(lcd->ddram, ' ', sizeof(lcd->ddram));
+        lcd->ac = 0;
+        lcd->ac_cgram = false;
+        lcd->increment = true;
+        lcd->shift = 0;
+        return HOST_LCD_CLEAR_US;
+    }
+    return HOST_LCD_COMMAND_US;
+}
+
+/**
+ * @brief Acts on a complete byte.
+ * @param lcd panel.
+ * @param mode RS and R/W of the byte.
+ * @param value byte written (ignored for reads).
+ * @param now_ns bus clock.
+ */
+static void host_lcd_byte(host_lcd_t *lcd, uint8_t mode, uint8_t value, uint64_t now_ns)
+{
+    uint32_t us;
+
+    if (mode & LCD_RW_PIN)
+    {
+        lcd->stats.reads++;
+        if (!(mode & LCD_RS_PIN))
+        {
+            return;                                 // Busy flag read, executes nothing
+        }
+        host_lcd_step(lcd);                         // Data read: the address counter moves on
+        lcd->busy_until_ns = now_ns + (uint64_t)HOST_LCD_DATA_US * 1000;
+        return;
+    }
+
+    if (now_ns < lcd->busy_until_ns)
+    {
+        lcd->stats.busy_writes++;
+    }
+
+    if (mode & LCD_RS_PIN)
+    {
+        lcd->stats.data_writes++;
+        if (lcd->ac_cgram)
+        {
+            lcd->cgram[lcd->ac] = value & 0x1F;     // Five pixels per row
+        }
+        else
+        {
+            lcd->ddram[lcd->ac] = value;
+            if (lcd->shift_on_write)
+            {
+                host_lcd_shift(lcd, lcd->increment);
+            }
+        }
+        host_lcd_step(lcd);
+        us = HOST_LCD_DATA_US;
+    }
+    else
+    {
+        us = host_lcd_instruction(lcd, value);
+    }
+    lcd->busy_until_ns = now_ns + (uint64_t)us * 1000;
+}
+
+/**
+ * @brief Rising edge of EN in a read: the controller puts its next nibble on D4-D7.
+ * @param lcd panel.
+ * @param mode RS and R/W (R/W high).
+ * @param now_ns bus clock.
+ */
+static void host_lcd_read_strobe(host_lcd_t *lcd, uint8_t mode, uint64_t now_ns)
+{
+    if (lcd->eight_bit || !lcd->nibble_pending)
+    {
+        if (mode & LCD_RS_PIN)
+        {
+            lcd->read_byte = lcd->ac_cgram ? lcd->cgram[lcd->ac] : lcd->ddram[lcd->ac];
+        }
+        else
+        {
+            lcd->read_byte = (now_ns < lcd->busy_until_ns ? LCD_BUSY_FLAG : 0) | lcd->ac;
+        }
+        lcd->drive = lcd->read_byte & 0xF0;
+    }
+    else
+    {
+        lcd->drive = (uint8_t)(lcd->read_byte << 4);
+    }
+    lcd->driving = true;
+}
+
+/**
+ * @brief Falling edge of EN: the controller takes the nibble (or the 8-bit instruction).
+ * @param lcd panel.
+ * @param pins expander state while EN was high.
+ * @param now_ns bus clock.
+ */
+static void host_lcd_latch(host_lcd_t *lcd, uint8_t pins, uint64_t now_ns)
+{
+    uint8_t mode = pins & (LCD_RS_PIN | LCD_RW_PIN);
+    uint8_t data = pins & 0xF0;
+
+    lcd->driving = false;
+    if (lcd->eight_bit)
+    {
+        host_lcd_byte(lcd, mode, data, now_ns);     // D0-D3 are not connected and read as low
+        return;
+    }
+    if (!lcd->nibble_pending)
+    {
+        lcd->nibble_pending = true;
+        lcd->nibble_high = data;
+        lcd->nibble_mode = mode;
+        return;
+    }
+    lcd->nibble_pending = false;
+    if (mode != lcd->nibble_mode)
+    {
+        lcd->stats.sync_errors++;                   // The pair mixes a command, data or a read
+    }
+    host_lcd_byte(lcd, lcd->nibble_mode, lcd->nibble_high | (data >> 4), now_ns);
+}
+
+void host_lcd_power_on(uint16_t address, uint64_t now_ns)
+{
+    host_lcd_get(address, now_ns);
+}
+
+void host_lcd_write(uint16_t address, uint8_t state, uint64_t now_ns)
+{
+    host_lcd_t *lcd = host_lcd_get(address, now_ns);
+    uint8_t prev = lcd->pins;
+
+    if (!g_rw_wired)
+    {
+        state &= ~LCD_RW_PIN;
+    }
+    lcd->pins = state;
+
+    bool en_was = (prev & LCD_ENABLE_PIN) != 0;
+    bool en_is = (state & LCD_ENABLE_PIN) != 0;
+    bool mode_changed = ((prev ^ state) & (LCD_RS_PIN | LCD_RW_PIN)) != 0;
+
+    if (en_is && mode_changed)
+    {
+        lcd->stats.setup_errors++;                  // RS and R/W must settle before EN rises and hold while it is high
+    }
+    if (!en_was && en_is && (state & LCD_RW_PIN))
+    {
+        host_lcd_read_strobe(lcd, state & (LCD_RS_PIN | LCD_RW_PIN), now_ns);
+    }
+    else if (en_was && !en_is)
+    {
+        host_lcd_latch(lcd, prev, now_ns);
+    }
+}
+
+uint8_t host_lcd_read(uint16_t address, uint8_t outputs, uint64_t now_ns)
+{
+    host_lcd_t *lcd = host_lcd_get(address, now_ns);
+
+    if (lcd->driving && (lcd->pins & LCD_ENABLE_PIN))
+    {
+        return outputs & (lcd->drive | 0x0F);       // Quasi-bidirectional pins: only high outputs can be pulled low
+    }
+    return outputs;
+}
+
+void host_lcd_set_rw_wired(bool wired)
+{
+    g_rw_wired = wired;
+}
+
+uint8_t host_lcd_get_char(uint16_t address, uint8_t col, uint8_t row)
+{
+    const host_lcd_t *lcd = &g_panels[address & (HOST_LCD_PANELS - 1)];
+
+    if (!lcd->two_line)
+    {
+        return row == 0 ? lcd->ddram[(col + lcd->shift) % (2 * HOST_LCD_LINE_LENGTH)] : ' ';
+    }
+    uint8_t pos = (row >= 2 ? HOST_LCD_ROW2_POSITION : 0) + col;
+    uint8_t line = (row & 1) ? HOST_LCD_LINE2_ADDRESS : 0;
+    return lcd->ddram[line | ((pos + lcd->shift) % HOST_LCD_LINE_LENGTH)];
+}
+
+const uint8_t *host_lcd_get_glyph(uint16_t address, uint8_t slot)
+{
+    return &g_panels[address & (HOST_LCD_PANELS - 1)].cgram[(slot & 7) * 8];
+}
+
+bool host_lcd_get_display_on(uint16_t address)
+{
+    return g_panels[address & (HOST_LCD_PANELS - 1)].display_on;
+}
+
+host_lcd_stats_t host_lcd_get_stats(uint16_t address)
+{
+    return g_panels[address & (HOST_LCD_PANELS - 1)].stats;
+}
+
+void host_lcd_set_glyph_text(const uint8_t pattern[8], char text)
+{
+    if (g_glyph_text_count < HOST_LCD_GLYPH_TEXTS)
+    {
+        memcpy(g_glyph_texts[g_glyph_text_count].pattern, pattern, 8);
+        g_glyph_texts[g_glyph_text_count++].text = text;
+    }
+}
+
+/**
+ * @brief Gets the text form of a character code (ROM A00).
+ * @param address 7-bit I2C address, for the CGRAM characters.
+ * @param code character code.
+ * @return printable ASCII character.
+ */
+static char host_lcd_ascii(uint16_t address, uint8_t code)
+{
+    if (code < 0x10)
+    {
+        // CGRAM, both mappings
+        const uint8_t *glyph = host_lcd_get_glyph(address, code & 7);
+        for (int i = 0; i < g_glyph_text_count; i++)
+        {
+            if (memcmp(g_glyph_texts[i].pattern, glyph, 8) == 0)
+            {
+                return g_glyph_texts[i].text;
+            }
+        }
+        return (char)('0' + (code & 7));
+    }
+    switch (code)
+    {
+    case 0x7E:
+        return '>';                                 // Right arrow
+    case 0x7F:
+        return '<';                                 // Left arrow
+    case 0xDF:
+        return 'o';                                 // Degree sign
+    case 0xFF:
+        return '#';                                 // Full block
+    default:
+        return (code >= 0x20 && code < 0x7E) ? (char)code : '?';
+    }
+}
+
+void host_lcd_render(uint16_t address, uint8_t cols, uint8_t rows, char *out, size_t size)
+{
+    bool on = host_lcd_get_display_on(address);
+    size_t len = 0;
+
+    for (int row = -1; row <= rows; row++)
+    {
+        bool border = row < 0 || row == rows;
+        if (len + cols + 3 >= size)
+        {
+            break;
+        }
+        out[len++] = border ? '+' : '|';
+        for (uint8_t col = 0; col < cols; col++)
+        {
+            out[len++] = border ? '-' : on ? host_lcd_ascii(address, host_lcd_get_char(address, col, (uint8_t)row)) : ' ';
+        }
+        out[len++] = border ? '+' : '|';
+        out[len++] = '\n';
+    }
+    out[len] = '\0';
+}
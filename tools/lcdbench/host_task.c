@@ -0,0 +1,420 @@
+/**
+ * @file host_task.c
+ * @brief Task Scheduler for the LCD Benchmarks
+ * @details Implements the task creation, notification, semaphore, queue and
+ *          tick functions and esp_timer_get_time() on the clock of
+ *          host_i2c.c. The threads take turns under one mutex: the thread
+ *          whose task has the turn runs, every other one waits on the
+ *          condition variable until the turn comes back to it. A blocked
+ *          task records the object it waits for and its timeout; a give,
+ *          send or notification on the object makes it ready again.
+ *
+ * @author christophermena
+ * @date July 30, 2025
+ * @version 1.0
+ * @note Last Updated: October 16, 2026
+ */
+
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "esp_timer.h"
+#include "freertos/queue.h"
+#include "freertos/semphr.h"
+#include "freertos/task.h"
+
+#include "host_i2c.h"
+#include "host_task.h"
+
+/**
+ * @brief Task, or the caller of main()
+ */
+struct host_task
+{
+    TaskFunction_t code;                    ///< Task function, NULL for the caller of main()
+    void *parameters;                       ///< Its argument
+    pthread_t thread;                       ///< Thread it runs on
+    UBaseType_t priority;                   ///< Priority, the caller of main() has 0
+    uint32_t notified;                      ///< Notification count
+    bool blocked;                           ///< Waiting for an object or for time to pass
+    bool busy;                              ///< Blocked by a transfer on the bus
+    const void *object;                     ///< Object waited for, NULL for time only
+    uint64_t wake_us;                       ///< Clock at which the wait times out
+};
+
+/**
+ * @brief Counting semaphore (also the binary semaphore and the mutex)
+ */
+struct host_semaphore
+{
+    UBaseType_t max_count;                  ///< Highest count
+    UBaseType_t count;                      ///< Current count
+};
+
+/**
+ * @brief Queue of fixed-size items
+ */
+struct host_queue
+{
+    UBaseType_t length;                     ///< Items it holds
+    UBaseType_t item_size;                  ///< Bytes per item
+    UBaseType_t count;                      ///< Items queued
+    UBaseType_t head;                       ///< Index of the oldest item
+    uint8_t items[];                        ///< Ring of items
+};
+
+// The caller of main() first, then the tasks in order of creation
+static struct host_task g_tasks[HOST_TASK_MAX + 1];
+static int g_task_count = 1;
+
+// Turn taking: g_current has the turn
+static pthread_mutex_t g_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t g_turn_changed = PTHREAD_COND_INITIALIZER;
+static int g_current = 0;
+
+/**
+ * @brief Gives the turn to another task and waits until it comes back.
+ * @param next index of the task.
+ */
+static void host_task_switch(int next)
+{
+    int self = g_current;
+
+    pthread_mutex_lock(&g_lock);
+    g_current = next;
+    pthread_cond_broadcast(&g_turn_changed);
+    while (g_current != self)
+    {
+        pthread_cond_wait(&g_turn_changed, &g_lock);
+    }
+    pthread_mutex_unlock(&g_lock);
+}
+
+/**
+ * @brief Runs the highest-priority ready task, moving the clock to the next timeout while none is ready.
+ */
+static void host_task_schedule(void)
+{
+    for (;;)
+    {
+        int next = g_tasks[g_current].blocked ? -1 : g_current;
+        for (int i = 0; i < g_task_count; i++)
+        {
+            if (!g_tasks[i].blocked && (next < 0 || g_tasks[i].priority > g_tasks[next].priority))
+            {
+                next = i;
+            }
+        }
+        if (next >= 0)
+        {
+            if (next != g_current)
+            {
+                host_task_switch(next);
+            }
+            return;
+        }
+
+        uint64_t wake_us = UINT64_MAX;
+        for (int i = 0; i < g_task_count; i++)
+        {
+            wake_us = g_tasks[i].wake_us < wake_us ? g_tasks[i].wake_us : wake_us;
+        }
+        if (wake_us == UINT64_MAX)
+        {
+            fprintf(stderr, "host_task: every task waits without a timeout\n");
+            abort();
+        }
+        uint64_t now_us = host_i2c_get_time_us();
+        if (wake_us > now_us)
+        {
+            host_i2c_idle(wake_us - now_us);
+        }
+        for (int i = 0; i < g_task_count; i++)
+        {
+            if (g_tasks[i].wake_us <= wake_us)
+            {
+                g_tasks[i].blocked = false;         // Timed out
+            }
+        }
+    }
+}
+
+/**
+ * @brief Blocks the current task until an object is signalled or the clock reaches a time.
+ * @param wake_us timeout, UINT64_MAX for none.
+ * @param object object waited for, NULL to only let time pass.
+ * @param busy true while a transfer is on the bus.
+ */
+static void host_task_wait(uint64_t wake_us, const void *object, bool busy)
+{
+    struct host_task *self = &g_tasks[g_current];
+
+    self->blocked = true;
+    self->busy = busy;
+    self->object = object;
+    self->wake_us = wake_us;
+    host_task_schedule();
+    self->busy = false;
+}
+
+/**
+ * @brief Makes the tasks waiting for an object ready, switching to one that outranks the current task.
+ * @param object semaphore, queue or task that changed.
+ */
+static void host_task_signal(const void *object)
+{
+    bool preempt = false;
+
+    for (int i = 0; i < g_task_count; i++)
+    {
+        if (g_tasks[i].blocked && g_tasks[i].object == object)
+        {
+            g_tasks[i].blocked = false;
+            preempt |= g_tasks[i].priority > g_tasks[g_current].priority;
+        }
+    }
+    if (preempt)
+    {
+        host_task_schedule();
+    }
+}
+
+/**
+ * @brief Converts a FreeRTOS timeout into a clock time.
+ * @param ticks ticks to wait, portMAX_DELAY for no timeout.
+ * @return clock at which the wait times out.
+ */
+static uint64_t host_task_deadline(TickType_t ticks)
+{
+    return ticks == portMAX_DELAY ? UINT64_MAX : host_i2c_get_time_us() + (uint64_t)ticks * portTICK_PERIOD_MS * 1000;
+}
+
+/**
+ * @brief Thread of a task: waits for its first turn, then runs the task function.
+ * @param arg the task.
+ * @return never.
+ */
+static void *host_task_main(void *arg)
+{
+    struct host_task *task = arg;
+    int self = (int)(task - g_tasks);
+
+    pthread_mutex_lock(&g_lock);
+    while (g_current != self)
+    {
+        pthread_cond_wait(&g_turn_changed, &g_lock);
+    }
+    pthread_mutex_unlock(&g_lock);
+
+    task->code(task->parameters);
+    return NULL;
+}
+
+void host_task_run(uint32_t ms)
+{
+    host_task_wait(host_i2c_get_time_us() + (uint64_t)ms * 1000, NULL, false);
+
+    // A transfer still on the bus ends, then the arbiter starts the next queued one
+    for (;;)
+    {
+        uint64_t end_us = 0;
+        for (int i = 0; i < g_task_count; i++)
+        {
+            if (g_tasks[i].blocked && g_tasks[i].busy && g_tasks[i].wake_us > end_us)
+            {
+                end_us = g_tasks[i].wake_us;
+            }
+        }
+        if (end_us == 0)
+        {
+            return;
+        }
+        host_task_wait(end_us, NULL, false);
+    }
+}
+
+void host_task_sleep(uint64_t us)
+{
+    host_task_wait(host_i2c_get_time_us() + us, NULL, false);
+}
+
+void host_task_busy_until(uint64_t end_us)
+{
+    host_task_wait(end_us, NULL, true);
+}
+
+int64_t esp_timer_get_time(void)
+{
+    return (int64_t)host_i2c_get_time_us();
+}
+
+TickType_t xTaskGetTickCount(void)
+{
+    return (TickType_t)(host_i2c_get_time_us() / 1000 / portTICK_PERIOD_MS);
+}
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t task_code, const char *name, uint32_t stack_depth, void *parameters,
+                                   UBaseType_t priority, TaskHandle_t *created_task, BaseType_t core_id)
+{
+    if (g_task_count > HOST_TASK_MAX)
+    {
+        return pdFALSE;
+    }
+    struct host_task *task = &g_tasks[g_task_count];
+    memset(task, 0, sizeof(*task));
+    task->code = task_code;
+    task->parameters = parameters;
+    task->priority = priority;
+    if (pthread_create(&task->thread, NULL, host_task_main, task) != 0)
+    {
+        return pdFALSE;
+    }
+    g_task_count++;
+    if (created_task != NULL)
+    {
+        *created_task = task;
+    }
+    if (priority > g_tasks[g_current].priority)
+    {
+        host_task_schedule();                       // Runs until it first blocks
+    }
+    return pdTRUE;
+}
+
+BaseType_t xTaskNotifyGive(TaskHandle_t task)
+{
+    task->notified++;
+    host_task_signal(task);
+    return pdTRUE;
+}
+
+uint32_t ulTaskNotifyTake(BaseType_t clear_count_on_exit, TickType_t ticks_to_wait)
+{
+    struct host_task *self = &g_tasks[g_current];
+    uint64_t wake_us = host_task_deadline(ticks_to_wait);
+
+    while (self->notified == 0 && host_i2c_get_time_us() < wake_us)
+    {
+        host_task_wait(wake_us, self, false);
+    }
+
+    // Woken by a notification or by the timeout
+    uint32_t count = self->notified;
+    if (count > 0)
+    {
+        self->notified = clear_count_on_exit ? 0 : count - 1;
+    }
+    return count;
+}
+
+SemaphoreHandle_t xSemaphoreCreateCounting(UBaseType_t max_count, UBaseType_t initial_count)
+{
+    SemaphoreHandle_t semaphore = calloc(1, sizeof(struct host_semaphore));
+    semaphore->max_count = max_count;
+    semaphore->count = initial_count;
+    return semaphore;
+}
+
+SemaphoreHandle_t xSemaphoreCreateBinary(void)
+{
+    return xSemaphoreCreateCounting(1, 0);
+}
+
+SemaphoreHandle_t xSemaphoreCreateMutex(void)
+{
+    return xSemaphoreCreateCounting(1, 1);
+}
+
+BaseType_t xSemaphoreTake(SemaphoreHandle_t semaphore, TickType_t ticks_to_wait)
+{
+    uint64_t wake_us = host_task_deadline(ticks_to_wait);
+
+    while (semaphore->count == 0)
+    {
+        if (host_i2c_get_time_us() >= wake_us)
+        {
+            return pdFALSE;
+        }
+        host_task_wait(wake_us, semaphore, false);
+    }
+    semaphore->count--;
+    return pdTRUE;
+}
+
+BaseType_t xSemaphoreGive(SemaphoreHandle_t semaphore)
+{
+    if (semaphore->count == semaphore->max_count)
+    {
+        return pdFALSE;
+    }
+    semaphore->count++;
+    host_task_signal(semaphore);
+    return pdTRUE;
+}
+
+void vSemaphoreDelete(SemaphoreHandle_t semaphore)
+{
+    free(semaphore);
+}
+
+QueueHandle_t xQueueCreate(UBaseType_t length, UBaseType_t item_size)
+{
+    QueueHandle_t queue = calloc(1, sizeof(struct host_queue) + length * item_size);
+    queue->length = length;
+    queue->item_size = item_size;
+    return queue;
+}
+
+BaseType_t xQueueSend(QueueHandle_t queue, const void *item, TickType_t ticks_to_wait)
+{
+    uint64_t wake_us = host_task_deadline(ticks_to_wait);
+
+    while (queue->count == queue->length)
+    {
+        if (host_i2c_get_time_us() >= wake_us)
+        {
+            return pdFALSE;
+        }
+        host_task_wait(wake_us, queue, false);
+    }
+    memcpy(&queue->items[(queue->head + queue->count) % queue->length * queue->item_size], item, queue->item_size);
+    queue->count++;
+    host_task_signal(queue);
+    return pdTRUE;
+}
+
+BaseType_t xQueuePeek(QueueHandle_t queue, void *item, TickType_t ticks_to_wait)
+{
+    uint64_t wake_us = host_task_deadline(ticks_to_wait);
+
+    while (queue->count == 0)
+    {
+        if (host_i2c_get_time_us() >= wake_us)
+        {
+            return pdFALSE;
+        }
+        host_task_wait(wake_us, queue, false);
+    }
+    memcpy(item, &queue->items[queue->head * queue->item_size], queue->item_size);
+    return pdTRUE;
+}
+
+BaseType_t xQueueReceive(QueueHandle_t queue, void *item, TickType_t ticks_to_wait)
+{
+    if (xQueuePeek(queue, item, ticks_to_wait) != pdTRUE)
+    {
+        return pdFALSE;
+    }
+    queue->head = (queue->head + 1) % queue->length;
+    queue->count--;
+    host_task_signal(queue);
+    return pdTRUE;
+}
+
+void vQueueDelete(QueueHandle_t queue)
+{
+    free(queue);
+}
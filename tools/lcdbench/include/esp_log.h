@@ -0,0 +1,23 @@
+/**
+ * @file esp_log.h
+ * @brief ESP-IDF Logging Shim for the LCD Benchmark
+ * @details Errors and warnings go to stderr, informational messages are
+ *          dropped so they do not mix with the benchmark report.
+ *
+ * @author christophermena
+ * @date July 30, 2025
+ * @version 1.0
+ * @note Last Updated: October 16, 2026
+ */
+
+#ifndef HOST_ESP_LOG_H_
+#define HOST_ESP_LOG_H_
+
+#include <stdio.h>
+
+#define ESP_LOGE(tag, format, ...) fprintf(stderr, "E %s: " format "\n", tag, ##__VA_ARGS__)
+#define ESP_LOGW(tag, format, ...) fprintf(stderr, "W %s: " format "\n", tag, ##__VA_ARGS__)
+#define ESP_LOGI(tag, format, ...) do { (void)(tag); } while (0)
+#define ESP_LOGD(tag, format, ...) do { (void)(tag); } while (0)
+
+#endif /* HOST_ESP_LOG_H_ */
@@ -0,0 +1,43 @@
+/**
+ * @file esp_netif.h
+ * @brief Network Interface Shim for the LCD Benchmark
+ * @details Just the IPv4 address query the display service makes; the
+ *          station address is set by host_app_set_station().
+ *
+ * @author christophermena
+ * @date July 30, 2025
+ * @version 1.0
+ * @note Last Updated: October 16, 2026
+ */
+
+#ifndef HOST_ESP_NETIF_H_
+#define HOST_ESP_NETIF_H_
+
+#include <stdint.h>
+#include "esp_err.h"
+
+typedef struct esp_netif_obj esp_netif_t;
+
+typedef struct
+{
+    uint32_t addr;
+} esp_ip4_addr_t;
+
+typedef struct
+{
+    esp_ip4_addr_t ip;
+    esp_ip4_addr_t netmask;
+    esp_ip4_addr_t gw;
+} esp_netif_ip_info_t;
+
+#define esp_ip4_addr1_16(ipaddr)    ((uint16_t)(((ipaddr)->addr) & 0xff))
+#define esp_ip4_addr2_16(ipaddr)    ((uint16_t)(((ipaddr)->addr >> 8) & 0xff))
+#define esp_ip4_addr3_16(ipaddr)    ((uint16_t)(((ipaddr)->addr >> 16) & 0xff))
+#define esp_ip4_addr4_16(ipaddr)    ((uint16_t)(((ipaddr)->addr >> 24) & 0xff))
+
+#define IPSTR "%d.%d.%d.%d"
+#define IP2STR(ipaddr)  esp_ip4_addr1_16(ipaddr), esp_ip4_addr2_16(ipaddr), esp_ip4_addr3_16(ipaddr), esp_ip4_addr4_16(ipaddr)
+
+esp_err_t esp_netif_get_ip_info(esp_netif_t *esp_netif, esp_netif_ip_info_t *ip_info);
+
+#endif /* HOST_ESP_NETIF_H_ */
@@ -0,0 +1,20 @@
+/**
+ * @file esp_rom_sys.h
+ * @brief ROM Delay Shim for the LCD Benchmark
+ * @details Busy waits are not slept; host_i2c.c adds them to the modelled
+ *          bus time instead.
+ *
+ * @author christophermena
+ * @date July 30, 2025
+ * @version 1.0
+ * @note Last Updated: October 16, 2026
+ */
+
+#ifndef HOST_ESP_ROM_SYS_H_
+#define HOST_ESP_ROM_SYS_H_
+
+#include <stdint.h>
+
+void esp_rom_delay_us(uint32_t us);
+
+#endif /* HOST_ESP_ROM_SYS_H_ */
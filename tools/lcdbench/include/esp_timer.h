@@ -0,0 +1,19 @@
+/**
+ * @file esp_timer.h
+ * @brief High Resolution Timer Shim for the LCD Benchmark
+ * @details The time since boot is the clock of host_i2c.c.
+ *
+ * @author christophermena
+ * @date July 30, 2025
+ * @version 1.0
+ * @note Last Updated: October 16, 2026
+ */
+
+#ifndef HOST_ESP_TIMER_H_
+#define HOST_ESP_TIMER_H_
+
+#include <stdint.h>
+
+int64_t esp_timer_get_time(void);
+
+#endif /* HOST_ESP_TIMER_H_ */
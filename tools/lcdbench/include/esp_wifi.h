@@ -0,0 +1,32 @@
+/**
+ * @file esp_wifi.h
+ * @brief WiFi Shim for the LCD Benchmark
+ * @details Just the link queries the display service makes; the answers are
+ *          set by host_app_set_station() and host_app_set_ap_clients().
+ *
+ * @author christophermena
+ * @date July 30, 2025
+ * @version 1.0
+ * @note Last Updated: October 16, 2026
+ */
+
+#ifndef HOST_ESP_WIFI_H_
+#define HOST_ESP_WIFI_H_
+
+#include <stdint.h>
+#include "esp_err.h"
+
+typedef struct
+{
+    int8_t rssi;
+} wifi_ap_record_t;
+
+typedef struct
+{
+    int num;
+} wifi_sta_list_t;
+
+esp_err_t esp_wifi_sta_get_ap_info(wifi_ap_record_t *ap_info);
+esp_err_t esp_wifi_ap_get_sta_list(wifi_sta_list_t *sta);
+
+#endif /* HOST_ESP_WIFI_H_ */
@@ -0,0 +1,42 @@
+/**
+ * @file FreeRTOS.h
+ * @brief FreeRTOS Shim for the LCD Benchmark
+ * @details Tick type and conversion with a 1 ms tick, as configured on the
+ *          station. Critical sections do nothing: host_task.c never runs
+ *          two tasks at once.
+ *
+ * @author christophermena
+ * @date July 30, 2025
+ * @version 1.0
+ * @note Last Updated: October 16, 2026
+ */
+
+#ifndef HOST_FREERTOS_H_
+#define HOST_FREERTOS_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+typedef uint32_t TickType_t;
+typedef int BaseType_t;
+typedef unsigned int UBaseType_t;
+
+#define pdFALSE                 0
+#define pdTRUE                  1
+
+#define portTICK_PERIOD_MS      1
+#define pdMS_TO_TICKS(ms)       ((TickType_t)(ms))
+#define portMAX_DELAY           ((TickType_t)0xFFFFFFFF)
+
+// One task runs at a time, critical sections need no lock
+typedef struct
+{
+    int owner;
+} portMUX_TYPE;
+
+#define portMUX_INITIALIZER_UNLOCKED    { 0 }
+#define portENTER_CRITICAL(mux)         do { (void)(mux); } while (0)
+#define portEXIT_CRITICAL(mux)          do { (void)(mux); } while (0)
+
+#endif /* HOST_FREERTOS_H_ */
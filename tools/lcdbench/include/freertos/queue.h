@@ -0,0 +1,27 @@
+/**
+ * @file queue.h
+ * @brief FreeRTOS Queue Shim for the LCD Benchmark
+ * @details Queues of fixed-size items copied in and out, as in FreeRTOS. A
+ *          send to a full queue or a receive from an empty one blocks the
+ *          calling task on the scheduler of host_task.c.
+ *
+ * @author christophermena
+ * @date July 30, 2025
+ * @version 1.0
+ * @note Last Updated: October 16, 2026
+ */
+
+#ifndef HOST_FREERTOS_QUEUE_H_
+#define HOST_FREERTOS_QUEUE_H_
+
+#include "freertos/FreeRTOS.h"
+
+typedef struct host_queue *QueueHandle_t;
+
+QueueHandle_t xQueueCreate(UBaseType_t length, UBaseType_t item_size);
+BaseType_t xQueueSend(QueueHandle_t queue, const void *item, TickType_t ticks_to_wait);
+BaseType_t xQueuePeek(QueueHandle_t queue, void *item, TickType_t ticks_to_wait);
+BaseType_t xQueueReceive(QueueHandle_t queue, void *item, TickType_t ticks_to_wait);
+void vQueueDelete(QueueHandle_t queue);
+
+#endif /* HOST_FREERTOS_QUEUE_H_ */
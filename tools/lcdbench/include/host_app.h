@@ -0,0 +1,52 @@
+/**
+ * @file host_app.h
+ * @brief Station Services for the Page Benchmark
+ * @details Stand-ins for the services the display service reads besides the
+ *          LCD: the WiFi link, the unit setting, the sensor error count and
+ *          whether the clock is set.
+ *          The benchmark sets their answers before it lets time pass.
+ *
+ * @author christophermena
+ * @date July 30, 2025
+ * @version 1.0
+ * @note Last Updated: October 16, 2026
+ */
+
+#ifndef HOST_APP_H_
+#define HOST_APP_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/**
+ * @brief Set the station link
+ * @param ip IPv4 address as a, b, c, d packed a first (esp_ip4_addr_t order), 0 if not connected
+ * @param rssi Signal strength of the access point in dBm
+ */
+void host_app_set_station(uint32_t ip, int8_t rssi);
+
+/**
+ * @brief Set the number of clients of the station's own access point
+ * @param count Connected clients
+ */
+void host_app_set_ap_clients(int count);
+
+/**
+ * @brief Set the temperature unit setting
+ * @param fahrenheit true for Fahrenheit
+ */
+void host_app_set_fahrenheit(bool fahrenheit);
+
+/**
+ * @brief Set the sensor error count
+ * @param count Failed sensor reads since boot
+ */
+void host_app_set_errors(uint32_t count);
+
+/**
+ * @brief Set whether SNTP has set the clock
+ * @param valid true once the clock holds the wall time
+ */
+void host_app_set_clock_valid(bool valid);
+
+#endif /* HOST_APP_H_ */
@@ -0,0 +1,81 @@
+/**
+ * @file host_i2c.h
+ * @brief Recording I2C Bus for the LCD Benchmark
+ * @details Every I2C write the driver makes is counted instead of sent: the
+ *          number of transactions, the bytes on the wire (address byte
+ *          included) and the time they would take on the station's 100kHz
+ *          bus, plus the delays the driver waits out. The enable strobes in
+ *          the written PCF8574 states give the number of nibbles the LCD
+ *          latched. The states drive the HD44780 model of host_lcd.h, which
+ *          answers reads of the expander with its busy flag or, to model a
+ *          backpack with R/W tied to ground, with the data pins as last
+ *          written (busy forever). A clock runs on the bus time and the
+ *          delays, so the model sees the driver's real timing. Writes to a
+ *          device can be refused to test the driver's error recovery.
+ *
+ * @author christophermena
+ * @date July 30, 2025
+ * @version 1.0
+ * @note Last Updated: October 16, 2026
+ */
+
+#ifndef HOST_I2C_H_
+#define HOST_I2C_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Bus timing model
+#define HOST_I2C_FREQ_HZ            100000      ///< SCL frequency (LCD_I2C_MASTER_FREQ_HZ)
+#define HOST_I2C_START_STOP_BITS    2           ///< START and STOP conditions of a transaction, in bit times
+
+/**
+ * @brief Bus traffic since the last host_i2c_reset()
+ */
+typedef struct host_i2c_stats
+{
+    uint32_t transactions;      ///< I2C transactions (START to STOP)
+    uint32_t bytes;             ///< Bytes on the wire, address bytes included
+    uint32_t strobes;           ///< Nibbles latched by the LCD (falling edges of EN)
+    uint32_t reads;             ///< Transactions that read the expander (busy flag polls)
+    uint64_t bus_us;            ///< Time the bus was busy
+    uint64_t delay_us;          ///< Time the driver spent in delays
+} host_i2c_stats_t;
+
+/**
+ * @brief Clear the counters
+ */
+void host_i2c_reset(void);
+
+/**
+ * @brief Refuse the next writes to a device, as a NACK of its address byte
+ * @param address 7-bit I2C address
+ * @param count Writes to refuse
+ */
+void host_i2c_fail_writes(uint16_t address, uint32_t count);
+
+/**
+ * @brief Choose how the expander answers reads
+ * @param enable true: the LCD drives the busy flag, false: R/W is tied to ground
+ */
+void host_i2c_set_readback(bool enable);
+
+/**
+ * @brief Read the counters
+ * @return Bus traffic since the last reset
+ */
+host_i2c_stats_t host_i2c_get_stats(void);
+
+/**
+ * @brief Read the clock
+ * @return Bus time, delays and idle time since start, in microseconds
+ */
+uint64_t host_i2c_get_time_us(void);
+
+/**
+ * @brief Let time pass without bus traffic (not counted as a driver delay)
+ * @param us Microseconds
+ */
+void host_i2c_idle(uint64_t us);
+
+#endif /* HOST_I2C_H_ */
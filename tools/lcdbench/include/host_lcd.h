@@ -0,0 +1,148 @@
+/**
+ * @file host_lcd.h
+ * @brief HD44780 Emulator for the LCD Benchmark
+ * @details Models the panels behind the PCF8574 backpacks on the recording
+ *          bus. Every expander state written to an address is decoded the
+ *          way the controller sees it: RS, R/W and the data pins are taken
+ *          on the rising edge of EN and latched on the falling edge, two
+ *          nibbles per byte once the controller is in 4-bit mode. The model
+ *          keeps the DDRAM (two 40 character lines, or one of 80), the CGRAM,
+ *          the address counter, the entry mode and the display shift, and
+ *          answers busy flag and data reads. Each instruction keeps the
+ *          controller busy for its datasheet execution time (1.52ms for
+ *          clear and home, 37μs otherwise, 4.1ms and 100μs for the first two
+ *          8-bit function sets after power-on, 40ms after power-on), measured
+ *          on the bus clock of host_i2c.c.
+ *
+ *          Broken timing rules are counted rather than enforced: a write
+ *          latched while the controller is busy, RS or R/W changing in the
+ *          expander state that raises EN or while EN is high (they must
+ *          settle first), and a byte whose two nibbles disagree on RS or R/W
+ *          (the nibbles are out of step). The write is still executed, so a
+ *          broken rule usually shows as a wrong screen as well.
+ *
+ * @author christophermena
+ * @date July 30, 2025
+ * @version 1.0
+ * @note Last Updated: October 16, 2026
+ */
+
+#ifndef HOST_LCD_H_
+#define HOST_LCD_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Emulator Configuration
+#define HOST_LCD_PANELS             8           ///< Panels modelled, one per value of the address bits A0-A2
+#define HOST_LCD_DDRAM_SIZE         0x80        ///< DDRAM address space (7-bit address counter)
+#define HOST_LCD_CGRAM_SIZE         0x40        ///< CGRAM bytes, 8 characters of 8 rows
+#define HOST_LCD_GLYPH_TEXTS        32          ///< CGRAM patterns with a text form
+
+// Execution Times in microseconds (HD44780U datasheet, 270kHz oscillator)
+#define HOST_LCD_POWER_ON_US        40000       ///< Vcc rise to the first instruction
+#define HOST_LCD_INIT_FIRST_US      4100        ///< First 8-bit function set after power-on
+#define HOST_LCD_INIT_SECOND_US     100         ///< Second 8-bit function set after power-on
+#define HOST_LCD_CLEAR_US           1520        ///< Clear display and return home
+#define HOST_LCD_COMMAND_US         37          ///< Other instructions
+#define HOST_LCD_DATA_US            41          ///< Data write or read (37μs plus 4μs address update)
+
+/**
+ * @brief Decoding counters and rule violations of one panel since power-on
+ */
+typedef struct host_lcd_stats
+{
+    uint32_t instructions;      ///< Instructions executed (RS low)
+    uint32_t data_writes;       ///< Characters or CGRAM rows written (RS high)
+    uint32_t reads;             ///< Bytes read (busy flag or data)
+    uint32_t busy_writes;       ///< Writes latched while the controller was busy
+    uint32_t setup_errors;      ///< RS or R/W changed with EN rising or high
+    uint32_t sync_errors;       ///< Nibble pairs that disagree on RS or R/W
+} host_lcd_stats_t;
+
+/**
+ * @brief Power up the panel at an address, if it is not powered yet
+ * @param address 7-bit I2C address of the backpack
+ * @param now_ns Bus clock
+ */
+void host_lcd_power_on(uint16_t address, uint64_t now_ns);
+
+/**
+ * @brief Apply an expander state written to a backpack
+ * @param address 7-bit I2C address of the backpack
+ * @param state PCF8574 output state (RS, R/W, EN, backlight, D4-D7)
+ * @param now_ns Bus clock when the state appears on the pins
+ */
+void host_lcd_write(uint16_t address, uint8_t state, uint64_t now_ns);
+
+/**
+ * @brief Read the expander inputs of a backpack
+ * @param address 7-bit I2C address of the backpack
+ * @param outputs PCF8574 output state
+ * @param now_ns Bus clock when the inputs are sampled
+ * @return Output state, with the data pins the controller drives low cleared
+ */
+uint8_t host_lcd_read(uint16_t address, uint8_t outputs, uint64_t now_ns);
+
+/**
+ * @brief Choose whether R/W reaches the controllers
+ * @param wired true: R/W is wired to the expander, false: tied to ground (reads return the pins as written)
+ */
+void host_lcd_set_rw_wired(bool wired);
+
+/**
+ * @brief Get the character code shown in a cell (display shift applied)
+ * @param address 7-bit I2C address of the backpack
+ * @param col Column
+ * @param row Row, 0 to 3 (rows 2 and 3 continue the two DDRAM lines)
+ * @return Character code, 0x00-0x0F for the CGRAM characters
+ */
+uint8_t host_lcd_get_char(uint16_t address, uint8_t col, uint8_t row);
+
+/**
+ * @brief Get the pattern of a CGRAM character
+ * @param address 7-bit I2C address of the backpack
+ * @param slot CGRAM character, 0 to 7
+ * @return 8 rows of 5 pixels, bit 4 leftmost
+ */
+const uint8_t *host_lcd_get_glyph(uint16_t address, uint8_t slot);
+
+/**
+ * @brief Report whether the display is on
+ * @param address 7-bit I2C address of the backpack
+ * @return true if the display on/off control has D set
+ */
+bool host_lcd_get_display_on(uint16_t address);
+
+/**
+ * @brief Get the decoding counters of a panel
+ * @param address 7-bit I2C address of the backpack
+ * @return Counters since power-on
+ */
+host_lcd_stats_t host_lcd_get_stats(uint16_t address);
+
+/**
+ * @brief Give a CGRAM pattern a text form for host_lcd_render()
+ * @param pattern 8 rows of 5 pixels, bit 4 leftmost
+ * @param text Character printed for a cell showing a CGRAM character with this pattern
+ */
+void host_lcd_set_glyph_text(const uint8_t pattern[8], char text);
+
+/**
+ * @brief Render the screen of a panel as text
+ *
+ * One line per row, framed. ROM characters print as ASCII (the full block
+ * as '#', the degree sign as 'o'), CGRAM characters as the text form of
+ * their pattern or, without one, as the slot number. A display that is off
+ * shows blank.
+ *
+ * @param address 7-bit I2C address of the backpack
+ * @param cols Columns of the panel
+ * @param rows Rows of the panel
+ * @param out Receives the text
+ * @param size Size of out, (cols + 3) * (rows + 2) + 1 is enough
+ */
+void host_lcd_render(uint16_t address, uint8_t cols, uint8_t rows, char *out, size_t size);
+
+#endif /* HOST_LCD_H_ */
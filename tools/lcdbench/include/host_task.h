@@ -0,0 +1,52 @@
+/**
+ * @file host_task.h
+ * @brief Task Scheduler for the LCD Benchmarks
+ * @details Tasks created with xTaskCreatePinnedToCore() get a thread each,
+ *          but only one thread runs at a time, as on one core: the
+ *          highest-priority task that is not blocked, with the caller of
+ *          main() as the lowest-priority task (0). A task blocks in the
+ *          notification, semaphore and queue calls and in vTaskDelay(); a
+ *          give, a send or a notification that unblocks a task of higher
+ *          priority switches to it at once. When every task is blocked the
+ *          clock of host_i2c.c jumps to the earliest timeout. A bus transfer
+ *          blocks the arbiter task for its bit time, so other tasks run and
+ *          queue transactions while it is on the wire. Runs are deterministic
+ *          and as fast as the host allows.
+ *
+ * @author christophermena
+ * @date July 30, 2025
+ * @version 1.0
+ * @note Last Updated: October 16, 2026
+ */
+
+#ifndef HOST_TASK_H_
+#define HOST_TASK_H_
+
+#include <stdint.h>
+
+// Scheduler Configuration
+#define HOST_TASK_MAX               4           ///< Tasks besides the caller of main()
+
+/**
+ * @brief Let time pass with the tasks running (caller of main() only)
+ *
+ * Returns once the given time has passed and no transfer is left on the
+ * bus, nor queued behind one.
+ *
+ * @param ms Simulated milliseconds, 0 to only let the tasks finish what is pending
+ */
+void host_task_run(uint32_t ms);
+
+/**
+ * @brief Block the calling task for a while, letting the others run
+ * @param us Microseconds
+ */
+void host_task_sleep(uint64_t us);
+
+/**
+ * @brief Block the calling task until a transfer ends, letting the others run
+ * @param end_us Clock at the end of the transfer
+ */
+void host_task_busy_until(uint64_t end_us);
+
+#endif /* HOST_TASK_H_ */
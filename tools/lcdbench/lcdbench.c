@@ -0,0 +1,446 @@
+/**
+ * @file lcdbench.c
+ * @brief LCD Driver Bus Benchmark
+ * @details Runs typical screen updates through src/LiquidCrystal_I2C.c on the
+ *          recording bus of host_i2c.c and reports, per update, the I2C
+ *          transactions and bytes sent, the modelled bus time at 100kHz and
+ *          the time spent in driver delays. For comparison it also lists what
+ *          the per-nibble driver would have sent for the same LCD traffic:
+ *          three single-byte transactions (data, EN high, EN low) per nibble.
+ *          The sparkline updates show what the CGRAM glyph cache saves: the
+ *          bars are uploaded once and later frames only rewrite cells. The
+ *          two-panel updates flush a 20x4 and a 16x2 panel with one
+ *          lcd_flush_all(), one write per panel and row run; after a write
+ *          the panel refused, the next flush must resend the whole panel. The
+ *          commands are run twice, polling the busy flag and, with R/W tied
+ *          to ground, on the fixed delays the driver falls back to. A sensor
+ *          task then reads a device on the same bus while both panels are
+ *          redrawn, once at sensor and once at display priority, and the
+ *          time its reads waited for the bus is reported: at sensor priority
+ *          no read may wait longer than one full LCD write.
+ *
+ *          Every update is also checked on the HD44780 model of host_lcd.c:
+ *          each panel must show exactly its framebuffer, every sparkline bar
+ *          must be backed by a CGRAM pattern of its height, and no timing
+ *          rule may be broken. The final screens are printed as text. The
+ *          exit status is 1 if a check failed.
+ *
+ * @author christophermena
+ * @date July 30, 2025
+ * @version 1.0
+ * @note Last Updated: October 16, 2026
+ */
+
+#include <stdio.h>
+
+#include "LiquidCrystal_I2C.h"
+#include "freertos/task.h"
+#include "host_i2c.h"
+#include "host_lcd.h"
+#include "host_task.h"
+#include "lcd_glyph.h"
+#include "tasks_common.h"
+
+// Each nibble of the per-nibble driver was three transactions of address plus one byte
+#define LEGACY_TRANSACTIONS_PER_NIBBLE  3
+#define LEGACY_BYTES_PER_TRANSACTION    2
+
+// Address of the 20x4 panel in the two-panel updates
+#define FRONT_I2C_ADDRESS               0x26
+
+// SHT3x-style sensor read during a redraw: status register command, then 3 bytes after a repeated START
+#define SENSOR_I2C_ADDRESS              0x44
+#define SENSOR_READS                    8
+#define SENSOR_READ_INTERVAL_MS         4
+
+// Longest a read may wait at sensor priority: one full LCD write on the bus
+#define SENSOR_WAIT_LIMIT_US            (((1 + LCD_TX_BUFFER_SIZE) * 9 + HOST_I2C_START_STOP_BITS) * 1000000ULL / HOST_I2C_FREQ_HZ)
+
+// 16x2 panel of the single-panel updates, 20x4 front panel of the two-panel updates
+static lcd_t g_lcd;
+static lcd_t g_front;
+
+// Sensor on the bus and the task reading it
+static i2c_bus_dev_handle_t g_sensor;
+static TaskHandle_t g_sensor_task;
+
+// Checks failed on the emulated panels
+static int g_failures;
+
+/**
+ * @brief Draws the two reading lines of main.c into the framebuffer.
+ * @param temperature temperature in Fahrenheit.
+ * @param humidity relative humidity in percent.
+ */
+static void draw_reading(int temperature, int humidity)
+{
+    lcd_clear_frame(&g_lcd);
+    lcd_set_cursor(&g_lcd, 0, 0);
+    lcd_print(&g_lcd, "Temp: ");
+    lcd_print_int(&g_lcd, temperature);
+    lcd_print(&g_lcd, "F");
+    lcd_set_cursor(&g_lcd, 0, 1);
+    lcd_print(&g_lcd, "Humidity: ");
+    lcd_print_int(&g_lcd, humidity);
+    lcd_print(&g_lcd, "%");
+}
+
+/**
+ * @brief Draws the front panel: the reading lines and two status lines, full width.
+ * @param temperature temperature in Fahrenheit.
+ * @param humidity relative humidity in percent.
+ */
+static void draw_front(int temperature, int humidity)
+{
+    lcd_clear_frame(&g_front);
+    lcd_set_cursor(&g_front, 0, 0);
+    lcd_print(&g_front, "Temperature: ");
+    lcd_print_int(&g_front, temperature);
+    lcd_print(&g_front, "F");
+    lcd_set_cursor(&g_front, 0, 1);
+    lcd_print(&g_front, "Humidity:    ");
+    lcd_print_int(&g_front, humidity);
+    lcd_print(&g_front, "%");
+    lcd_set_cursor(&g_front, 0, 2);
+    lcd_print(&g_front, "WiFi 192.168.1.42");
+    lcd_set_cursor(&g_front, 0, 3);
+    lcd_print(&g_front, "Uptime 0d 01:23");
+}
+
+/**
+ * @brief Draws a 16 column sparkline of a rising and falling series into the framebuffer.
+ * @param shift first value of the series.
+ */
+static void draw_sparkline(int shift)
+{
+    lcd_clear_frame(&g_lcd);
+    lcd_glyph_begin_frame(&g_lcd);
+    lcd_set_cursor(&g_lcd, 0, 1);
+    for (int i = 0; i < 16; i++)
+    {
+        int level = 1 + (i + shift) % 14;
+        lcd_print_char(&g_lcd, lcd_glyph_bar(&g_lcd, level <= 8 ? level : 16 - level));
+    }
+}
+
+/**
+ * @brief Checks that the sparkline row is drawn with bars of the right heights.
+ * @param name scenario name.
+ * @param shift first value of the series.
+ */
+static void check_sparkline(const char *name, int shift)
+{
+    for (int i = 0; i < 16; i++)
+    {
+        int level = 1 + (i + shift) % 14;
+        level = level <= 8 ? level : 16 - level;
+        uint8_t code = host_lcd_get_char(g_lcd.addr, (uint8_t)i, 1);
+        int lit = -1;                               // Height of the bar shown, -1 if not a bar
+
+        if (code == 0xFF)
+        {
+            lit = 8;
+        }
+        else if (code < 0x10)
+        {
+            // Rows are either blank or full, full rows at the bottom
+            const uint8_t *glyph = host_lcd_get_glyph(g_lcd.addr, code & 7);
+            lit = 0;
+            for (int row = 0; row < 8 && lit >= 0; row++)
+            {
+                if (glyph[row] == 0x1F)
+                {
+                    lit++;
+                }
+                else if (glyph[row] != 0x00 || lit > 0)
+                {
+                    lit = -1;
+                }
+            }
+        }
+        if (lit != level)
+        {
+            fprintf(stderr, "FAIL %s: column %d shows a bar of %d rows, expected %d\n", name, i, lit, level);
+            g_failures++;
+        }
+    }
+}
+
+/**
+ * @brief Checks that the emulated panel shows the framebuffer and that no timing rule was broken.
+ * @param name scenario name.
+ * @param lcd panel.
+ */
+static void check_panel(const char *name, const lcd_t *lcd)
+{
+    for (uint8_t row = 0; row < lcd->rows; row++)
+    {
+        for (uint8_t col = 0; col < lcd->cols; col++)
+        {
+            uint8_t want = (uint8_t)lcd->frame[row][col];
+            uint8_t code = host_lcd_get_char(lcd->addr, col, row);
+            bool match = want < 0x10 ? (code < 0x10 && (code & 7) == (want & 7)) : code == want;  // Both mappings of a CGRAM slot
+            if (!match)
+            {
+                fprintf(stderr, "FAIL %s: 0x%02X row %d col %d shows 0x%02X, framebuffer 0x%02X\n", name, lcd->addr, row, col, code, want);
+                g_failures++;
+                return;
+            }
+        }
+    }
+
+    host_lcd_stats_t stats = host_lcd_get_stats(lcd->addr);
+    if (!host_lcd_get_display_on(lcd->addr) || stats.busy_writes || stats.setup_errors || stats.sync_errors)
+    {
+        fprintf(stderr, "FAIL %s: 0x%02X display %s, %u writes while busy, %u setup errors, %u sync errors\n", name, lcd->addr,
+                host_lcd_get_display_on(lcd->addr) ? "on" : "off", stats.busy_writes, stats.setup_errors, stats.sync_errors);
+        g_failures++;
+    }
+}
+
+/**
+ * @brief Prints the screen of an emulated panel.
+ * @param lcd panel.
+ */
+static void print_screen(const lcd_t *lcd)
+{
+    char screen[(LCD_MAX_COLS + 3) * (LCD_MAX_ROWS + 2) + 1];
+
+    host_lcd_render(lcd->addr, lcd->cols, lcd->rows, screen, sizeof(screen));
+    host_lcd_stats_t stats = host_lcd_get_stats(lcd->addr);
+    printf("\n0x%02X: %u instructions, %u data writes, %u reads\n%s", lcd->addr, stats.instructions, stats.data_writes, stats.reads, screen);
+}
+
+/**
+ * @brief Prints the traffic recorded since the last reset as one table row and checks the panels.
+ * @param name scenario name.
+ */
+static void report(const char *name)
+{
+    host_task_run(0);                               // Writes still queued reach the panels
+    host_i2c_stats_t stats = host_i2c_get_stats();
+    printf("%-28s %6u %6u %6u %9.2f %9.2f %6u %6u\n", name, stats.transactions, stats.reads, stats.bytes,
+           stats.bus_us / 1000.0, stats.delay_us / 1000.0,
+           stats.strobes * LEGACY_TRANSACTIONS_PER_NIBBLE,
+           stats.strobes * LEGACY_TRANSACTIONS_PER_NIBBLE * LEGACY_BYTES_PER_TRANSACTION);
+
+    check_panel(name, &g_lcd);
+    if (g_front.dev != NULL)
+    {
+        check_panel(name, &g_front);
+    }
+}
+
+/**
+ * @brief Prints one string on a blank panel and reports the traffic.
+ * @param name scenario name.
+ * @param text string to print.
+ */
+static void bench_print(const char *name, const char *text)
+{
+    lcd_clear(&g_lcd);
+    host_i2c_reset();
+    lcd_set_cursor(&g_lcd, 0, 0);
+    lcd_print(&g_lcd, text);
+    lcd_flush(&g_lcd);
+    report(name);
+}
+
+/**
+ * @brief Runs the panel commands and reports the traffic of each.
+ * @param suffix scenario name suffix.
+ */
+static void bench_commands(const char *suffix)
+{
+    char name[40];
+
+    host_i2c_reset();
+    lcd_clear(&g_lcd);
+    snprintf(name, sizeof(name), "lcd_clear%s", suffix);
+    report(name);
+
+    host_i2c_reset();
+    display(&g_lcd);
+    snprintf(name, sizeof(name), "display on%s", suffix);
+    report(name);
+}
+
+/**
+ * @brief Sensor task: on each notification, reads the sensor SENSOR_READS times, SENSOR_READ_INTERVAL_MS apart.
+ * @param arg unused.
+ */
+static void sensor_task(void *arg)
+{
+    static const uint8_t command[2] = { 0xF3, 0x2D };
+    uint8_t status[3];
+
+    for (;;)
+    {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        for (int i = 0; i < SENSOR_READS; i++)
+        {
+            vTaskDelay(pdMS_TO_TICKS(SENSOR_READ_INTERVAL_MS));
+            i2c_bus_transfer(g_sensor, command, sizeof(command), status, sizeof(status));
+        }
+    }
+}
+
+/**
+ * @brief Redraws both panels while the sensor task reads, and reports how long the reads waited for the bus.
+ * @param name scenario name.
+ * @param priority transaction priority of the sensor.
+ */
+static void bench_sensor(const char *name, i2c_bus_priority_e priority)
+{
+    lcd_t *const panels[] = { &g_front, &g_lcd };
+    i2c_bus_stats_t stats = { 0 };
+
+    if (i2c_bus_add_device(SENSOR_I2C_ADDRESS, LCD_I2C_MASTER_FREQ_HZ, priority, &g_sensor) != ESP_OK)
+    {
+        g_failures++;
+        return;
+    }
+
+    lcd_clear(&g_front);
+    lcd_clear(&g_lcd);
+    draw_front(74, 46);
+    draw_reading(74, 46);
+    xTaskNotifyGive(g_sensor_task);
+    lcd_flush_all(panels, 2);
+    host_task_run(2 * SENSOR_READS * SENSOR_READ_INTERVAL_MS);
+
+    for (int i = 0; i < I2C_BUS_MAX_DEVICES; i++)
+    {
+        if (i2c_bus_get_stats(i, &stats) && stats.address == SENSOR_I2C_ADDRESS)
+        {
+            break;
+        }
+    }
+    printf("%-28s %6lu %9.2f %9.2f\n", name, (unsigned long)stats.transactions,
+           stats.transactions ? stats.wait_us / 1000.0 / stats.transactions : 0.0, stats.wait_max_us / 1000.0);
+    if (stats.transactions != SENSOR_READS || (priority == I2C_BUS_PRIORITY_SENSOR && stats.wait_max_us > SENSOR_WAIT_LIMIT_US))
+    {
+        fprintf(stderr, "FAIL %s: %lu reads, longest wait %lu us (limit %llu us)\n", name,
+                (unsigned long)stats.transactions, (unsigned long)stats.wait_max_us, SENSOR_WAIT_LIMIT_US);
+        g_failures++;
+    }
+    check_panel(name, &g_front);
+    check_panel(name, &g_lcd);
+    i2c_bus_rm_device(g_sensor);
+}
+
+int main(void)
+{
+    if (liquid_crystal_i2c_init(&g_lcd, LCD_I2C_ADDRESS, 16, 2) != ESP_OK || !lcd_get_busy_polling(&g_lcd))
+    {
+        return 1;
+    }
+
+    printf("%-28s %6s %6s %6s %9s %9s %6s %6s\n", "", "", "", "", "bus", "delays", "legacy", "legacy");
+    printf("%-28s %6s %6s %6s %9s %9s %6s %6s\n", "update", "trans", "reads", "bytes", "ms", "ms", "trans", "bytes");
+
+    bench_commands(", busy flag");
+
+    bench_print("lcd_print 1 char", "A");
+    bench_print("lcd_print 6 chars", "Temp: ");
+    bench_print("lcd_print 16 chars", "Weather Station!");
+
+    lcd_clear(&g_lcd);
+    host_i2c_reset();
+    draw_reading(72, 45);
+    lcd_flush(&g_lcd);
+    report("reading, blank panel");
+
+    host_i2c_reset();
+    draw_reading(73, 45);
+    lcd_flush(&g_lcd);
+    report("reading, 1 digit changed");
+
+    host_i2c_reset();
+    draw_reading(73, 45);
+    lcd_flush(&g_lcd);
+    report("reading, unchanged");
+
+    host_i2c_reset();
+    lcd_clear_frame(&g_lcd);
+    lcd_set_cursor(&g_lcd, 0, 0);
+    lcd_print(&g_lcd, "Sensor Error!");
+    lcd_set_cursor(&g_lcd, 0, 1);
+    lcd_print(&g_lcd, "Check DHT11");
+    lcd_flush(&g_lcd);
+    report("reading to error screen");
+
+    host_i2c_reset();
+    lcd_clear(&g_lcd);
+    draw_reading(73, 45);
+    lcd_flush(&g_lcd);
+    report("clear + full redraw");
+
+    lcd_clear(&g_lcd);
+    host_i2c_reset();
+    draw_sparkline(0);
+    lcd_flush(&g_lcd);
+    report("sparkline, first frame");
+    check_sparkline("sparkline, first frame", 0);
+
+    host_i2c_reset();
+    draw_sparkline(1);
+    lcd_flush(&g_lcd);
+    report("sparkline, shifted by one");
+    check_sparkline("sparkline, shifted by one", 1);
+
+    // Without readback the first command gives up on the flag, later ones use the delays
+    host_i2c_set_readback(false);
+    if (liquid_crystal_i2c_init(&g_lcd, LCD_I2C_ADDRESS, 16, 2) != ESP_OK || lcd_get_busy_polling(&g_lcd))
+    {
+        return 1;
+    }
+    bench_commands(", fixed delays");
+
+    // Front 20x4 and back 16x2, both flushed at once
+    host_i2c_set_readback(true);
+    if (liquid_crystal_i2c_init(&g_front, FRONT_I2C_ADDRESS, 20, 4) != ESP_OK)
+    {
+        return 1;
+    }
+    lcd_t *const panels[] = { &g_front, &g_lcd };
+
+    host_i2c_reset();
+    draw_front(72, 45);
+    draw_reading(72, 45);
+    lcd_flush_all(panels, 2);
+    report("two panels, blank");
+
+    host_i2c_reset();
+    draw_front(73, 45);
+    draw_reading(73, 45);
+    lcd_flush_all(panels, 2);
+    report("two panels, 1 digit changed");
+
+    // A write refused by the panel leaves it wrong until the next flush resends every cell
+    host_i2c_fail_writes(LCD_I2C_ADDRESS, 1);
+    draw_front(74, 45);
+    draw_reading(74, 45);
+    lcd_flush_all(panels, 2);
+    host_task_run(0);
+    if (!lcd_get_redraw_pending(&g_lcd) || lcd_get_redraw_pending(&g_front))
+    {
+        fprintf(stderr, "FAIL failed write: redraw not requested for the back panel only\n");
+        g_failures++;
+    }
+    host_i2c_reset();
+    lcd_flush_all(panels, 2);
+    report("redraw after a failed write");
+
+    // Sensor reads while both panels are redrawn
+    xTaskCreatePinnedToCore(&sensor_task, "sensor_task", DHT_SENSOR_TASK_STACK_SIZE, NULL, DHT_SENSOR_TASK_PRIORITY, &g_sensor_task, DHT_SENSOR_TASK_CORE_ID);
+    printf("\n%-28s %6s %9s %9s\n", "", "", "wait avg", "wait max");
+    printf("%-28s %6s %9s %9s\n", "sensor reads during redraw", "reads", "ms", "ms");
+    bench_sensor("sensor priority", I2C_BUS_PRIORITY_SENSOR);
+    bench_sensor("display priority", I2C_BUS_PRIORITY_DISPLAY);
+
+    printf("\nCGRAM uploads: %u\n", lcd_glyph_get_uploads());
+    print_screen(&g_front);
+    print_screen(&g_lcd);
+    return g_failures > 0 ? 1 : 0;
+}
@@ -0,0 +1,220 @@
+/**
+ * @file pagebench.c
+ * @brief Display Page Benchmark
+ * @details Runs src/display_app.c, unchanged, with its task and the bus
+ *          arbiter on the scheduler of host_task.c and both panels on the
+ *          HD44780 model of host_lcd.c. For every page it reports the bus
+ *          traffic of switching to the page (one frame: the redraw and the
+ *          frame interval after it), of a new reading and of a minute without
+ *          input, prints what the two panels show and checks the text
+ *          against the expected screen. A timed rotation through all pages
+ *          follows, and a check that the daily page turns from the range
+ *          since boot to today's once the clock is set closes the run. The exit status is 1 if a screen differs or a
+ *          panel saw a timing rule broken.
+ *
+ * @author christophermena
+ * @date July 30, 2025
+ * @version 1.0
+ * @note Last Updated: October 16, 2026
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "display_app.h"
+#include "host_app.h"
+#include "host_i2c.h"
+#include "host_lcd.h"
+#include "host_task.h"
+
+// Station address 192.168.1.42, first octet in the low byte as in esp_ip4_addr_t
+#define STATION_IP              (192u | 168u << 8 | 1u << 16 | 42u << 24)
+
+// Text of both panels, frames included
+#define SCREEN_SIZE             ((DISPLAY_APP_FRONT_COLS + 3) * (DISPLAY_APP_FRONT_ROWS + 2) \
+                                 + (DISPLAY_APP_BACK_COLS + 3) * (DISPLAY_APP_BACK_ROWS + 2) + 1)
+
+/**
+ * @brief Page of the run and the screen the back panel must show on it
+ */
+typedef struct page_case
+{
+    display_app_page_e page;    ///< Page
+    const char *name;           ///< Scenario name
+    const char *back[2];        ///< Rows of the 16x2 back panel after the switch
+} page_case_t;
+
+// Expected back panel after the readings of main(): 20C to 24C (68F to 75F), 45% to 53%, at minute 6 and 7,
+// with the clock not set yet
+static const page_case_t g_pages[] =
+{
+    { DISPLAY_APP_PAGE_TREND,   "trend",    { "Trend 68-75F ^", "       11224466#" } },
+    { DISPLAY_APP_PAGE_DAILY,   "daily",    { "Boot  68-75oF", "Hum   45-53%" } },
+    { DISPLAY_APP_PAGE_WIFI,    "wifi",     { "WiFi 3", "192.168.1.42" } },
+    { DISPLAY_APP_PAGE_UPTIME,  "uptime",   { "Uptime", "0d 00:07" } },
+    { DISPLAY_APP_PAGE_ERRORS,  "errors",   { "Read errors: 0", "None" } },
+    { DISPLAY_APP_PAGE_CURRENT, "current",  { "Temp: 75oF >", "Humidity: 53%" } },
+};
+
+// Text forms of the lcd_glyph.c patterns for the printed screens
+static const struct
+{
+    uint8_t pattern[8];
+    char text;
+} g_glyph_texts[] =
+{
+    { { 0x06, 0x09, 0x09, 0x06, 0x00, 0x00, 0x00, 0x00 }, 'o' },    // Degree sign
+    { { 0x00, 0x00, 0x11, 0x0A, 0x04, 0x0A, 0x11, 0x00 }, 'x' },    // WiFi disconnected
+    { { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x10, 0x10 }, '1' },    // WiFi signal bars
+    { { 0x00, 0x00, 0x00, 0x00, 0x04, 0x04, 0x14, 0x14 }, '2' },
+    { { 0x00, 0x00, 0x01, 0x01, 0x05, 0x05, 0x15, 0x15 }, '3' },
+    { { 0x01, 0x01, 0x05, 0x05, 0x15, 0x15, 0x15, 0x15 }, '4' },
+    { { 0x04, 0x0E, 0x15, 0x04, 0x04, 0x04, 0x04, 0x00 }, '^' },    // Trend arrows
+    { { 0x00, 0x04, 0x02, 0x1F, 0x02, 0x04, 0x00, 0x00 }, '>' },
+    { { 0x04, 0x04, 0x04, 0x04, 0x15, 0x0E, 0x04, 0x00 }, 'v' },
+    { { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x1F }, '1' },    // Sparkline bars by height
+    { { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x1F, 0x1F }, '2' },
+    { { 0x00, 0x00, 0x00, 0x00, 0x00, 0x1F, 0x1F, 0x1F }, '3' },
+    { { 0x00, 0x00, 0x00, 0x00, 0x1F, 0x1F, 0x1F, 0x1F }, '4' },
+    { { 0x00, 0x00, 0x00, 0x1F, 0x1F, 0x1F, 0x1F, 0x1F }, '5' },
+    { { 0x00, 0x00, 0x1F, 0x1F, 0x1F, 0x1F, 0x1F, 0x1F }, '6' },
+    { { 0x00, 0x1F, 0x1F, 0x1F, 0x1F, 0x1F, 0x1F, 0x1F }, '7' },
+};
+
+// Checks failed
+static int g_failures;
+
+/**
+ * @brief Prints the traffic recorded since the last reset as one table row.
+ * @param name scenario name.
+ */
+static void report(const char *name)
+{
+    host_i2c_stats_t stats = host_i2c_get_stats();
+    printf("%-28s %6u %6u %6u %9.2f\n", name, stats.transactions, stats.reads, stats.bytes, stats.bus_us / 1000.0);
+}
+
+/**
+ * @brief Renders the screens of both panels, front above back.
+ * @param out receives the text, SCREEN_SIZE bytes.
+ */
+static void render_screens(char *out)
+{
+    host_lcd_render(DISPLAY_APP_FRONT_ADDRESS, DISPLAY_APP_FRONT_COLS, DISPLAY_APP_FRONT_ROWS, out, SCREEN_SIZE);
+    size_t len = strlen(out);
+    host_lcd_render(DISPLAY_APP_BACK_ADDRESS, DISPLAY_APP_BACK_COLS, DISPLAY_APP_BACK_ROWS, out + len, SCREEN_SIZE - len);
+}
+
+/**
+ * @brief Checks one row of the back panel against its expected text (padded with spaces).
+ * @param name scenario name.
+ * @param row row.
+ * @param text expected text.
+ */
+static void check_row(const char *name, uint8_t row, const char *text)
+{
+    char shown[DISPLAY_APP_BACK_COLS + 1];
+    char expected[DISPLAY_APP_BACK_COLS + 1];
+    char screen[(DISPLAY_APP_BACK_COLS + 3) * (DISPLAY_APP_BACK_ROWS + 2) + 1];
+
+    host_lcd_render(DISPLAY_APP_BACK_ADDRESS, DISPLAY_APP_BACK_COLS, DISPLAY_APP_BACK_ROWS, screen, sizeof(screen));
+    memcpy(shown, &screen[(DISPLAY_APP_BACK_COLS + 3) * (row + 1) + 1], DISPLAY_APP_BACK_COLS);
+    shown[DISPLAY_APP_BACK_COLS] = '\0';
+    snprintf(expected, sizeof(expected), "%-*s", DISPLAY_APP_BACK_COLS, text);
+    if (strcmp(shown, expected) != 0)
+    {
+        fprintf(stderr, "FAIL %s: back row %d shows \"%s\", expected \"%s\"\n", name, row, shown, expected);
+        g_failures++;
+    }
+}
+
+/**
+ * @brief Checks that no panel saw a timing rule broken.
+ * @param address 7-bit I2C address of the panel.
+ */
+static void check_timing(uint16_t address)
+{
+    host_lcd_stats_t stats = host_lcd_get_stats(address);
+    printf("0x%02X: %u instructions, %u data writes, %u reads, %u writes while busy, %u setup errors, %u sync errors\n",
+           address, stats.instructions, stats.data_writes, stats.reads, stats.busy_writes, stats.setup_errors, stats.sync_errors);
+    if (stats.busy_writes || stats.setup_errors || stats.sync_errors)
+    {
+        g_failures++;
+    }
+}
+
+int main(void)
+{
+    for (size_t i = 0; i < sizeof(g_glyph_texts) / sizeof(g_glyph_texts[0]); i++)
+    {
+        host_lcd_set_glyph_text(g_glyph_texts[i].pattern, g_glyph_texts[i].text);
+    }
+    host_app_set_station(STATION_IP, -60);
+    display_app_set_rotation(false);
+
+    printf("%-28s %6s %6s %6s %9s\n", "", "", "", "", "bus");
+    printf("%-28s %6s %6s %6s %9s\n", "update", "trans", "reads", "bytes", "ms");
+
+    host_i2c_reset();
+    display_app_start();
+    host_task_run(DISPLAY_APP_FRAME_INTERVAL_MS);
+    report("start, waiting page");
+
+    // A rising series fills the trend
+    for (int i = 0; i <= 8; i++)
+    {
+        display_app_show_sample(20 + i / 2, 45 + i);
+        host_task_run(30000);
+    }
+
+    char name[40];
+    static char screens[sizeof(g_pages) / sizeof(g_pages[0])][SCREEN_SIZE];
+    for (size_t i = 0; i < sizeof(g_pages) / sizeof(g_pages[0]); i++)
+    {
+        const page_case_t *c = &g_pages[i];
+
+        host_i2c_reset();
+        display_app_show_page(c->page);
+        host_task_run(DISPLAY_APP_FRAME_INTERVAL_MS);
+        snprintf(name, sizeof(name), "%s, switch", c->name);
+        report(name);
+        render_screens(screens[i]);
+        check_row(c->name, 0, c->back[0]);
+        check_row(c->name, 1, c->back[1]);
+
+        host_i2c_reset();
+        display_app_show_sample(24, 53);
+        host_task_run(DISPLAY_APP_FRAME_INTERVAL_MS);
+        snprintf(name, sizeof(name), "%s, new reading", c->name);
+        report(name);
+
+        host_i2c_reset();
+        host_task_run(60000);
+        snprintf(name, sizeof(name), "%s, 1 minute idle", c->name);
+        report(name);
+    }
+
+    host_i2c_reset();
+    display_app_set_rotation(true);
+    host_task_run(DISPLAY_APP_PAGE_COUNT * DISPLAY_APP_PAGE_INTERVAL_MS);
+    report("rotation, all pages");
+
+    // Once the clock is set the daily range starts over with the day's first reading
+    display_app_set_rotation(false);
+    host_app_set_clock_valid(true);
+    display_app_show_sample(24, 53);
+    display_app_show_page(DISPLAY_APP_PAGE_DAILY);
+    host_task_run(DISPLAY_APP_FRAME_INTERVAL_MS);
+    check_row("daily, clock set", 0, "Today 75-75oF");
+    check_row("daily, clock set", 1, "Hum   53-53%");
+
+    for (size_t i = 0; i < sizeof(g_pages) / sizeof(g_pages[0]); i++)
+    {
+        printf("\n%s page:\n%s", g_pages[i].name, screens[i]);
+    }
+
+    printf("\n");
+    check_timing(DISPLAY_APP_FRONT_ADDRESS);
+    check_timing(DISPLAY_APP_BACK_ADDRESS);
+    return g_failures > 0 ? 1 : 0;
+}
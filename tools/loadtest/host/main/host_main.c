@@ -0,0 +1,124 @@
+/**
+ * @file host_main.c
+ * @brief Host Build Entry Point for HTTP Load Testing
+ * @details This file starts the station's HTTP server on the Linux target.
+ *          The emulated flash is prepared the way the station boots: NVS, the
+ *          OTA session, the sample history and the settings are initialized,
+ *          and the web UI image packed by the build is installed into the
+ *          "webui" partition when it differs from the one already there.
+ *          Instead of the DHT11 task, a synthetic sample is published every
+ *          second, so caches, streams and history see a steady update rate
+ *          while tools/loadtest/loadgen.py drives requests at the server.
+ *
+ * @author christophermena
+ * @date July 30, 2025
+ * @version 1.0
+ * @note Last Updated: October 16, 2026
+ */
+
+#include <stdio.h>
+#include <time.h>
+#include "esp_log.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "lwip/sockets.h"
+#include "nvs_flash.h"
+
+#include "app_settings.h"
+#include "http_server.h"
+#include "ota_update.h"
+#include "sensor_data.h"
+#include "sensor_history.h"
+#include "webui_store.h"
+
+// Tag used for ESP serial console messages
+static const char TAG[] = "host_main";
+
+// Synthetic sample period (the station reads the DHT11 once a minute)
+#define HOST_SAMPLE_PERIOD_MS           1000
+
+// First descriptor available to the HTTP server, see lwip/sockets.h
+int host_socket_offset = 0;
+
+/**
+ * @brief Installs the web UI image built with the host build into the emulated "webui" partition.
+ */
+static void host_install_webui(void)
+{
+    static uint8_t buff[4096];
+    webui_store_header_t header;
+
+    FILE *f = fopen(HOST_WEBUI_IMAGE, "rb");
+    if (f == NULL || fread(&header, sizeof(header), 1, f) != 1)
+    {
+        ESP_LOGE(TAG, "host_install_webui: cannot read %s", HOST_WEBUI_IMAGE);
+        if (f != NULL)
+        {
+            fclose(f);
+        }
+        return;
+    }
+
+    if (webui_store_init() == ESP_OK && webui_store_get_crc() == header.crc)
+    {
+        fclose(f);
+        return;
+    }
+
+    esp_err_t err = webui_store_update_begin(&header);
+    if (err == ESP_OK)
+    {
+        size_t len;
+        rewind(f);
+        while (err == ESP_OK && (len = fread(buff, 1, sizeof(buff), f)) > 0)
+        {
+            err = webui_store_update_write(buff, len);
+        }
+        esp_err_t end_err = webui_store_update_end();
+        err = (err == ESP_OK) ? end_err : err;
+    }
+    fclose(f);
+    ESP_LOGI(TAG, "host_install_webui: %s: %s", HOST_WEBUI_IMAGE, esp_err_to_name(err));
+}
+
+/**
+ * @brief Finds the lowest free descriptor, which is where the server's sockets start.
+ * @return descriptor number.
+ */
+static int host_first_free_socket(void)
+{
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    close(fd);
+    return fd;
+}
+
+void app_main(void)
+{
+    esp_err_t ret = nvs_flash_init();
+    if (ret == ESP_ERR_NVS_NO_FREE_PAGES || ret == ESP_ERR_NVS_NEW_VERSION_FOUND)
+    {
+        ESP_ERROR_CHECK(nvs_flash_erase());
+        ret = nvs_flash_init();
+    }
+    ESP_ERROR_CHECK(ret);
+
+    ota_update_init();
+    sensor_history_init();
+    app_settings_init();
+    host_install_webui();
+
+    host_socket_offset = host_first_free_socket();
+    http_server_start();
+    ESP_LOGI(TAG, "app_main: HTTP server running, sockets from %d", host_socket_offset);
+
+    // Slowly varying synthetic readings
+    for (int n = 0;; n++)
+    {
+        int temperature = 20 + (n / 30) % 8;
+        int humidity = 40 + (n / 20) % 15;
+
+        sensor_data_publish(temperature, humidity);
+        sensor_history_append((uint32_t)time(NULL), temperature, humidity);
+        vTaskDelay(pdMS_TO_TICKS(HOST_SAMPLE_PERIOD_MS));
+    }
+}
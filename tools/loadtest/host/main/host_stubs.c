@@ -0,0 +1,107 @@
+/**
+ * @file host_stubs.c
+ * @brief Driver Stubs for the Host Build
+ * @details This file replaces the parts of the firmware the HTTP layer links
+ *          against but that need the station hardware: the OTA partition
+ *          switch (app_update), the pull-mode downloader, the DHT11 unit
+ *          conversion and the I2C bus counters (no device is attached).
+ *          Firmware images are written to the emulated ota_1 partition, so
+ *          uploads exercise the same flash path as the station.
+ *
+ * @author christophermena
+ * @date July 30, 2025
+ * @version 1.0
+ * @note Last Updated: October 16, 2026
+ */
+
+#include "esp_log.h"
+#include "esp_ota_ops.h"
+#include "esp_partition.h"
+
+#include "DHT11.h"
+#include "i2c_bus_stats.h"
+#include "ota_fetch.h"
+
+// Tag used for ESP serial console messages
+static const char TAG[] = "host_stubs";
+
+// Partition booted next, ota_0 until an update is installed
+static const esp_partition_t *g_boot_partition = NULL;
+
+// Write position of the esp_ota_begin() session
+static uint32_t g_ota_write_offset = 0;
+
+const esp_partition_t *esp_ota_get_next_update_partition(const esp_partition_t *start_from)
+{
+    return esp_partition_find_first(ESP_PARTITION_TYPE_APP, ESP_PARTITION_SUBTYPE_APP_OTA_1, NULL);
+}
+
+const esp_partition_t *esp_ota_get_boot_partition(void)
+{
+    if (g_boot_partition == NULL)
+    {
+        g_boot_partition = esp_partition_find_first(ESP_PARTITION_TYPE_APP, ESP_PARTITION_SUBTYPE_APP_OTA_0, NULL);
+    }
+    return g_boot_partition;
+}
+
+esp_err_t esp_ota_set_boot_partition(const esp_partition_t *partition)
+{
+    ESP_LOGI(TAG, "esp_ota_set_boot_partition: %s", partition->label);
+    g_boot_partition = partition;
+    return ESP_OK;
+}
+
+esp_err_t esp_ota_begin(const esp_partition_t *partition, size_t image_size, esp_ota_handle_t *out_handle)
+{
+    g_ota_write_offset = 0;
+    *out_handle = 1;
+    return esp_partition_erase_range(partition, 0, partition->size);
+}
+
+esp_err_t esp_ota_write(esp_ota_handle_t handle, const void *data, size_t size)
+{
+    const esp_partition_t *partition = esp_ota_get_next_update_partition(NULL);
+    if (g_ota_write_offset + size > partition->size)
+    {
+        return ESP_ERR_INVALID_SIZE;
+    }
+
+    esp_err_t err = esp_partition_write(partition, g_ota_write_offset, data, size);
+    if (err == ESP_OK)
+    {
+        g_ota_write_offset += size;
+    }
+    return err;
+}
+
+esp_err_t esp_ota_end(esp_ota_handle_t handle)
+{
+    return g_ota_write_offset > 0 ? ESP_OK : ESP_ERR_OTA_VALIDATE_FAILED;
+}
+
+esp_err_t ota_fetch_start(const char *url, uint32_t image_crc)
+{
+    ESP_LOGW(TAG, "ota_fetch_start: pull-mode OTA is not available in the host build");
+    return ESP_ERR_NOT_SUPPORTED;
+}
+
+bool ota_fetch_is_running(void)
+{
+    return false;
+}
+
+float dht11_celsius_to_fahrenheit(int celsius)
+{
+    return celsius * 9.0f / 5.0f + 32.0f;
+}
+
+bool i2c_bus_get_stats(int index, i2c_bus_stats_t *stats)
+{
+    return false;
+}
+
+uint64_t i2c_bus_get_busy_us(void)
+{
+    return 0;
+}
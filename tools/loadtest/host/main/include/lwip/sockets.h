@@ -0,0 +1,36 @@
+/**
+ * @file sockets.h
+ * @brief lwIP Socket Header Shim for the Host Build
+ * @details The host build runs the HTTP layer on POSIX sockets. This header
+ *          maps the lwIP names used by the HTTP modules onto them, with the
+ *          same socket budget as the station, so httpd is configured with the
+ *          same number of open sockets. Host descriptors do not start at a fixed
+ *          number: host_main.c sets the offset to the first free descriptor
+ *          before the server starts, so the per-socket tables stay indexable.
+ *
+ * @author christophermena
+ * @date July 30, 2025
+ * @version 1.0
+ * @note Last Updated: October 16, 2026
+ */
+
+#ifndef HOST_LWIP_SOCKETS_H_
+#define HOST_LWIP_SOCKETS_H_
+
+#include <errno.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+// Socket budget of the station (sdkconfig.esp32dev)
+#ifndef CONFIG_LWIP_MAX_SOCKETS
+#define CONFIG_LWIP_MAX_SOCKETS         16
+#endif
+
+// First descriptor the server can get, set by host_main.c
+extern int host_socket_offset;
+#define LWIP_SOCKET_OFFSET              host_socket_offset
+
+#endif /* HOST_LWIP_SOCKETS_H_ */
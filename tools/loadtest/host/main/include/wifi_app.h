@@ -0,0 +1,18 @@
+/**
+ * @file wifi_app.h
+ * @brief WiFi Application Header Shim for the Host Build
+ * @details Shadows src/wifi_app.h, whose esp_netif and WiFi driver types do
+ *          not exist on the Linux target. The HTTP layer uses none of them.
+ *
+ * @author christophermena
+ * @date July 30, 2025
+ * @version 1.0
+ * @note Last Updated: October 16, 2026
+ */
+
+#ifndef MAIN_WIFI_APP_H_
+#define MAIN_WIFI_APP_H_
+
+#include "freertos/FreeRTOS.h"
+
+#endif /* MAIN_WIFI_APP_H_ */
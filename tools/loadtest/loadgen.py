@@ -0,0 +1,279 @@
+#!/usr/bin/env python3
+"""
+HTTP load generator for the weather station.
+
+Runs a mix of scenarios against a station (or the host build in
+tools/loadtest/host) for a fixed time, each on its own keep-alive connections,
+and reports requests/s, latency percentiles and memory high-water marks:
+
+  static  GET / (gzip'd page from the webui partition), alternating a full
+          download with an If-None-Match revalidation (304)
+  json    the small JSON endpoints: /api/current, /api/sensors/0,
+          /api/settings, POST /OTAstatus, a 24 h /api/history
+  ota     one resumable firmware upload (/OTAchunk) of a random image running
+          alongside the others. The last chunk is never sent, so the station
+          does not reboot; each pass starts over with a new image
+
+    python3 tools/loadtest/loadgen.py 192.168.0.1 --duration 30
+    python3 tools/loadtest/loadgen.py 127.0.0.1:8080 --pid $(pgrep weather_host)
+
+Memory is read from /metrics while the test runs (free heap, lowest free heap
+since boot); with --pid the resident set high-water mark (VmHWM) of a host
+build process is reported as well.
+"""
+
+import argparse
+import http.client
+import os
+import random
+import re
+import threading
+import time
+import zlib
+
+CHUNK_SIZE = 4096
+IMAGE_SIZE = 256 * 1024
+
+JSON_REQUESTS = [
+    ("GET", "/api/current"),
+    ("GET", "/api/sensors/0"),
+    ("GET", "/api/settings"),
+    ("POST", "/OTAstatus"),
+    ("GET", "/api/history?res=3600"),
+]
+
+
+class Stats:
+    """Latencies and status codes of one scenario, shared by its workers."""
+
+    def __init__(self, name):
+        self.name = name
+        self.lock = threading.Lock()
+        self.latencies = []
+        self.statuses = {}
+        self.failures = 0
+        self.bytes = 0
+
+    def record(self, latency, status, size):
+        with self.lock:
+            self.latencies.append(latency)
+            self.statuses[status] = self.statuses.get(status, 0) + 1
+            self.bytes += size
+
+    def fail(self):
+        with self.lock:
+            self.failures += 1
+
+
+class Connection:
+    """Keep-alive connection that reconnects after the station closes it."""
+
+    def __init__(self, host, port, timeout):
+        self.host = host
+        self.port = port
+        self.timeout = timeout
+        self.conn = None
+
+    def request(self, method, path, body=None, headers=None):
+        if self.conn is None:
+            self.conn = http.client.HTTPConnection(self.host, self.port, timeout=self.timeout)
+        try:
+            start = time.perf_counter()
+            self.conn.request(method, path, body=body, headers=headers or {})
+            response = self.conn.getresponse()
+            data = response.read()
+            latency = time.perf_counter() - start
+        except (OSError, http.client.HTTPException):
+            self.close()
+            raise
+        if response.getheader("Connection", "").lower() == "close":
+            self.close()
+        return response, data, latency
+
+    def close(self):
+        if self.conn is not None:
+            self.conn.close()
+            self.conn = None
+
+
+def static_worker(conn, stats, stop):
+    etag = None
+    while not stop.is_set():
+        headers = {"Accept-Encoding": "gzip"}
+        if etag is not None:
+            headers["If-None-Match"] = etag
+        try:
+            response, data, latency = conn.request("GET", "/", headers=headers)
+        except (OSError, http.client.HTTPException):
+            stats.fail()
+            continue
+        stats.record(latency, response.status, len(data))
+        # Every other request revalidates
+        etag = response.getheader("ETag") if etag is None else None
+
+
+def json_worker(conn, stats, stop):
+    n = random.randrange(len(JSON_REQUESTS))
+    while not stop.is_set():
+        method, path = JSON_REQUESTS[n % len(JSON_REQUESTS)]
+        n += 1
+        try:
+            response, data, latency = conn.request(method, path, body=b"" if method == "POST" else None)
+        except (OSError, http.client.HTTPException):
+            stats.fail()
+            continue
+        stats.record(latency, response.status, len(data))
+
+
+def ota_worker(conn, stats, stop):
+    while not stop.is_set():
+        image = os.urandom(IMAGE_SIZE)
+        image_crc = zlib.crc32(image)
+        offset = 0
+        # Hold back the last chunk: a complete image makes the station reboot
+        while not stop.is_set() and offset + CHUNK_SIZE < len(image):
+            chunk = image[offset:offset + CHUNK_SIZE]
+            headers = {
+                "Content-Type": "application/octet-stream",
+                "X-OTA-Image-Size": str(len(image)),
+                "X-OTA-Image-CRC": "0x%08x" % image_crc,
+                "X-OTA-Offset": str(offset),
+                "X-OTA-Chunk-CRC": "0x%08x" % zlib.crc32(chunk),
+            }
+            try:
+                response, data, latency = conn.request("POST", "/OTAchunk", body=chunk, headers=headers)
+            except (OSError, http.client.HTTPException):
+                stats.fail()
+                continue
+            stats.record(latency, response.status, len(chunk))
+            match = re.search(rb'"offset":(\d+)', data)
+            if match is None:
+                break
+            offset = int(match.group(1))
+
+
+SCENARIOS = {
+    "static": static_worker,
+    "json": json_worker,
+    "ota": ota_worker,
+}
+
+
+class MemoryMonitor(threading.Thread):
+    """Polls /metrics (and the host process) for the memory high-water marks."""
+
+    def __init__(self, host, port, pid, interval, stop):
+        super().__init__(daemon=True)
+        self.conn = Connection(host, port, 10)
+        self.pid = pid
+        self.interval = interval
+        self.stop = stop
+        self.heap_free_min = None
+        self.heap_min_free = None
+        self.vm_hwm_kb = None
+
+    def poll(self):
+        try:
+            response, data, _ = self.conn.request("GET", "/metrics")
+            text = data.decode(errors="replace")
+            for name in ("heap_free_bytes", "heap_min_free_bytes"):
+                match = re.search(r"^%s (\d+)" % name, text, re.M)
+                if match is None:
+                    continue
+                value = int(match.group(1))
+                if name == "heap_free_bytes":
+                    self.heap_free_min = value if self.heap_free_min is None else min(self.heap_free_min, value)
+                else:
+                    self.heap_min_free = value
+        except (OSError, http.client.HTTPException):
+            pass
+        if self.pid is not None:
+            try:
+                with open("/proc/%d/status" % self.pid) as f:
+                    match = re.search(r"^VmHWM:\s+(\d+) kB", f.read(), re.M)
+                if match:
+                    self.vm_hwm_kb = int(match.group(1))
+            except OSError:
+                pass
+
+    def run(self):
+        while not self.stop.wait(self.interval):
+            self.poll()
+
+
+def percentile(values, p):
+    if not values:
+        return 0.0
+    return values[min(len(values) - 1, int(len(values) * p / 100))]
+
+
+def report(stats, duration, memory):
+    print("%-8s %8s %8s %8s %8s %8s %8s  %s" % ("scenario", "requests", "req/s", "p50 ms", "p90 ms", "p99 ms", "max ms", "status"))
+    for s in stats:
+        latencies = sorted(s.latencies)
+        statuses = " ".join("%s:%d" % item for item in sorted(s.statuses.items()))
+        if s.failures:
+            statuses += " failed:%d" % s.failures
+        print("%-8s %8d %8.1f %8.1f %8.1f %8.1f %8.1f  %s" % (
+            s.name, len(latencies), len(latencies) / duration,
+            percentile(latencies, 50) * 1000, percentile(latencies, 90) * 1000,
+            percentile(latencies, 99) * 1000, (latencies[-1] if latencies else 0) * 1000, statuses))
+        if s.name == "ota":
+            print("%-8s %.1f KB/s committed" % ("", s.bytes / duration / 1024))
+
+    print()
+    if memory.heap_free_min is not None:
+        print("heap free, lowest during the run:  %d bytes" % memory.heap_free_min)
+    if memory.heap_min_free is not None:
+        print("heap free, lowest since boot:      %d bytes" % memory.heap_min_free)
+    if memory.vm_hwm_kb is not None:
+        print("host process resident high-water:  %d kB" % memory.vm_hwm_kb)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("station", help="station address, host[:port]")
+    parser.add_argument("--duration", type=float, default=20, help="seconds to run")
+    parser.add_argument("--scenarios", default="static,json,ota", help="comma separated: %s" % ",".join(SCENARIOS))
+    parser.add_argument("--clients", type=int, default=4,
+                        help="connections per static/json scenario (the station has 13 sockets in total)")
+    parser.add_argument("--timeout", type=float, default=10, help="request timeout in seconds")
+    parser.add_argument("--pid", type=int, default=None, help="host build process to read VmHWM from")
+    args = parser.parse_args()
+
+    host, _, port = args.station.partition(":")
+    port = int(port or 80)
+    names = [name for name in args.scenarios.split(",") if name]
+    for name in names:
+        if name not in SCENARIOS:
+            parser.error("unknown scenario %s" % name)
+
+    stop = threading.Event()
+    memory = MemoryMonitor(host, port, args.pid, 1.0, stop)
+    memory.poll()
+    memory.start()
+
+    stats = []
+    workers = []
+    for name in names:
+        s = Stats(name)
+        stats.append(s)
+        for _ in range(1 if name == "ota" else args.clients):
+            conn = Connection(host, port, args.timeout)
+            workers.append(threading.Thread(target=SCENARIOS[name], args=(conn, s, stop), daemon=True))
+
+    start = time.perf_counter()
+    for worker in workers:
+        worker.start()
+    time.sleep(args.duration)
+    stop.set()
+    for worker in workers:
+        worker.join(args.timeout)
+    duration = time.perf_counter() - start
+
+    memory.poll()
+    report(stats, duration, memory)
+
+
+if __name__ == "__main__":
+    main()
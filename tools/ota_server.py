@@ -0,0 +1,91 @@
+#!/usr/bin/env python3
+"""
+Firmware file server for pull-mode OTA (/OTAfetch).
+
+Serves one firmware image over HTTP with Range support, so stations can resume
+interrupted downloads, and optionally tells a list of stations to fetch it.
+
+    python3 tools/ota_server.py .pio/build/esp32dev/firmware.bin --port 8070 \
+        --stations 192.168.0.1 192.168.1.42
+"""
+
+import argparse
+import http.server
+import os
+import re
+import socket
+import threading
+import urllib.parse
+import urllib.request
+import zlib
+
+
+def make_handler(image, crc):
+    class FirmwareHandler(http.server.BaseHTTPRequestHandler):
+        protocol_version = "HTTP/1.1"
+
+        def do_GET(self):
+            start = 0
+            status = 200
+            match = re.match(r"bytes=(\d+)-$", self.headers.get("Range", ""))
+            if match:
+                start = int(match.group(1))
+                if start >= len(image):
+                    self.send_error(416)
+                    return
+                status = 206
+
+            body = image[start:]
+            self.send_response(status)
+            self.send_header("Content-Type", "application/octet-stream")
+            self.send_header("Content-Length", str(len(body)))
+            self.send_header("Accept-Ranges", "bytes")
+            self.send_header("X-Image-CRC", "0x%08x" % crc)
+            if status == 206:
+                self.send_header("Content-Range", "bytes %d-%d/%d" % (start, len(image) - 1, len(image)))
+            self.end_headers()
+            self.wfile.write(body)
+
+    return FirmwareHandler
+
+
+def local_ip():
+    with socket.socket(socket.AF_INET, socket.SOCK_DGRAM) as s:
+        s.connect(("192.168.0.1", 80))
+        return s.getsockname()[0]
+
+
+def trigger(station, url, crc):
+    body = urllib.parse.urlencode({"url": url, "crc": "0x%08x" % crc}).encode()
+    request = urllib.request.Request("http://%s/OTAfetch" % station, data=body, method="POST")
+    try:
+        with urllib.request.urlopen(request, timeout=10) as response:
+            print("%s: %d %s" % (station, response.status, response.read().decode()))
+    except Exception as err:
+        print("%s: %s" % (station, err))
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("image", help="firmware .bin file to serve")
+    parser.add_argument("--port", type=int, default=8070)
+    parser.add_argument("--host", default=None, help="address the stations use to reach this machine")
+    parser.add_argument("--stations", nargs="*", default=[], help="station addresses to send /OTAfetch to")
+    args = parser.parse_args()
+
+    with open(args.image, "rb") as f:
+        image = f.read()
+    crc = zlib.crc32(image)
+
+    server = http.server.ThreadingHTTPServer(("", args.port), make_handler(image, crc))
+    url = "http://%s:%d/%s" % (args.host or local_ip(), args.port, os.path.basename(args.image))
+    print("Serving %s (%d bytes, crc 0x%08x) at %s" % (args.image, len(image), crc, url))
+
+    for station in args.stations:
+        threading.Thread(target=trigger, args=(station, url, crc)).start()
+
+    server.serve_forever()
+
+
+if __name__ == "__main__":
+    main()
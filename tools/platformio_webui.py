@@ -0,0 +1,28 @@
+"""
+PlatformIO pre-build script: packs src/webpage into the image of the "webui"
+partition (see tools/webui_pack.py) and flashes it together with the firmware.
+"""
+
+import csv
+import os
+import subprocess
+
+Import("env")  # noqa: F821 (provided by SCons)
+
+project_dir = env.subst("$PROJECT_DIR")  # noqa: F821
+image = os.path.join(env.subst("$BUILD_DIR"), "webui.bin")  # noqa: F821
+
+os.makedirs(os.path.dirname(image), exist_ok=True)
+subprocess.check_call([
+    env.subst("$PYTHONEXE"),  # noqa: F821
+    os.path.join(project_dir, "tools", "webui_pack.py"),
+    os.path.join(project_dir, "src", "webpage"),
+    image,
+])
+
+# Flash offset of the webui partition
+with open(os.path.join(project_dir, "partitions.csv")) as f:
+    rows = [[field.strip() for field in row] for row in csv.reader(f) if row and not row[0].startswith("#")]
+offset = next(row[3] for row in rows if row[0] == "webui")
+
+env.Append(FLASH_EXTRA_IMAGES=[(offset, image)])  # noqa: F821
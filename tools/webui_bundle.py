@@ -0,0 +1,172 @@
+#!/usr/bin/env python3
+"""
+Web UI bundler.
+
+Turns src/webpage into a single gzip compressed page, so a cold page load is
+one request instead of one per asset:
+
+  - <link rel="stylesheet"> and <script src> references are inlined, with the
+    CSS and JS minified
+  - jquery-3.3.1.min.js is replaced by the few helpers app.js actually uses
+    (see JQUERY_FEATURES); an unknown jQuery call fails the build
+  - favicon.ico is reduced to its 16 and 32 px images and inlined as a data URI
+
+    python3 tools/webui_bundle.py src/webpage index.html.gz
+
+tools/webui_pack.py packs the bundle into the image of the "webui" partition.
+"""
+
+import argparse
+import base64
+import gzip
+import io
+import os
+import re
+import struct
+import sys
+
+JQUERY = "jquery-3.3.1.min.js"
+
+# Replacement for each jQuery feature: (pattern in app.js, helper source)
+JQUERY_FEATURES = [
+    (r"\$\(\s*document\s*\)\s*\.\s*ready\s*\(",
+     "$.ready=function(f){document.readyState!='loading'?f():document.addEventListener('DOMContentLoaded',f)};"),
+    (r"\$\.getJSON\s*\(",
+     "$.getJSON=function(u,f){fetch(u).then(function(r){return r.json()}).then(f)};"),
+    (r"\$\.post\s*\(",
+     "$.post=function(u,d,f){fetch(u,{method:'POST',body:d,headers:{'Content-Type':'application/x-www-form-urlencoded'}})"
+     ".then(function(r){return r.text()}).then(f||function(){})};"),
+]
+JQUERY_CORE = "function $(x){return{ready:$.ready}}"
+
+
+def minify_css(css):
+    css = re.sub(r"/\*.*?\*/", "", css, flags=re.S)
+    css = re.sub(r"\s+", " ", css)
+    css = re.sub(r"\s*([{}:;,>])\s*", r"\1", css)
+    return css.replace(";}", "}").strip()
+
+
+def minify_js(js):
+    """Strips comments and indentation. Line breaks are kept, so automatic
+    semicolon insertion still sees the same program."""
+    out = []
+    i = 0
+    last = ""
+    while i < len(js):
+        c = js[i]
+        if c in "'\"`":
+            end = i + 1
+            while end < len(js) and js[end] != c:
+                end += 2 if js[end] == "\\" else 1
+            out.append(js[i:end + 1])
+            i = end + 1
+            last = c
+        elif js.startswith("//", i):
+            i = js.find("\n", i)
+            i = len(js) if i < 0 else i
+        elif js.startswith("/*", i):
+            i = js.index("*/", i) + 2
+            out.append(" ")
+        elif c == "/" and last in "(,=:[!&|?{};+-*%<>~^" :
+            # Regular expression literal
+            end = i + 1
+            while js[end] != "/":
+                end += 2 if js[end] == "\\" else 1
+            out.append(js[i:end + 1])
+            i = end + 1
+            last = "/"
+        else:
+            out.append(c)
+            if not c.isspace():
+                last = c
+            i += 1
+    lines = (re.sub(r"[ \t]+", " ", line).strip() for line in "".join(out).splitlines())
+    return "\n".join(line for line in lines if line)
+
+
+def shake_jquery(app_js):
+    """Returns the helpers used by app.js, fails on jQuery calls it cannot provide."""
+    helpers = [JQUERY_CORE]
+    remaining = app_js
+    for pattern, helper in JQUERY_FEATURES:
+        if re.search(pattern, app_js):
+            helpers.append(helper)
+            remaining = re.sub(pattern, "", remaining)
+    unknown = re.findall(r"(?:\$|jQuery)\s*[.(][^;\n]{0,30}", remaining)
+    if unknown:
+        sys.exit("webui_bundle: jQuery feature not provided by the bundle: %s" % unknown[0])
+    return "".join(helpers)
+
+
+def small_favicon(path, max_size=32):
+    """Returns an .ico with only the images up to max_size pixels."""
+    with open(path, "rb") as f:
+        ico = f.read()
+    _, kind, count = struct.unpack_from("<HHH", ico)
+    entries = []
+    for n in range(count):
+        entry = struct.unpack_from("<BBBBHHII", ico, 6 + 16 * n)
+        width = entry[0] or 256
+        if width <= max_size:
+            entries.append(entry)
+    offset = 6 + 16 * len(entries)
+    header = struct.pack("<HHH", 0, kind, len(entries))
+    images = b""
+    for width, height, colors, reserved, planes, bits, size, image_offset in entries:
+        header += struct.pack("<BBBBHHII", width, height, colors, reserved, planes, bits, size, offset + len(images))
+        images += ico[image_offset:image_offset + size]
+    return header + images
+
+
+def bundle(webpage):
+    def read(name):
+        with open(os.path.join(webpage, name), encoding="utf-8") as f:
+            return f.read()
+
+    html = read("index.html")
+    app_js = read("app.js")
+
+    def inline_css(match):
+        return "<style>%s</style>" % minify_css(read(match.group(1)))
+
+    def inline_js(match):
+        name = match.group(1)
+        source = shake_jquery(app_js) if name == JQUERY else minify_js(read(name))
+        return "<script>%s</script>" % source
+
+    html = re.sub(r"<link rel=\"stylesheet\" href=\"([^\"]+)\">", inline_css, html)
+    html = re.sub(r"<script[^>]*src=['\"]([^'\"]+)['\"][^>]*></script>", inline_js, html)
+
+    icon = base64.b64encode(small_favicon(os.path.join(webpage, "favicon.ico"))).decode()
+    html = html.replace("<title>", "<link rel=\"icon\" href=\"data:image/x-icon;base64,%s\"><title>" % icon, 1)
+
+    # Whitespace between tags renders as at most one space
+    html = re.sub(r">\s+<", "> <", html)
+    return html.strip().encode("utf-8")
+
+
+def compress(page):
+    # mtime=0 keeps the output reproducible, so unchanged assets give an identical image
+    buff = io.BytesIO()
+    with gzip.GzipFile(fileobj=buff, mode="wb", compresslevel=9, mtime=0) as f:
+        f.write(page)
+    return buff.getvalue()
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("webpage", help="directory holding index.html and its assets")
+    parser.add_argument("output", help="gzip compressed page to write")
+    args = parser.parse_args()
+
+    page = bundle(args.webpage)
+    data = compress(page)
+
+    with open(args.output, "wb") as f:
+        f.write(data)
+    print("webui_bundle: %s, %d bytes (%d uncompressed)" % (args.output, len(data), len(page)))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,82 @@
+#!/usr/bin/env python3
+"""
+Web UI image packer.
+
+Bundles src/webpage (see tools/webui_bundle.py) and packs the result into the
+image of the "webui" partition (see src/webui_store.h), optionally uploading
+it to stations, so the UI can be updated without a firmware OTA:
+
+    python3 tools/webui_pack.py src/webpage webui.bin --upload 192.168.0.1
+
+Image layout (little endian): header {u32 magic "WUI1", u32 count, u32 size,
+u32 crc32 of everything after the header}, count index entries {char path[32],
+char content_type[20], u8 flags, u8 reserved[3], u32 offset, u32 size}, bodies.
+"""
+
+import argparse
+import os
+import struct
+import sys
+import urllib.request
+import zlib
+
+sys.path.insert(0, os.path.dirname(os.path.abspath(__file__)))
+import webui_bundle  # noqa: E402
+
+MAGIC = 0x31495557
+HEADER = struct.Struct("<IIII")
+ENTRY = struct.Struct("<32s20sB3xII")
+FLAG_GZIP = 0x01
+PARTITION_SIZE = 0x30000
+
+
+def assets(webpage):
+    """(path, content type, flags, body) of every asset in the image."""
+    return [
+        ("/index.html", "text/html", FLAG_GZIP, webui_bundle.compress(webui_bundle.bundle(webpage))),
+        ("/favicon.ico", "image/x-icon", 0, webui_bundle.small_favicon(os.path.join(webpage, "favicon.ico"))),
+    ]
+
+
+def pack(entries):
+    offset = HEADER.size + ENTRY.size * len(entries)
+    index = b""
+    bodies = b""
+    for path, content_type, flags, body in entries:
+        index += ENTRY.pack(path.encode(), content_type.encode(), flags, offset + len(bodies), len(body))
+        bodies += body
+    payload = index + bodies
+    return HEADER.pack(MAGIC, len(entries), HEADER.size + len(payload), zlib.crc32(payload)) + payload
+
+
+def upload(station, image):
+    request = urllib.request.Request("http://%s/webui" % station, data=image, method="POST",
+                                     headers={"Content-Type": "application/octet-stream"})
+    try:
+        with urllib.request.urlopen(request, timeout=30) as response:
+            print("%s: %d %s" % (station, response.status, response.read().decode()))
+    except Exception as err:
+        print("%s: %s" % (station, err))
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("webpage", help="directory holding index.html and its assets")
+    parser.add_argument("output", help="partition image to write")
+    parser.add_argument("--upload", nargs="*", default=[], help="station addresses to POST the image to")
+    args = parser.parse_args()
+
+    image = pack(assets(args.webpage))
+    if len(image) > PARTITION_SIZE:
+        sys.exit("webui_pack: image is %d bytes, the webui partition holds %d" % (len(image), PARTITION_SIZE))
+
+    with open(args.output, "wb") as f:
+        f.write(image)
+    print("webui_pack: %s, %d bytes" % (args.output, len(image)))
+
+    for station in args.upload:
+        upload(station, image)
+
+
+if __name__ == "__main__":
+    main()